@@ -0,0 +1,68 @@
+#include "compressionbench.h"
+#include "../rdcore/support/compression.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <string_view>
+
+#define BENCH_SIZE (8 << 20)
+
+namespace {
+
+RawData generate(size_t size) // Mostly repetitive, like code and tables in a binary
+{
+    static const std::string_view WORDS[] = { "mov", "push", "pop", "call", "ret", "jmp", "xor", "lea", std::string_view("\0\0\0\0", 4), "\x90\x90" };
+
+    std::mt19937 rng(0x5245);
+    RawData data;
+    data.reserve(size);
+
+    while(data.size() < size)
+    {
+        if(rng() % 4) {
+            std::string_view w = WORDS[rng() % (sizeof(WORDS) / sizeof(*WORDS))];
+            for(size_t i = 0; (i < w.size()) && (data.size() < size); i++) data.push_back(static_cast<u8>(w[i]));
+        }
+        else
+            data.push_back(static_cast<u8>(rng()));
+    }
+
+    return data;
+}
+
+template<typename Function>
+double measure(size_t size, const Function& cb)
+{
+    auto start = std::chrono::steady_clock::now();
+    bool ok = cb();
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return ok ? (static_cast<double>(size) / (1 << 20)) / secs : 0;
+}
+
+} // namespace
+
+void CompressionBench::run()
+{
+    RawData data = generate(BENCH_SIZE), single, framed, out;
+
+    double sc = measure(data.size(), [&]() { return Compression::compress(data, single); });
+    double sd = measure(data.size(), [&]() { return Compression::decompress(single, out); });
+    if(out != data) sd = 0; // Checked outside the timed region
+
+    double fc = measure(data.size(), [&]() { return Compression::compressFrames(data, framed); });
+    double fd = measure(data.size(), [&]() { return Compression::decompress(framed, out); });
+    if(out != data) fd = 0;
+
+    std::cout << std::setw(10) << "Mode"
+              << std::setw(16) << "Compress MB/s" << std::setw(18) << "Decompress MB/s"
+              << std::setw(10) << "Ratio" << std::endl;
+
+    std::cout << std::fixed << std::setprecision(1)
+              << std::setw(10) << "single" << std::setw(16) << sc << std::setw(18) << sd
+              << std::setw(10) << std::setprecision(3) << static_cast<double>(single.size()) / data.size() << std::endl;
+
+    std::cout << std::fixed << std::setprecision(1)
+              << std::setw(10) << "frames" << std::setw(16) << fc << std::setw(18) << fd
+              << std::setw(10) << std::setprecision(3) << static_cast<double>(framed.size()) / data.size() << std::endl;
+}
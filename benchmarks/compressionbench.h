@@ -0,0 +1,8 @@
+#pragma once
+
+class CompressionBench
+{
+    public:
+        CompressionBench() = delete;
+        static void run();
+};
@@ -0,0 +1,18 @@
+#include <iostream>
+#include <cstdlib>
+#include <string>
+#include "compressionbench.h"
+#include "safeptrbench.h"
+
+int main(int argc, char** argv)
+{
+    size_t maxreaders = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 8;
+    if(!maxreaders) maxreaders = 1;
+
+    std::cout << "safe_ptr contention (1 writer, N readers)" << std::endl;
+    SafePtrBench::run(maxreaders);
+
+    std::cout << std::endl << "Compression throughput (single stream vs frames)" << std::endl;
+    CompressionBench::run();
+    return 0;
+}
@@ -0,0 +1,94 @@
+#include "safeptrbench.h"
+#include "../rdcore/support/safe_ptr.h"
+#include <iostream>
+#include <iomanip>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <map>
+
+#define BENCH_DURATION std::chrono::milliseconds(500)
+#define BENCH_ITEMS    0x10000
+
+namespace {
+
+struct BenchDocument // Stands in for Document: ordered lookups for readers, inserts for the writer
+{
+    std::map<size_t, size_t> items;
+
+    size_t get(size_t key) const {
+        auto it = items.lower_bound(key);
+        return (it != items.end()) ? it->second : 0;
+    }
+
+    void set(size_t key, size_t value) { items[key] = value; }
+};
+
+struct BenchResult { double reads, writes; };
+
+template<typename SafePtr>
+BenchResult measure(size_t nreaders)
+{
+    SafePtr doc(new BenchDocument());
+    for(size_t i = 0; i < BENCH_ITEMS; i++) doc->set(i, i);
+
+    std::atomic_bool stop{false};
+    std::atomic<size_t> reads{0}, writes{0};
+    std::vector<std::thread> threads;
+
+    threads.emplace_back([&]() {
+        size_t i = 0;
+
+        while(!stop) {
+            doc->set(i % BENCH_ITEMS, i);
+            i++;
+        }
+
+        writes = i;
+    });
+
+    for(size_t r = 0; r < nreaders; r++)
+    {
+        threads.emplace_back([&, r]() {
+            const SafePtr& cdoc = doc;
+            size_t n = 0, acc = 0;
+
+            while(!stop) {
+                acc += cdoc->get((n * 7919 + r) % BENCH_ITEMS);
+                n++;
+            }
+
+            reads += n + (acc & 0); // Keep the loop alive
+        });
+    }
+
+    std::this_thread::sleep_for(BENCH_DURATION);
+    stop = true;
+
+    for(auto& t : threads) t.join();
+
+    double secs = std::chrono::duration<double>(BENCH_DURATION).count();
+    return { static_cast<double>(reads) / secs, static_cast<double>(writes) / secs };
+}
+
+} // namespace
+
+void SafePtrBench::run(size_t maxreaders)
+{
+    std::cout << std::setw(8) << "Readers"
+              << std::setw(16) << "Reads/s (rec)" << std::setw(16) << "Writes/s (rec)"
+              << std::setw(16) << "Reads/s (shr)" << std::setw(16) << "Writes/s (shr)"
+              << std::setw(8) << "Ratio" << std::endl;
+
+    for(size_t n = 1; n <= maxreaders; n *= 2)
+    {
+        BenchResult rm = measure<safe_ptr<BenchDocument>>(n);
+        BenchResult sm = measure<shared_safe_ptr<BenchDocument>>(n);
+
+        std::cout << std::setw(8) << n << std::fixed << std::setprecision(0)
+                  << std::setw(16) << rm.reads << std::setw(16) << rm.writes
+                  << std::setw(16) << sm.reads << std::setw(16) << sm.writes
+                  << std::setw(8) << std::setprecision(2) << (rm.reads ? sm.reads / rm.reads : 0) << std::endl;
+    }
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <cstddef>
+
+class SafePtrBench
+{
+    public:
+        SafePtrBench() = delete;
+        static void run(size_t maxreaders);
+};
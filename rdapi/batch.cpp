@@ -0,0 +1,16 @@
+#include "batch.h"
+#include <rdcore/batch.h>
+
+RDBatch* RDBatch_Create(size_t threads) { return CPTR(RDBatch, new Batch(threads)); }
+void RDBatch_SetCallbacks(RDBatch* batch, Callback_BatchPrepare prepare, Callback_BatchCompleted completed, void* userdata) { CPTR(Batch, batch)->setCallbacks(prepare, completed, userdata); }
+void RDBatch_DisableAnalyzer(RDBatch* batch, const char* analyzerid) { if(analyzerid) CPTR(Batch, batch)->disableAnalyzer(analyzerid); }
+void RDBatch_SetFlags(RDBatch* batch, rd_flag flags) { CPTR(Batch, batch)->setFlags(flags); }
+void RDBatch_Enqueue(RDBatch* batch, const char* filepath) { if(filepath) CPTR(Batch, batch)->enqueue(filepath); }
+size_t RDBatch_GetPending(const RDBatch* batch) { return CPTR(const Batch, batch)->pending(); }
+void RDBatch_Wait(RDBatch* batch) { CPTR(Batch, batch)->wait(); }
+
+bool RDBatch_AddDatabase(RDBatch* batch, const char* dbpath, const char* filepath)
+{
+    if(!dbpath || !filepath) return false;
+    return CPTR(Batch, batch)->addDatabase(dbpath, filepath);
+}
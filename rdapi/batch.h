@@ -0,0 +1,20 @@
+#pragma once
+
+#include "macros.h"
+#include "types.h"
+
+RD_HANDLE(RDBatch);
+
+struct RDContext;
+
+typedef void (*Callback_BatchPrepare)(struct RDContext* ctx, const char* filepath, void* userdata);                // Before loading, configure the context here
+typedef void (*Callback_BatchCompleted)(struct RDContext* ctx, const char* filepath, bool success, void* userdata); // The context is freed when it returns
+
+RD_API_EXPORT RDBatch* RDBatch_Create(size_t threads); // 0: One thread per core
+RD_API_EXPORT void RDBatch_SetCallbacks(RDBatch* batch, Callback_BatchPrepare prepare, Callback_BatchCompleted completed, void* userdata);
+RD_API_EXPORT bool RDBatch_AddDatabase(RDBatch* batch, const char* dbpath, const char* filepath);
+RD_API_EXPORT void RDBatch_DisableAnalyzer(RDBatch* batch, const char* analyzerid);
+RD_API_EXPORT void RDBatch_SetFlags(RDBatch* batch, rd_flag flags);
+RD_API_EXPORT void RDBatch_Enqueue(RDBatch* batch, const char* filepath);
+RD_API_EXPORT size_t RDBatch_GetPending(const RDBatch* batch);
+RD_API_EXPORT void RDBatch_Wait(RDBatch* batch);
@@ -1,6 +1,8 @@
 #include "buffer.h"
 #include <rdcore/buffer/buffer.h>
 #include <rdcore/buffer/view.h>
+#include <rdcore/buffer/patternscanner.h>
+#include <rdcore/buffer/rollinghash.h>
 
 RDBuffer* RDBuffer_Create(size_t size) { return CPTR(RDBuffer, new MemoryBuffer(size)); }
 RDBuffer* RDBuffer_CreateFromFile(const char* filename) { return CPTR(RDBuffer, MemoryBuffer::fromFile(filename)); }
@@ -18,4 +20,13 @@ u8* RDBufferView_FindPattern(const RDBufferView* view, const char* pattern) { re
 u8* RDBufferView_FindPatternNext(RDBufferView* view, const char* pattern) { return BufferView::findPatternNext(view, pattern); }
 u16 RDBufferView_CRC16(const RDBufferView* view, rd_offset offset, size_t size) { return BufferView::crc16(view, offset, size); }
 u32 RDBufferView_CRC32(const RDBufferView* view, rd_offset offset, size_t size) { return BufferView::crc32(view, offset, size); }
+u32 RDBufferView_CRC32C(const RDBufferView* view, rd_offset offset, size_t size) { return BufferView::crc32c(view, offset, size); }
 void RDBufferView_Move(RDBufferView* view, s64 offset) { BufferView::move(view, offset); }
+RDPatternScanner* RDBufferView_CreateScanner(void) { return CPTR(RDPatternScanner, new PatternScanner()); }
+size_t RDBufferView_AddScannerPattern(RDPatternScanner* scanner, const char* pattern) { return pattern ? CPTR(PatternScanner, scanner)->addPattern(pattern) : RD_NVAL; }
+size_t RDBufferView_Scan(const RDBufferView* view, RDPatternScanner* scanner, const RDPatternMatch** matches) { return CPTR(PatternScanner, scanner)->scan(view, matches); }
+RDRollingHash* RDBufferView_CreateRollingHash(size_t window) { return CPTR(RDRollingHash, new RollingHash(window)); }
+u64 RDRollingHash_Update(RDRollingHash* rh, const RDBufferView* view) { return view ? CPTR(RollingHash, rh)->update(view) : CPTR(RollingHash, rh)->hash(); }
+u64 RDRollingHash_GetHash(const RDRollingHash* rh) { return CPTR(const RollingHash, rh)->hash(); }
+void RDRollingHash_Reset(RDRollingHash* rh) { CPTR(RollingHash, rh)->reset(); }
+size_t RDRollingHash_Chunk(RDRollingHash* rh, const RDBufferView* view, u64 mask, const rd_offset** boundaries) { return view ? CPTR(RollingHash, rh)->chunk(view, mask, boundaries) : 0; }
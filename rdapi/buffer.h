@@ -20,10 +20,29 @@ typedef struct RDBufferView {
     size_t size;
 } RDBufferView;
 
+RD_HANDLE(RDPatternScanner);
+RD_HANDLE(RDRollingHash);
+
+typedef struct RDPatternMatch {
+    rd_offset offset; // Relative to the scanned view
+    size_t pattern;   // Index returned by RDBufferView_AddScannerPattern()
+} RDPatternMatch;
+
 RD_API_EXPORT u8* RDBufferView_Find(const RDBufferView* view, const u8* data, size_t size);
 RD_API_EXPORT u8* RDBufferView_FindNext(RDBufferView* view, const u8* data, size_t size);
 RD_API_EXPORT u8* RDBufferView_FindPattern(const RDBufferView* view, const char* pattern);
 RD_API_EXPORT u8* RDBufferView_FindPatternNext(RDBufferView* view, const char* pattern);
 RD_API_EXPORT u16 RDBufferView_CRC16(const RDBufferView* view, rd_offset offset, size_t size);
 RD_API_EXPORT u32 RDBufferView_CRC32(const RDBufferView* view, rd_offset offset, size_t size);
+RD_API_EXPORT u32 RDBufferView_CRC32C(const RDBufferView* view, rd_offset offset, size_t size);
 RD_API_EXPORT void RDBufferView_Move(RDBufferView* view, s64 offset);
+RD_API_EXPORT RDPatternScanner* RDBufferView_CreateScanner(void);
+RD_API_EXPORT size_t RDBufferView_AddScannerPattern(RDPatternScanner* scanner, const char* pattern);
+RD_API_EXPORT size_t RDBufferView_Scan(const RDBufferView* view, RDPatternScanner* scanner, const RDPatternMatch** matches);
+
+// Rolling hash over the last 'window' bytes fed, views can be fed in pieces
+RD_API_EXPORT RDRollingHash* RDBufferView_CreateRollingHash(size_t window);
+RD_API_EXPORT u64 RDRollingHash_Update(RDRollingHash* rh, const RDBufferView* view);
+RD_API_EXPORT u64 RDRollingHash_GetHash(const RDRollingHash* rh);
+RD_API_EXPORT void RDRollingHash_Reset(RDRollingHash* rh);
+RD_API_EXPORT size_t RDRollingHash_Chunk(RDRollingHash* rh, const RDBufferView* view, u64 mask, const rd_offset** boundaries); // Chunk ends where (hash & mask) == 0
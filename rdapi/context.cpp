@@ -11,7 +11,16 @@ const RDEntryAssembler* RDContext_FindAssemblerEntry(const RDContext* ctx, const
 bool RDContext_MatchLoader(const RDContext* ctx, const char* q) { return q ? CPTR(const Context, ctx)->matchLoader(q) : false; }
 bool RDContext_MatchAssembler(const RDContext* ctx, const char* q) { return q ? CPTR(const Context, ctx)->matchAssembler(q) : false; }
 bool RDContext_Bind(RDContext* ctx, const RDLoaderRequest* req, const RDEntryLoader* entryloader, const RDEntryAssembler* entryassembler) { return CPTR(Context, ctx)->bind(req, entryloader, entryassembler); }
-const RDNet* RDContext_GetNet(const RDContext* ctx) { return CPTR(const RDNet, CPTR(const Context, ctx)->net()); }
+
+const RDNet* RDContext_GetNet(const RDContext* ctx)
+{
+    const Context* c = CPTR(const Context, ctx);
+    if(!c->disassembler()) return nullptr;
+
+    const SafeDocument& doc = c->document();
+    return CPTR(const RDNet, doc->net());
+}
+
 RDDocument* RDContext_GetDocument(const RDContext* ctx) { return CPTR(RDDocument, std::addressof(CPTR(const Context, ctx)->document())); }
 RDAssembler* RDContext_GetAssembler(const RDContext* ctx) { return CPTR(RDAssembler, CPTR(const Context, ctx)->assembler()); }
 RDLoader* RDContext_GetLoader(const RDContext* ctx) { return CPTR(RDLoader, CPTR(const Context, ctx)->loader()); }
@@ -25,6 +34,9 @@ uintptr_t RDContext_GetUserData(const RDContext* ctx, const char* s) { return s
 size_t RDContext_GetMinString(const RDContext* ctx) { return CPTR(const Context, ctx)->minString(); }
 void RDContext_SetMinString(RDContext* ctx, size_t n) { return CPTR(Context, ctx)->setMinString(n); }
 bool RDContext_IsBusy(const RDContext* ctx) { return CPTR(const Context, ctx)->busy(); }
+void RDContext_SetLogCallback(RDContext* ctx, RD_LogCallback callback, void* userdata) { CPTR(Context, ctx)->setLogCallback(callback, userdata); }
+void RDContext_SetStatusCallback(RDContext* ctx, RD_StatusCallback callback, void* userdata) { CPTR(Context, ctx)->setStatusCallback(callback, userdata); }
+void RDContext_SetProgressCallback(RDContext* ctx, RD_ProgressCallback callback, void* userdata) { CPTR(Context, ctx)->setProgressCallback(callback, userdata); }
 void RDContext_FindLoaderEntries(RDContext* ctx, const RDLoaderRequest* loadrequest, Callback_LoaderEntry callback, void* userdata) { CPTR(Context, ctx)->findLoaderEntries(loadrequest, callback, userdata); }
 void RDContext_FindAssemblerEntries(const RDContext* ctx, Callback_AssemblerEntry callback, void* userdata) { CPTR(const Context, ctx)->findAssemblerEntries(callback, userdata); }
 void RDContext_GetAnalyzers(const RDContext* ctx, Callback_Analyzer callback, void* userdata) { CPTR(const Context, ctx)->getAnalyzers(callback, userdata); }
@@ -33,6 +45,13 @@ void RDContext_DisableAnalyzer(RDContext* ctx, const char* analyzerid) { if(anal
 void RDContext_DisassembleBlock(RDContext* ctx, const RDBlock* block) { CPTR(Context, ctx)->disassembleBlock(block); }
 void RDContext_DisassembleAt(RDContext* ctx, rd_address address) { CPTR(Context, ctx)->disassembleAt(address); }
 void RDContext_Disassemble(RDContext* ctx) { CPTR(Context, ctx)->disassemble(); }
+void RDContext_DisassembleAsync(RDContext* ctx) { CPTR(Context, ctx)->disassembleAsync(); }
+bool RDContext_ExportSignatures(RDContext* ctx, const char* filepath) { return filepath ? CPTR(Context, ctx)->exportSignatures(filepath) : false; }
+void RDContext_SetPaused(RDContext* ctx, bool paused) { CPTR(Context, ctx)->setPaused(paused); }
+bool RDContext_IsPaused(const RDContext* ctx) { return CPTR(const Context, ctx)->paused(); }
+bool RDContext_GetAnalysisStatus(const RDContext* ctx, RDAnalysisStatus* status) { return CPTR(const Context, ctx)->analysisStatus(status); }
+void RDContext_Wait(RDContext* ctx) { CPTR(Context, ctx)->wait(); }
+void RDContext_Stop(RDContext* ctx) { CPTR(Context, ctx)->stop(); }
 bool RDContext_IsAnalyzerSelected(const RDContext* ctx, const RDAnalyzer* analyzer) { return analyzer ? CPTR(const Context, ctx)->isAnalyzerSelected(CPTR(const Analyzer, analyzer)) : false; }
 bool RDContext_ExecuteCommand(const RDContext* ctx, const char* cmd, const RDArguments* a) { return CPTR(const Context, ctx)->executeCommand(cmd, a); }
 size_t RDContext_GetProblemsCount(const RDContext* ctx) { return CPTR(const Context, ctx)->problemsCount(); }
@@ -125,7 +144,11 @@ const char* RD_QuotedSingle(const char* s)
 
 void RDContext_SetAddressAssembler(RDContext* ctx, rd_address address, const char* assembler)
 {
-    if(assembler) CPTR(Context, ctx)->document()->setAddressAssembler(address, assembler);
+    if(!assembler) return;
+
+    auto& doc = CPTR(Context, ctx)->document();
+    if(doc.mget()->shared_only()) spdlog::error("RDContext_SetAddressAssembler(): Write refused, the calling thread is reading the document");
+    else doc->setAddressAssembler(address, assembler);
 }
 
 const char* RDContext_GetAddressAssembler(const RDContext* ctx, rd_address address)
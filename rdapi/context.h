@@ -3,6 +3,7 @@
 #include <stddef.h>
 #include <stdbool.h>
 #include "object.h"
+#include "config.h"
 #include "types.h"
 
 #define CONTEXT_STATE_EXT ".rds"
@@ -28,10 +29,12 @@ enum RDCompilerCC {
 };
 
 enum RDContextFlags {
-    ContextFlags_None        = 0,
-    ContextFlags_NoDemangle  = (1 << 0),
-    ContextFlags_ShowRDIL    = (1 << 1),
-    ContextFlags_NoCodeMerge = (1 << 2),
+    ContextFlags_None          = 0,
+    ContextFlags_NoDemangle    = (1 << 0),
+    ContextFlags_ShowRDIL      = (1 << 1),
+    ContextFlags_NoCodeMerge   = (1 << 2),
+    ContextFlags_LinearSweep   = (1 << 3),
+    ContextFlags_AnalysisCache = (1 << 4), // Reuse completed analyses, see RDConfig_SetTempPath()
 };
 
 struct RDLoaderRequest;
@@ -77,6 +80,9 @@ RD_API_EXPORT RDSurface* RDContext_GetActiveSurface(const RDContext* ctx);
 RD_API_EXPORT void RDContext_SetUserData(RDContext* ctx, const char* s, uintptr_t userdata);
 RD_API_EXPORT uintptr_t RDContext_GetUserData(const RDContext* ctx, const char* s);
 RD_API_EXPORT bool RDContext_IsBusy(const RDContext* ctx);
+RD_API_EXPORT void RDContext_SetLogCallback(RDContext* ctx, RD_LogCallback callback, void* userdata);           // Overrides RDConfig's callback for this context
+RD_API_EXPORT void RDContext_SetStatusCallback(RDContext* ctx, RD_StatusCallback callback, void* userdata);
+RD_API_EXPORT void RDContext_SetProgressCallback(RDContext* ctx, RD_ProgressCallback callback, void* userdata);
 RD_API_EXPORT void RDContext_FindLoaderEntries(RDContext* ctx, const RDLoaderRequest* loadrequest, Callback_LoaderEntry callback, void* userdata);
 RD_API_EXPORT void RDContext_FindAssemblerEntries(const RDContext* ctx, Callback_AssemblerEntry callback, void* userdata);
 RD_API_EXPORT void RDContext_GetAnalyzers(const RDContext* ctx, Callback_Analyzer callback, void* userdata);
@@ -85,6 +91,13 @@ RD_API_EXPORT void RDContext_DisableAnalyzer(RDContext* ctx, const char* analyze
 RD_API_EXPORT void RDContext_DisassembleBlock(RDContext* ctx, const RDBlock* block);
 RD_API_EXPORT void RDContext_DisassembleAt(RDContext* ctx, rd_address address);
 RD_API_EXPORT void RDContext_Disassemble(RDContext* ctx);
+RD_API_EXPORT void RDContext_DisassembleAsync(RDContext* ctx);
+RD_API_EXPORT bool RDContext_ExportSignatures(RDContext* ctx, const char* filepath);
+RD_API_EXPORT void RDContext_SetPaused(RDContext* ctx, bool paused);
+RD_API_EXPORT bool RDContext_IsPaused(const RDContext* ctx);
+RD_API_EXPORT bool RDContext_GetAnalysisStatus(const RDContext* ctx, RDAnalysisStatus* status);
+RD_API_EXPORT void RDContext_Wait(RDContext* ctx);
+RD_API_EXPORT void RDContext_Stop(RDContext* ctx);
 RD_API_EXPORT bool RDContext_IsAnalyzerSelected(const RDContext* ctx, const RDAnalyzer* analyzer);
 RD_API_EXPORT bool RDContext_ExecuteCommand(const RDContext* ctx, const char* cmd, const struct RDArguments* a);
 RD_API_EXPORT size_t RDContext_GetProblemsCount(const RDContext* ctx);
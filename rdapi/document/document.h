@@ -38,7 +38,7 @@ RD_API_EXPORT bool RDDocument_PointerToSegment(const RDDocument* d, const void*
 RD_API_EXPORT bool RDDocument_AddressToSegment(const RDDocument* d, rd_address address, RDSegment* segment);
 RD_API_EXPORT bool RDDocument_OffsetToSegment(const RDDocument* d, rd_offset offset, RDSegment* segment);
 RD_API_EXPORT bool RDDocument_AddressToBlock(const RDDocument* d, rd_address address, RDBlock* block);
-RD_API_EXPORT bool RDDocument_GetFunctionGraph(const RDDocument* d, rd_address address, RDGraph** item);
+RD_API_EXPORT bool RDDocument_GetFunctionGraph(const RDDocument* d, rd_address address, RDGraph** item); // Built on demand and cached: it stays valid until at least 4096 other graphs have been dropped after it
 RD_API_EXPORT bool RDDocument_FindLabel(const RDDocument* d, const char* q, rd_address* resaddress);
 RD_API_EXPORT bool RDDocument_FindLabelR(const RDDocument* d, const char* q, rd_address* resaddress);
 RD_API_EXPORT bool RDDocument_GetView(const RDDocument* d, rd_address address, size_t size, RDBufferView* view);
@@ -56,6 +56,9 @@ RD_API_EXPORT size_t RDDocument_GetLabels(const RDDocument* d, const rd_address*
 RD_API_EXPORT size_t RDDocument_GetLabelsByFlag(const RDDocument* d, rd_flag flag, const rd_address** addresses);
 RD_API_EXPORT size_t RDDocument_GetSegments(const RDDocument* d, const rd_address** addresses);
 RD_API_EXPORT size_t RDDocument_GetFunctions(const RDDocument* d, const rd_address** addresses);
+RD_API_EXPORT size_t RDDocument_GetCallers(const RDDocument* d, rd_address address, const rd_address** addresses); // Functions calling 'address'
+RD_API_EXPORT size_t RDDocument_GetCallees(const RDDocument* d, rd_address address, const rd_address** addresses); // Targets called by function 'address'
 RD_API_EXPORT RDLocation RDDocument_GetFunctionStart(const RDDocument* d, rd_address address);
+RD_API_EXPORT size_t RDDocument_GetFunctionStarts(const RDDocument* d, const rd_address* addresses, size_t count, rd_address* starts); // RD_NVAL if not found, returns found count
 RD_API_EXPORT RDLocation RDDocument_GetEntry(const RDDocument* d);
 RD_API_EXPORT RDLocation RDDocument_Dereference(const RDDocument* d, rd_address address);
@@ -1,5 +1,6 @@
 #include "graph.h"
 #include <rdcore/graph/styledgraph.h>
+#include <rdcore/graph/graphanalysis.h>
 
 RDGraph* RDGraph_Create(RDContext* ctx) { return CPTR(RDGraph, new StyledGraph(CPTR(Context, ctx))); }
 const RDGraphEdge* RDGraph_GetEdge(const RDGraph* graph, RDGraphNode source, RDGraphNode target) { return CPTR(const Graph, graph)->edge(source, target); }
@@ -24,6 +25,22 @@ const char* RDGraph_GenerateDOT(const RDGraph* graph)
     return s.c_str();
 }
 
+size_t RDGraph_GetDominators(const RDGraph* graph, const RDGraphNode** idoms) { return CPTR(const Graph, graph)->analysis()->dominators(idoms); }
+size_t RDGraph_GetPostDominators(const RDGraph* graph, const RDGraphNode** ipdoms) { return CPTR(const Graph, graph)->analysis()->postDominators(ipdoms); }
+bool RDGraph_GetDominator(const RDGraph* graph, RDGraphNode n, RDGraphNode* idom) { return CPTR(const Graph, graph)->analysis()->dominator(n, idom); }
+bool RDGraph_GetPostDominator(const RDGraph* graph, RDGraphNode n, RDGraphNode* ipdom) { return CPTR(const Graph, graph)->analysis()->postDominator(n, ipdom); }
+bool RDGraph_Dominates(const RDGraph* graph, RDGraphNode a, RDGraphNode b) { return CPTR(const Graph, graph)->analysis()->dominates(a, b); }
+bool RDGraph_PostDominates(const RDGraph* graph, RDGraphNode a, RDGraphNode b) { return CPTR(const Graph, graph)->analysis()->postDominates(a, b); }
+size_t RDGraph_GetLoops(const RDGraph* graph, const RDGraphNode** headers) { return CPTR(const Graph, graph)->analysis()->loops(headers); }
+size_t RDGraph_GetLoopBody(const RDGraph* graph, RDGraphNode header, const RDGraphNode** nodes) { return CPTR(const Graph, graph)->analysis()->loopBody(header, nodes); }
+size_t RDGraph_GetLoopDepths(const RDGraph* graph, const size_t** depths) { return CPTR(const Graph, graph)->analysis()->loopDepths(depths); }
+size_t RDGraph_GetLoopDepth(const RDGraph* graph, RDGraphNode n) { return CPTR(const Graph, graph)->analysis()->loopDepth(n); }
+bool RDGraph_GetLoopHeader(const RDGraph* graph, RDGraphNode n, RDGraphNode* header) { return CPTR(const Graph, graph)->analysis()->loopHeader(n, header); }
+bool RDGraph_GetLoopParent(const RDGraph* graph, RDGraphNode header, RDGraphNode* parent) { return CPTR(const Graph, graph)->analysis()->loopParent(header, parent); }
+size_t RDGraph_GetComponents(const RDGraph* graph, const size_t** sccs) { return CPTR(const Graph, graph)->analysis()->components(sccs); }
+size_t RDGraph_GetComponentsCount(const RDGraph* graph) { return CPTR(const Graph, graph)->analysis()->componentsCount(); }
+size_t RDGraph_GetComponent(const RDGraph* graph, RDGraphNode n) { return CPTR(const Graph, graph)->analysis()->component(n); }
+
 const RDGraphData* RDGraph_GetData(const RDGraph* graph, RDGraphNode n) { return CPTR(const DataGraph, graph)->data(n); }
 void RDGraph_SetDataUInt(RDGraph* graph, RDGraphNode n, uintptr_t val) { CPTR(DataGraph, graph)->setData(n, val); }
 void RDGraph_SetDataInt(RDGraph* graph, RDGraphNode n, intptr_t val) { CPTR(DataGraph, graph)->setData(n, val); }
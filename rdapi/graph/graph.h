@@ -41,6 +41,23 @@ RD_API_EXPORT void RDGraph_RemoveNode(RDGraph* graph, RDGraphNode n);
 RD_API_EXPORT u32 RDGraph_Hash(const RDGraph* graph);
 RD_API_EXPORT const char* RDGraph_GenerateDOT(const RDGraph* graph);
 
+// Analysis (arrays are aligned with RDGraph_GetNodes())
+RD_API_EXPORT size_t RDGraph_GetDominators(const RDGraph* graph, const RDGraphNode** idoms);
+RD_API_EXPORT size_t RDGraph_GetPostDominators(const RDGraph* graph, const RDGraphNode** ipdoms);
+RD_API_EXPORT bool RDGraph_GetDominator(const RDGraph* graph, RDGraphNode n, RDGraphNode* idom);
+RD_API_EXPORT bool RDGraph_GetPostDominator(const RDGraph* graph, RDGraphNode n, RDGraphNode* ipdom);
+RD_API_EXPORT bool RDGraph_Dominates(const RDGraph* graph, RDGraphNode a, RDGraphNode b);
+RD_API_EXPORT bool RDGraph_PostDominates(const RDGraph* graph, RDGraphNode a, RDGraphNode b);
+RD_API_EXPORT size_t RDGraph_GetLoops(const RDGraph* graph, const RDGraphNode** headers);
+RD_API_EXPORT size_t RDGraph_GetLoopBody(const RDGraph* graph, RDGraphNode header, const RDGraphNode** nodes);
+RD_API_EXPORT size_t RDGraph_GetLoopDepths(const RDGraph* graph, const size_t** depths);
+RD_API_EXPORT size_t RDGraph_GetLoopDepth(const RDGraph* graph, RDGraphNode n);
+RD_API_EXPORT bool RDGraph_GetLoopHeader(const RDGraph* graph, RDGraphNode n, RDGraphNode* header);
+RD_API_EXPORT bool RDGraph_GetLoopParent(const RDGraph* graph, RDGraphNode header, RDGraphNode* parent);
+RD_API_EXPORT size_t RDGraph_GetComponents(const RDGraph* graph, const size_t** sccs);
+RD_API_EXPORT size_t RDGraph_GetComponentsCount(const RDGraph* graph);
+RD_API_EXPORT size_t RDGraph_GetComponent(const RDGraph* graph, RDGraphNode n);
+
 // Data
 RD_API_EXPORT const RDGraphData* RDGraph_GetData(const RDGraph* graph, RDGraphNode n);
 RD_API_EXPORT void RDGraph_SetDataUInt(RDGraph* graph, RDGraphNode n, uintptr_t val);
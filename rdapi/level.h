@@ -3,6 +3,6 @@
 #include <stdint.h>
 
 #define LIBREDASM_VERSION "3.0"
-#define RDAPI_LEVEL       1
+#define RDAPI_LEVEL       2 // Bump on every entry struct layout change: 2 = RDEntryAnalyzer.reads/writes, RDEntryAssembler.emulatebatch
 
 typedef uint32_t apilevel_t;
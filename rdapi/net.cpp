@@ -1,10 +1,15 @@
 #include "net.h"
 #include <rdcore/document/documentnet.h>
+#include <rdcore/document/document.h>
+#include <rdcore/context.h>
 
-const RDNetNode* RDNet_FindNode(const RDNet* net, rd_address address) { return CPTR(const RDNetNode, CPTR(const DocumentNet, net)->findNode(address)); }
-const RDNetNode* RDNet_GetPrevNode(const RDNet* net, const RDNetNode* netnode) { return CPTR(const RDNetNode, CPTR(const DocumentNet, net)->prevNode(CPTR(const DocumentNetNode, netnode))); }
-const RDNetNode* RDNet_GetNextNode(const RDNet* net, const RDNetNode* netnode) { return CPTR(const RDNetNode, CPTR(const DocumentNet, net)->nextNode(CPTR(const DocumentNetNode, netnode))); }
-size_t RDNet_GetReferences(const RDNet* net, rd_address address, const RDReference** refs) { return CPTR(const DocumentNet, net)->getReferences(address, refs); }
+// The net is owned by the document: go through it, so lookups take its shared lock
+static inline const SafeDocument& docptr(const RDNet* net) { return CPTR(const DocumentNet, net)->context()->document(); }
+
+const RDNetNode* RDNet_FindNode(const RDNet* net, rd_address address) { return CPTR(const RDNetNode, docptr(net)->net()->findNode(address)); }
+const RDNetNode* RDNet_GetPrevNode(const RDNet* net, const RDNetNode* netnode) { return CPTR(const RDNetNode, docptr(net)->net()->prevNode(CPTR(const DocumentNetNode, netnode))); }
+const RDNetNode* RDNet_GetNextNode(const RDNet* net, const RDNetNode* netnode) { return CPTR(const RDNetNode, docptr(net)->net()->nextNode(CPTR(const DocumentNetNode, netnode))); }
+size_t RDNet_GetReferences(const RDNet* net, rd_address address, const RDReference** refs) { return docptr(net)->net()->getReferences(address, refs); }
 
 rd_address RDNetNode_GetAddress(const RDNetNode* netnode) { return CPTR(const DocumentNetNode, netnode)->address; }
 rd_type RDNetNode_GetBranchType(const RDNetNode* netnode) { return CPTR(const DocumentNetNode, netnode)->branchtype; }
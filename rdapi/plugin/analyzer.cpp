@@ -8,3 +8,5 @@ const char* RDAnalyzer_GetDescription(const RDAnalyzer* analyzer) { return CPTR(
 const char* RDAnalyzer_GetName(const RDAnalyzer* analyzer) { return CPTR(const Analyzer, analyzer)->plugin()->name; }
 const char* RDAnalyzer_GetId(const RDAnalyzer* analyzer) { return CPTR(const Analyzer, analyzer)->plugin()->id; }
 u32 RDAnalyzer_GetOrder(const RDAnalyzer* analyzer) { return CPTR(const Analyzer, analyzer)->plugin()->order; }
+rd_flag RDAnalyzer_GetReads(const RDAnalyzer* analyzer) { return CPTR(const Analyzer, analyzer)->reads(); }
+rd_flag RDAnalyzer_GetWrites(const RDAnalyzer* analyzer) { return CPTR(const Analyzer, analyzer)->writes(); }
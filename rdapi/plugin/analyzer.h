@@ -9,6 +9,17 @@ enum RDAnalyzerFlags {
     AnalyzerFlags_Selected     = (1 << 0),
     AnalyzerFlags_RunOnce      = (1 << 1),
     AnalyzerFlags_Experimental = (1 << 2),
+    AnalyzerFlags_ThreadSafe   = (1 << 3), // Can run concurrently with analyzers that don't touch its resources
+};
+
+enum RDAnalyzerResources {
+    AnalyzerResources_None   = 0,
+    AnalyzerResources_Code   = (1 << 0),
+    AnalyzerResources_Data   = (1 << 1),
+    AnalyzerResources_Labels = (1 << 2),
+    AnalyzerResources_Net    = (1 << 3),
+
+    AnalyzerResources_All    = AnalyzerResources_Code | AnalyzerResources_Data | AnalyzerResources_Labels | AnalyzerResources_Net,
 };
 
 RD_HANDLE(RDAnalyzer);
@@ -24,6 +35,7 @@ typedef struct RDEntryAnalyzer {
     rd_flag flags;
     Callback_AnalyzerIsEnabled isenabled;
     Callback_AnalyzerExecute execute;
+    rd_flag reads, writes; // RDAnalyzerResources, None means All
 } RDEntryAnalyzer;
 
 RD_API_EXPORT bool RDAnalyzer_Register(RDPluginModule* pm, const RDEntryAnalyzer* plugin);
@@ -32,4 +44,5 @@ RD_API_EXPORT const char* RDAnalyzer_GetDescription(const RDAnalyzer* analyzer);
 RD_API_EXPORT const char* RDAnalyzer_GetName(const RDAnalyzer* analyzer);
 RD_API_EXPORT const char* RDAnalyzer_GetId(const RDAnalyzer* analyzer);
 RD_API_EXPORT u32 RDAnalyzer_GetOrder(const RDAnalyzer* analyzer);
-RD_API_EXPORT u32 RDAnalyzer_GetOrder(const RDAnalyzer* analyzer);
+RD_API_EXPORT rd_flag RDAnalyzer_GetReads(const RDAnalyzer* analyzer);
+RD_API_EXPORT rd_flag RDAnalyzer_GetWrites(const RDAnalyzer* analyzer);
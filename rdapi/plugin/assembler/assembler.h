@@ -12,6 +12,7 @@ RD_HANDLE(RDAssembler);
 
 struct RDEntryAssembler;
 struct RDEmulateResult;
+struct RDEmulateBatch;
 
 enum RDEncodeFlags {
     EncodeFlags_None    = 0,
@@ -29,6 +30,7 @@ RD_API_EXPORT void RDEncodedInstruction_Init(RDEncodedInstruction* encoded);
 RD_API_EXPORT bool RDEncodedInstruction_Set(RDEncodedInstruction* encoded, u8* encdata, size_t count);
 
 typedef void (*Callback_AssemblerEmulate)(RDContext* ctx, RDEmulateResult* result);
+typedef void (*Callback_AssemblerEmulateBatch)(RDContext* ctx, RDEmulateBatch* batch);
 typedef void (*Callback_AssemblerRenderSegment)(RDContext* ctx, const RDRendererParams* rp);
 typedef void (*Callback_AssemblerRenderFunction)(RDContext* ctx, const RDRendererParams* rp);
 typedef void (*Callback_AssemblerRenderInstruction)(RDContext* ctx, const RDRendererParams* rp);
@@ -47,6 +49,7 @@ typedef struct RDEntryAssembler {
     Callback_AssemblerLift lift;
 
     Callback_AssemblerEncode encode; // TODO: Review
+    Callback_AssemblerEmulateBatch emulatebatch; // Optional, decodes linear runs through RDEmulateBatch_Next()
 } RDEntryAssembler;
 
 RD_API_EXPORT bool RDAssembler_Register(RDPluginModule* m, const RDEntryAssembler* entry);
@@ -1,5 +1,6 @@
 #include "emulate.h"
 #include <rdcore/engine/algorithm/emulateresult.h>
+#include <rdcore/engine/algorithm/emulatebatch.h>
 
 const RDBufferView* RDEmulateResult_GetView(const RDEmulateResult* res) { return CPTR(const RDBufferView, CPTR(const EmulateResult, res)->view()); }
 rd_address RDEmulateResult_GetAddress(const RDEmulateResult* res) { return CPTR(const EmulateResult, res)->address(); }
@@ -26,3 +27,7 @@ void RDEmulateResult_AddInvalid(RDEmulateResult* res, size_t size) { CPTR(Emulat
 void RDEmulateResult_AddTable(RDEmulateResult* res, rd_address address, size_t size) { CPTR(EmulateResult, res)->addTable(address, size); }
 void RDEmulateResult_AddType(RDEmulateResult* res, rd_address address, const RDType* t) { if(t) CPTR(EmulateResult, res)->addType(address, CPTR(const Type, t)); }
 void RDEmulateResult_AddTypeName(RDEmulateResult* res, rd_address address, const char* q) { if(q) CPTR(EmulateResult, res)->addTypeName(address, q); }
+
+const RDBufferView* RDEmulateBatch_GetView(const RDEmulateBatch* batch) { return CPTR(const EmulateBatch, batch)->view(); }
+rd_address RDEmulateBatch_GetAddress(const RDEmulateBatch* batch) { return CPTR(const EmulateBatch, batch)->address(); }
+RDEmulateResult* RDEmulateBatch_Next(RDEmulateBatch* batch) { return CPTR(RDEmulateResult, CPTR(EmulateBatch, batch)->next()); }
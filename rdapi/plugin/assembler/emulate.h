@@ -7,6 +7,7 @@ struct RDBufferView;
 struct RDType;
 
 RD_HANDLE(RDEmulateResult);
+RD_HANDLE(RDEmulateBatch);
 
 RD_API_EXPORT const RDBufferView* RDEmulateResult_GetView(const RDEmulateResult* res);
 RD_API_EXPORT rd_address RDEmulateResult_GetAddress(const RDEmulateResult* res);
@@ -32,5 +33,9 @@ RD_API_EXPORT void RDEmulateResult_AddString(RDEmulateResult* res, rd_address ad
 RD_API_EXPORT void RDEmulateResult_AddStringSize(RDEmulateResult* res, rd_address address, size_t size);
 RD_API_EXPORT void RDEmulateResult_AddString(RDEmulateResult* res, rd_address address);
 RD_API_EXPORT void RDEmulateResult_AddType(RDEmulateResult* res, rd_address address, const RDType* t);
-RD_API_EXPORT void RDEmulateResult_AddTypeName(RDEmulateResult* res, rd_address address, const char* q);
+RD_API_EXPORT void RDEmulateResult_AddTypeName(RDEmulateResult* res, rd_address address, const char* q);      // 'q' is resolved right away, the buffer can be reused
 RD_API_EXPORT void RDEmulateResult_AddTable(RDEmulateResult* res, rd_address address, size_t size);
+
+RD_API_EXPORT const RDBufferView* RDEmulateBatch_GetView(const RDEmulateBatch* batch);
+RD_API_EXPORT rd_address RDEmulateBatch_GetAddress(const RDEmulateBatch* batch);
+RD_API_EXPORT RDEmulateResult* RDEmulateBatch_Next(RDEmulateBatch* batch);
@@ -5,6 +5,7 @@
 #include "level.h"
 #include "config.h"
 #include "context.h"
+#include "batch.h"
 #include "buffer.h"
 #include "events.h"
 #include "net.h"
@@ -20,6 +21,7 @@
 #include "plugin/command.h"
 #include "renderer/renderer.h"
 #include "renderer/surface.h"
+#include "renderer/listing.h"
 #include "database/database.h"
 #include "database/types.h"
 #include "graph/functiongraph.h"
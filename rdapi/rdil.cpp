@@ -1,7 +1,10 @@
 #include "rdil.h"
 #include <rdcore/builtin/graph/rdilgraph/rdilgraph.h>
 #include <rdcore/rdil/ilfunction.h>
+#include <rdcore/rdil/ilcache.h>
 #include <rdcore/rdil/rdil.h>
+#include <rdcore/document/document.h>
+#include <rdcore/context.h>
 
 RDGraph* RDILGraph_Create(RDContext* ctx, rd_address address)
 {
@@ -44,8 +47,16 @@ const char* RDILExpression_GetFormat(const RDILExpression* e)
 
 RDILFunction* RDILFunction_Create(RDContext* ctx, rd_address address)
 {
-    std::unique_ptr<ILFunction> il = std::make_unique<ILFunction>(CPTR(Context, ctx));
-    if(!ILFunction::generate(address, il.get())) return nullptr;
+    auto* context = CPTR(Context, ctx);
+    std::unique_ptr<ILFunction> il = std::make_unique<ILFunction>(context);
+
+    RDLocation loc = context->document()->getFunctionStart(address);
+    ILCache::ILFunctionPtr cachedil;
+    if(loc.valid && (loc.address == address)) cachedil = context->ilCache()->function(address); // Interior addresses are lifted from there, as before
+
+    if(cachedil) il->copyFrom(cachedil.get()); // Caller owns the result: copy, don't lift again
+    else if(!ILFunction::generate(address, il.get())) return nullptr;
+
     return CPTR(RDILFunction, il.release());
 }
 
@@ -0,0 +1,18 @@
+#include "listing.h"
+#include <rdcore/surface/listingexporter.h>
+#include <rdcore/context.h>
+
+bool RDListing_ExportFile(RDContext* ctx, const char* filepath, rd_type format, rd_flag flags)
+{
+    if(!filepath) return false;
+    return ListingExporter(CPTR(Context, ctx), format, flags).exportFile(filepath);
+}
+
+bool RDListing_Export(RDContext* ctx, rd_type format, rd_flag flags, Callback_ListingSink sink, void* userdata)
+{
+    if(!sink) return false;
+
+    return ListingExporter(CPTR(Context, ctx), format, flags).exportTo([sink, userdata](const char* data, size_t size) {
+        return sink(data, size, userdata);
+    });
+}
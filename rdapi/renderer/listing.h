@@ -0,0 +1,17 @@
+#pragma once
+
+#include "../types.h"
+#include "../macros.h"
+
+struct RDContext;
+
+enum RDListingFormat {
+    ListingFormat_Text,
+    ListingFormat_JsonLines, // One object per line: address, kind, text
+};
+
+typedef bool (*Callback_ListingSink)(const char* data, size_t size, void* userdata); // Return false to stop
+
+// 'flags' are RDRendererFlags, segments are rendered concurrently and written in order
+RD_API_EXPORT bool RDListing_ExportFile(RDContext* ctx, const char* filepath, rd_type format, rd_flag flags);
+RD_API_EXPORT bool RDListing_Export(RDContext* ctx, rd_type format, rd_flag flags, Callback_ListingSink sink, void* userdata);
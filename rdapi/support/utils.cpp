@@ -52,6 +52,7 @@ u32 RD_Swap32(u32 hostval) { return Endian::swap32(hostval); }
 u64 RD_Swap64(u64 hostval) { return Endian::swap64(hostval); }
 u32 RD_Adler32(const u8* data, size_t size) { return data && size ? Hash::adler32(data, size) : 0; }
 u32 RD_Crc32(const u8* data, size_t size) { return data && size ? Hash::crc32(data, size) : 0; }
+u32 RD_Crc32c(const u8* data, size_t size) { return data && size ? Hash::crc32c(data, size) : 0; }
 u16 RD_Rol16(u16 val, u16 amt) { return Utils::rol(val, amt); }
 u32 RD_Rol32(u32 val, u32 amt) { return Utils::rol(val, amt); }
 u64 RD_Rol64(u64 val, u64 amt) { return Utils::rol(val, amt); }
@@ -29,6 +29,7 @@ RD_API_EXPORT intptr_t RD_SignExt(uintptr_t val, int valbits);
 RD_API_EXPORT size_t* RD_HashCombine(size_t* h, size_t v);
 RD_API_EXPORT u32 RD_Adler32(const u8* data, size_t size);
 RD_API_EXPORT u32 RD_Crc32(const u8* data, size_t size);
+RD_API_EXPORT u32 RD_Crc32c(const u8* data, size_t size);
 RD_API_EXPORT u16 RD_Swap16(u16 hostval);
 RD_API_EXPORT u32 RD_Swap32(u32 hostval);
 RD_API_EXPORT u64 RD_Swap64(u64 hostval);
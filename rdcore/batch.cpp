@@ -0,0 +1,154 @@
+#include "batch.h"
+#include "plugin/interface/pluginmanager.h"
+#include "buffer/buffer.h"
+#include "context.h"
+#include "config.h"
+
+namespace {
+
+struct ThreadRouteGuard // Resets the route on every path, before the context it points to is destroyed
+{
+    ThreadRouteGuard(const LogRoute* route) { Config::setThreadRoute(route); }
+    ~ThreadRouteGuard() { Config::setThreadRoute(nullptr); }
+};
+
+}
+
+Batch::Batch(size_t threads): Object(), m_runtime(std::make_unique<Context>())
+{
+    // Keep every plugin library resident, workers won't map them again
+    m_runtime->pluginManager()->loadAll();
+
+    if(!threads) threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    for(size_t i = 0; i < threads; i++) m_workers.emplace_back(&Batch::work, this);
+}
+
+Batch::~Batch()
+{
+    {
+        std::scoped_lock<std::mutex> lock(m_mutex);
+        m_queue.clear();
+        m_stop = true;
+    }
+
+    m_cvqueue.notify_all();
+    for(auto& w : m_workers) w.join();
+}
+
+void Batch::setCallbacks(Callback_BatchPrepare prepare, Callback_BatchCompleted completed, void* userdata)
+{
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    m_callbacks = { prepare, completed, userdata };
+}
+
+bool Batch::addDatabase(const std::string& dbpath, const std::string& filepath)
+{
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    if(!m_runtime->database()->add(dbpath, filepath)) return false; // Parse and validate it once, workers share it
+
+    m_databases.emplace_back(dbpath, filepath);
+    return true;
+}
+
+void Batch::disableAnalyzer(const std::string& analyzerid)
+{
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    m_disabledanalyzers.insert(analyzerid);
+}
+
+void Batch::setFlags(rd_flag flags)
+{
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    m_flags = flags;
+}
+
+void Batch::enqueue(const std::string& filepath)
+{
+    {
+        std::scoped_lock<std::mutex> lock(m_mutex);
+        m_queue.push_back(filepath);
+    }
+
+    m_cvqueue.notify_one();
+}
+
+size_t Batch::pending() const
+{
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    return m_queue.size() + m_active;
+}
+
+void Batch::wait()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cvidle.wait(lock, [&]() { return m_queue.empty() && !m_active; });
+}
+
+bool Batch::analyze(Context* ctx, const std::string& filepath) const
+{
+    MemoryBuffer* buffer = MemoryBuffer::fromFile(filepath.c_str());
+    if(!buffer) return false;
+
+    RDLoaderRequest req = { filepath.c_str(), CPTR(RDBuffer, buffer), { } };
+    const RDEntryLoader* entryloader = nullptr;
+
+    ctx->findLoaderEntries(&req, [](const RDEntryLoader* entry, void* userdata) {
+        auto** first = reinterpret_cast<const RDEntryLoader**>(userdata);
+        if(!*first) *first = entry; // Same choice as the interactive default
+    }, &entryloader);
+
+    if(!entryloader || !ctx->bind(&req, entryloader, nullptr))
+    {
+        if(!ctx->disassembler()) delete buffer; // Not taken by the context
+        return false;
+    }
+
+    ctx->disassemble();
+    return true;
+}
+
+void Batch::work()
+{
+    for( ; ; )
+    {
+        std::string filepath;
+        Callbacks callbacks;
+        std::vector<std::pair<std::string, std::string>> databases;
+        std::unordered_set<std::string> disabledanalyzers;
+        rd_flag flags;
+
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cvqueue.wait(lock, [&]() { return m_stop || !m_queue.empty(); });
+            if(m_stop) return;
+
+            filepath = std::move(m_queue.front());
+            m_queue.pop_front();
+            m_active++;
+
+            callbacks = m_callbacks;
+            databases = m_databases;
+            disabledanalyzers = m_disabledanalyzers;
+            flags = m_flags;
+        }
+
+        {
+            Context ctx(m_runtime.get()); // Plugin discovery comes from the runtime
+            ThreadRouteGuard route{ctx.logRoute()}; // Database and callback logs belong to this file too
+            ctx.setFlags(flags, true);
+            for(const auto& [dbpath, dbfilepath] : databases) ctx.database()->add(dbpath, dbfilepath); // Mounts the runtime's parsed copy
+            for(const auto& analyzerid : disabledanalyzers) ctx.disableAnalyzer(analyzerid);
+            if(callbacks.prepare) callbacks.prepare(CPTR(RDContext, &ctx), filepath.c_str(), callbacks.userdata);
+
+            bool success = this->analyze(&ctx, filepath);
+            if(callbacks.completed) callbacks.completed(CPTR(RDContext, &ctx), filepath.c_str(), success, callbacks.userdata);
+        }
+
+        {
+            std::scoped_lock<std::mutex> lock(m_mutex);
+            m_active--;
+        }
+
+        m_cvidle.notify_all();
+    }
+}
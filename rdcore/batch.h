@@ -0,0 +1,59 @@
+#pragma once
+
+/*
+ * Analyzes many files concurrently, one independent Context per file.
+ * Plugins and databases are loaded once by a runtime context and stay resident,
+ * worker contexts reuse its plugin discovery and share its parsed databases and their types.
+ * Logs and status updates of each worker are routed to its own context.
+ */
+
+#include <rdapi/context.h>
+#include <rdapi/batch.h>
+#include <condition_variable>
+#include <unordered_set>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include "object.h"
+
+class Batch: public Object
+{
+    private:
+        struct Callbacks {
+            Callback_BatchPrepare prepare{nullptr};
+            Callback_BatchCompleted completed{nullptr};
+            void* userdata{nullptr};
+        };
+
+    public:
+        Batch(size_t threads);
+        ~Batch();
+        void setCallbacks(Callback_BatchPrepare prepare, Callback_BatchCompleted completed, void* userdata);
+        bool addDatabase(const std::string& dbpath, const std::string& filepath);
+        void disableAnalyzer(const std::string& analyzerid);
+        void setFlags(rd_flag flags);
+        void enqueue(const std::string& filepath);
+        size_t pending() const;
+        void wait();
+
+    private:
+        bool analyze(Context* ctx, const std::string& filepath) const;
+        void work();
+
+    private:
+        std::unique_ptr<Context> m_runtime;
+        std::vector<std::pair<std::string, std::string>> m_databases;
+        std::unordered_set<std::string> m_disabledanalyzers;
+        rd_flag m_flags{ContextFlags_None};
+        Callbacks m_callbacks;
+
+    private:
+        std::vector<std::thread> m_workers;
+        std::deque<std::string> m_queue;
+        mutable std::mutex m_mutex;
+        std::condition_variable m_cvqueue, m_cvidle;
+        size_t m_active{0};
+        bool m_stop{false};
+};
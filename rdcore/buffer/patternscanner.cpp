@@ -0,0 +1,239 @@
+#include "patternscanner.h"
+#include <algorithm>
+#include <cstring>
+#include <cctype>
+#include <deque>
+
+static inline int hexDigit(char c)
+{
+    if((c >= '0') && (c <= '9')) return c - '0';
+    if((c >= 'a') && (c <= 'f')) return c - 'a' + 10;
+    if((c >= 'A') && (c <= 'F')) return c - 'A' + 10;
+    return -1;
+}
+
+bool CompiledPattern::match(const u8* data, size_t datasize) const
+{
+    if(datasize < values.size()) return false;
+
+    for(size_t i = 0; i < values.size(); i++)
+    {
+        if((data[i] & masks[i]) != values[i])
+            return false;
+    }
+
+    return true;
+}
+
+size_t PatternScanner::addPattern(const std::string_view& pattern)
+{
+    CompiledPattern cp;
+    if(!PatternScanner::compile(pattern, &cp)) return RD_NVAL;
+
+    m_patterns.push_back(std::move(cp));
+    m_dirty = true;
+    return m_patterns.size() - 1;
+}
+
+size_t PatternScanner::scan(const RDBufferView* view, const RDPatternMatch** matches)
+{
+    if(m_dirty) this->build();
+    m_matches.clear();
+
+    if(view && view->data && !m_states.empty())
+    {
+        u32 state = 0;
+
+        for(size_t i = 0; i < view->size; i++)
+        {
+            state = this->next(state, view->data[i]);
+
+            for(size_t idx : m_outputs[state])
+            {
+                const CompiledPattern& cp = m_patterns[idx];
+                size_t anchorend = cp.anchoroffset + cp.anchorsize;
+                if((i + 1) < anchorend) continue;
+
+                size_t offset = (i + 1) - anchorend;
+                if(cp.match(view->data + offset, view->size - offset)) m_matches.push_back({offset, idx});
+            }
+        }
+
+        std::sort(m_matches.begin(), m_matches.end(), [](const RDPatternMatch& m1, const RDPatternMatch& m2) {
+            return (m1.offset == m2.offset) ? (m1.pattern < m2.pattern) : (m1.offset < m2.offset);
+        });
+    }
+
+    if(matches) *matches = m_matches.data();
+    return m_matches.size();
+}
+
+size_t PatternScanner::patternSize(size_t idx) const { return (idx < m_patterns.size()) ? m_patterns[idx].size() : 0; }
+size_t PatternScanner::size() const { return m_patterns.size(); }
+
+bool PatternScanner::compile(std::string_view pattern, CompiledPattern* cp)
+{
+    cp->values.clear();
+    cp->masks.clear();
+    cp->anchoroffset = cp->anchorsize = 0;
+
+    std::string p;
+    p.reserve(pattern.size());
+
+    for(char c : pattern)
+    {
+        if(!std::isspace(static_cast<unsigned char>(c)))
+            p.push_back(c);
+    }
+
+    if(p.empty() || (p.size() % 2)) return false;
+
+    size_t runoffset = 0, runsize = 0;
+
+    for(size_t i = 0; i < p.size(); i += 2)
+    {
+        if((p[i] == '?') && (p[i + 1] == '?'))
+        {
+            cp->values.push_back(0);
+            cp->masks.push_back(0);
+            runsize = 0;
+            continue;
+        }
+
+        int hi = hexDigit(p[i]), lo = hexDigit(p[i + 1]);
+        if((hi == -1) || (lo == -1)) return false;
+
+        if(!runsize) runoffset = cp->values.size();
+        cp->values.push_back(static_cast<u8>((hi << 4) | lo));
+        cp->masks.push_back(0xFF);
+
+        if(++runsize > cp->anchorsize)
+        {
+            cp->anchoroffset = runoffset;
+            cp->anchorsize = runsize;
+        }
+    }
+
+    if(!cp->anchorsize) return false; // Wildcards only
+    cp->anchorsize = std::min<size_t>(cp->anchorsize, PATTERN_ANCHOR_SIZE);
+    return true;
+}
+
+rd_offset PatternScanner::find(const u8* data, size_t datasize, const CompiledPattern& cp)
+{
+    if(!data || !cp.size() || (cp.size() > datasize)) return RD_NVAL;
+
+    size_t last = datasize - cp.size();
+    u8 first = cp.values[cp.anchoroffset];
+
+    for(size_t offset = 0; offset <= last; offset++)
+    {
+        // Skip to the next occurrence of the first fixed byte
+        const void* c = std::memchr(data + offset + cp.anchoroffset, first, last - offset + 1);
+        if(!c) break;
+
+        offset = (reinterpret_cast<const u8*>(c) - data) - cp.anchoroffset;
+        if(cp.match(data + offset, datasize - offset)) return offset;
+    }
+
+    return RD_NVAL;
+}
+
+u32 PatternScanner::next(u32 state, u8 b) const
+{
+    for( ; ; ) // The root is dense, failure links always end there
+    {
+        const State& s = m_states[state];
+        if(s.dense != SPARSE) return m_dense[s.dense][b];
+
+        auto begin = m_edges.begin() + s.edges, end = begin + s.nedges;
+        auto it = std::lower_bound(begin, end, b, [](const Edge& e, u8 v) { return e.value < v; });
+        if((it != end) && (it->value == b)) return it->state;
+
+        state = s.fail;
+    }
+}
+
+void PatternScanner::build()
+{
+    std::vector<std::vector<Edge>> trie(1); // Children sorted by value
+    std::vector<size_t> depth(1, 0);
+    m_outputs.assign(1, { });
+
+    for(size_t idx = 0; idx < m_patterns.size(); idx++)
+    {
+        const CompiledPattern& cp = m_patterns[idx];
+        u32 state = 0;
+
+        for(size_t i = cp.anchoroffset; i < cp.anchoroffset + cp.anchorsize; i++)
+        {
+            u8 b = cp.values[i];
+            auto& children = trie[state];
+            auto it = std::lower_bound(children.begin(), children.end(), b, [](const Edge& e, u8 v) { return e.value < v; });
+
+            if((it != children.end()) && (it->value == b))
+            {
+                state = it->state;
+                continue;
+            }
+
+            u32 u = static_cast<u32>(trie.size());
+            children.insert(it, {b, u});
+            depth.push_back(depth[state] + 1);
+            trie.emplace_back(); // Invalidates 'children'
+            m_outputs.emplace_back();
+            state = u;
+        }
+
+        m_outputs[state].push_back(idx);
+    }
+
+    m_states.assign(trie.size(), State{0, SPARSE, 0, 0});
+    m_edges.clear();
+
+    for(size_t i = 0; i < trie.size(); i++)
+    {
+        m_states[i].edges = static_cast<u32>(m_edges.size());
+        m_states[i].nedges = static_cast<u32>(trie[i].size());
+        m_edges.insert(m_edges.end(), trie[i].begin(), trie[i].end());
+    }
+
+    // Failure links in BFS order, dense rows follow them for missing edges
+    m_dense.assign(1, Transitions{ });
+    m_states[0].dense = 0;
+
+    std::deque<u32> queue;
+
+    for(const Edge& e : trie[0])
+    {
+        m_dense[0][e.value] = e.state;
+        queue.push_back(e.state);
+    }
+
+    while(!queue.empty())
+    {
+        u32 r = queue.front();
+        queue.pop_front();
+
+        if(depth[r] < PATTERN_DENSE_DEPTH) // Its failure state is shallower, so already dense
+        {
+            Transitions row = m_dense[m_states[m_states[r].fail].dense];
+            for(const Edge& e : trie[r]) row[e.value] = e.state;
+
+            m_states[r].dense = static_cast<u32>(m_dense.size());
+            m_dense.push_back(row);
+        }
+
+        for(const Edge& e : trie[r])
+        {
+            u32 f = this->next(m_states[r].fail, e.value);
+            m_states[e.state].fail = f;
+
+            const auto& suffixout = m_outputs[f];
+            m_outputs[e.state].insert(m_outputs[e.state].end(), suffixout.begin(), suffixout.end());
+            queue.push_back(e.state);
+        }
+    }
+
+    m_dirty = false;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <string_view>
+#include <vector>
+#include <array>
+#include <rdapi/buffer.h>
+#include "../object.h"
+
+#define PATTERN_ANCHOR_SIZE 8
+#define PATTERN_DENSE_DEPTH 2 // States closer to the root get a full transition row, deeper ones keep their trie edges
+
+struct CompiledPattern
+{
+    std::vector<u8> values, masks;    // Wildcards have a zero mask
+    size_t anchoroffset{0}, anchorsize{0}; // Longest run of fixed bytes, used by the automaton
+
+    size_t size() const { return values.size(); }
+    bool match(const u8* data, size_t datasize) const;
+};
+
+class PatternScanner: public Object
+{
+    private:
+        typedef std::array<u32, 256> Transitions;
+        struct Edge { u8 value; u32 state; };
+        struct State { u32 fail, dense, edges, nedges; }; // 'dense' indexes m_dense, SPARSE otherwise
+
+        static constexpr u32 SPARSE = static_cast<u32>(-1);
+
+    public:
+        PatternScanner() = default;
+        size_t addPattern(const std::string_view& pattern);
+        size_t scan(const RDBufferView* view, const RDPatternMatch** matches);
+        size_t patternSize(size_t idx) const;
+        size_t size() const;
+
+    public:
+        static bool compile(std::string_view pattern, CompiledPattern* cp);
+        static rd_offset find(const u8* data, size_t datasize, const CompiledPattern& cp);
+
+    private:
+        u32 next(u32 state, u8 b) const;
+        void build();
+
+    private:
+        std::vector<CompiledPattern> m_patterns;
+        std::vector<State> m_states;                // Aho-Corasick automaton over the anchors
+        std::vector<Transitions> m_dense;           // Complete rows, missing edges already resolved
+        std::vector<Edge> m_edges;                  // Sorted by value for each state
+        std::vector<std::vector<size_t>> m_outputs; // Patterns whose anchor ends at each state
+        std::vector<RDPatternMatch> m_matches;
+        bool m_dirty{false};
+};
@@ -0,0 +1,62 @@
+#include "rollinghash.h"
+
+static constexpr u64 rol64(u64 v, size_t amt) { amt %= 64; return amt ? (v << amt) | (v >> (64 - amt)) : v; }
+
+static constexpr std::array<u64, 256> makeTable()
+{
+    std::array<u64, 256> t{ };
+    u64 state = 0x5245444173680000; // Fixed seed: hashes must be stable between runs
+
+    for(auto& v : t) // SplitMix64
+    {
+        u64 z = (state += 0x9E3779B97F4A7C15);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+        v = z ^ (z >> 31);
+    }
+
+    return t;
+}
+
+const std::array<u64, 256> RollingHash::TABLE = makeTable();
+
+RollingHash::RollingHash(size_t window): m_ring(window ? window : 1), m_window(m_ring.size()) { }
+size_t RollingHash::window() const { return m_window; }
+u64 RollingHash::hash() const { return m_hash; }
+
+void RollingHash::reset()
+{
+    m_pos = m_filled = 0;
+    m_hash = 0;
+}
+
+u64 RollingHash::update(const RDBufferView* view)
+{
+    for(size_t i = 0; i < view->size; i++) this->push(view->data[i]);
+    return m_hash;
+}
+
+size_t RollingHash::chunk(const RDBufferView* view, u64 mask, const rd_offset** boundaries)
+{
+    m_boundaries.clear();
+
+    for(size_t i = 0; i < view->size; i++)
+    {
+        this->push(view->data[i]);
+        if((m_filled == m_window) && !(m_hash & mask)) m_boundaries.push_back(i + 1);
+    }
+
+    if(boundaries) *boundaries = m_boundaries.data();
+    return m_boundaries.size();
+}
+
+void RollingHash::push(u8 b)
+{
+    m_hash = rol64(m_hash, 1) ^ TABLE[b];
+
+    if(m_filled == m_window) m_hash ^= rol64(TABLE[m_ring[m_pos]], m_window); // Drop the byte leaving the window
+    else m_filled++;
+
+    m_ring[m_pos] = b;
+    if(++m_pos == m_window) m_pos = 0;
+}
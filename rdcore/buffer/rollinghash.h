@@ -0,0 +1,29 @@
+#pragma once
+
+#include <vector>
+#include <array>
+#include <rdapi/buffer.h>
+#include "../object.h"
+
+class RollingHash: public Object // Buzhash over a fixed window, state is kept between updates
+{
+    public:
+        RollingHash(size_t window);
+        size_t window() const;
+        u64 hash() const;
+        void reset();
+        u64 update(const RDBufferView* view);
+        size_t chunk(const RDBufferView* view, u64 mask, const rd_offset** boundaries);
+
+    private:
+        void push(u8 b);
+
+    private:
+        static const std::array<u64, 256> TABLE;
+
+    private:
+        std::vector<u8> m_ring;
+        std::vector<rd_offset> m_boundaries;
+        size_t m_window, m_pos{0}, m_filled{0};
+        u64 m_hash{0};
+};
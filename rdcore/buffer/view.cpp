@@ -1,4 +1,5 @@
 #include "view.h"
+#include "patternscanner.h"
 #include "../support/utils.h"
 #include "../support/hash.h"
 
@@ -13,11 +14,12 @@ void BufferView::move(RDBufferView* view, s64 offset)
 
 u16 BufferView::crc16(const RDBufferView* view, rd_offset offset, size_t size) { return Hash::crc16(view->data, view->size, offset, size); }
 u32 BufferView::crc32(const RDBufferView* view, rd_offset offset, size_t size) { return Hash::crc32(view->data, view->size, offset, size); }
+u32 BufferView::crc32c(const RDBufferView* view, rd_offset offset, size_t size) { return Hash::crc32c(view->data, view->size, offset, size); }
 
 u8* BufferView::find(const RDBufferView* view, const u8* finddata, size_t findsize)
 {
     rd_offset offset = Utils::findIn(view->data, view->size, finddata, findsize);
-    return offset == RD_NVAL ? view->data + offset : nullptr;
+    return offset != RD_NVAL ? view->data + offset : nullptr;
 }
 
 u8* BufferView::findNext(RDBufferView* view, const u8* finddata, size_t findsize)
@@ -39,16 +41,19 @@ u8* BufferView::findNext(RDBufferView* view, const u8* finddata, size_t findsize
 
 u8* BufferView::findPattern(const RDBufferView* view, const char* pattern)
 {
-    if(!pattern) return nullptr;
-    rd_offset offset = Utils::findPattern(view->data, view->size, pattern);
-    return offset == RD_NVAL ? view->data + offset : nullptr;
+    CompiledPattern cp;
+    if(!pattern || !PatternScanner::compile(pattern, &cp)) return nullptr;
+
+    rd_offset offset = PatternScanner::find(view->data, view->size, cp);
+    return offset != RD_NVAL ? view->data + offset : nullptr;
 }
 
 u8* BufferView::findPatternNext(RDBufferView* view, const char* pattern)
 {
-    if(!pattern) return nullptr;
-    size_t patternlen = 0;
-    rd_offset offset = Utils::findPattern(view->data, view->size, pattern, &patternlen);
+    CompiledPattern cp;
+    if(!pattern || !PatternScanner::compile(pattern, &cp)) return nullptr;
+
+    rd_offset offset = PatternScanner::find(view->data, view->size, cp);
 
     if(offset == RD_NVAL)
     {
@@ -57,6 +62,6 @@ u8* BufferView::findPatternNext(RDBufferView* view, const char* pattern)
     }
 
     u8* res = view->data + offset;
-    BufferView::move(view, offset + patternlen);
+    BufferView::move(view, offset + cp.size());
     return res;
 }
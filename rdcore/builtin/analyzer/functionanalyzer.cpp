@@ -1,5 +1,6 @@
 #include "functionanalyzer.h"
 #include "../../rdil/ilfunction.h"
+#include "../../rdil/ilcache.h"
 #include "../../rdil/rdil.h"
 #include "../../document/document.h"
 #include "../../disassembler.h"
@@ -7,9 +8,10 @@
 #include "../builtin.h"
 
 RDEntryAnalyzer analyzerEntry_Function = RD_BUILTIN_ENTRY(analyzerfunction_builtin, "Discover Functions", 0,
-                                                          "Autorename Nullsubs and Thunks", AnalyzerFlags_Selected,
+                                                          "Autorename Nullsubs and Thunks", AnalyzerFlags_Selected | AnalyzerFlags_ThreadSafe,
                                                           [](const RDContext*) -> bool { return true; },
-                                                          [](RDContext* ctx) { FunctionAnalyzer::analyze(CPTR(Context, ctx)); });
+                                                          [](RDContext* ctx) { FunctionAnalyzer::analyze(CPTR(Context, ctx)); },
+                                                          AnalyzerResources_Code | AnalyzerResources_Labels, AnalyzerResources_Labels);
 
 void FunctionAnalyzer::analyze(Context* ctx)
 {
@@ -28,11 +30,21 @@ void FunctionAnalyzer::analyze(Context* ctx)
         RDBufferView view;
         if(!document->getView(address, RD_NVAL, &view)) continue;
 
-        std::unique_ptr<ILExpression> e(ILFunction::generateOne(ctx, address));
+        auto il = ctx->ilCache()->peek(address); // Reuse a function lifted by someone else, don't lift the whole function here
+        const ILExpression* e = il ? il->expressionAt(address) : nullptr;
+
+        std::unique_ptr<ILExpression> owned;
+
+        if(!e) // Not cached, lift its first instruction only
+        {
+            owned.reset(ILFunction::generateOne(ctx, address));
+            e = owned.get();
+        }
+
         if(!e) continue;
 
-        if(FunctionAnalyzer::findNullSubs(ctx, e.get(), address)) continue;
-        FunctionAnalyzer::findThunk(ctx, e.get(), address);
+        if(FunctionAnalyzer::findNullSubs(ctx, e, address)) continue;
+        FunctionAnalyzer::findThunk(ctx, e, address);
     }
 }
 
@@ -0,0 +1,196 @@
+#include "signatureanalyzer.h"
+#include "../../document/document.h"
+#include "../../plugin/assembler.h"
+#include "../../engine/algorithm/emulateresult.h"
+#include "../../support/utils.h"
+#include "../../disassembler.h"
+#include "../../context.h"
+#include "../../config.h"
+#include "../builtin.h"
+#include <algorithm>
+
+RDEntryAnalyzer analyzerEntry_Signature = RD_BUILTIN_ENTRY(analyzersignature_builtin, "Identify Library Functions", 1,
+                                                           "Rename functions matching the signature databases", AnalyzerFlags_Selected | AnalyzerFlags_ThreadSafe,
+                                                           [](const RDContext*) -> bool { return true; },
+                                                           [](RDContext* ctx) { SignatureAnalyzer::analyze(CPTR(Context, ctx)); },
+                                                           AnalyzerResources_Code, AnalyzerResources_Labels);
+
+std::unordered_map<std::string, SignatureAnalyzer::SignatureDatabasePtr> SignatureAnalyzer::m_signatures;
+std::mutex SignatureAnalyzer::m_mutex;
+
+void SignatureAnalyzer::analyze(Context* ctx)
+{
+    auto* state = ctx->analyzerData<State>();
+    if(!state->signatures) state->signatures = SignatureAnalyzer::loadSignatures(ctx->assembler()->id());
+    if(!state->signatures->size()) return;
+
+    auto& doc = ctx->document();
+    const rd_address* functions = nullptr;
+    size_t c = doc->getFunctions(&functions), n = 0;
+
+    for(size_t i = 0; i < c; i++)
+    {
+        rd_address address = functions[i];
+        if(!state->done.insert(address).second) continue;
+
+        auto label = doc->getLabel(address);
+        if(label && (*label != Document::makeLabel(address, "sub"))) continue; // Keep symbols and user names
+
+        rd_address startaddress = address;
+        RDBufferView fnview, view;
+
+        if(!ctx->disassembler()->getFunctionBytes(startaddress, &fnview) || !doc->getView(address, RD_NVAL, &view)) continue;
+        if(fnview.data != view.data) continue; // Same shape as SignatureAnalyzer::generate()
+
+        ctx->statusAddress("Matching signatures", address);
+        auto mask = SignatureAnalyzer::relocationMask(ctx, address, &view, fnview.size);
+        const char* name = state->signatures->match(&view, mask.data(), fnview.size);
+        if(name && doc->updateLabel(address, name)) n++;
+    }
+
+    if(n) ctx->log("Identified " + std::to_string(n) + " function(s)");
+}
+
+bool SignatureAnalyzer::generate(Context* ctx, const std::string& filepath)
+{
+    if(!ctx->disassembler()) return false;
+
+    SignatureDatabase signatures;
+    signatures.setAssembler(ctx->assembler()->id());
+
+    auto& doc = ctx->document();
+    const rd_address* functions = nullptr;
+    size_t c = doc->getFunctions(&functions);
+
+    for(size_t i = 0; i < c; i++)
+    {
+        rd_address address = functions[i];
+        auto label = doc->getLabel(address);
+        if(!label || (*label == Document::makeLabel(address, "sub"))) continue;
+
+        rd_address startaddress = address;
+        RDBufferView fnview, view;
+
+        if(!ctx->disassembler()->getFunctionBytes(startaddress, &fnview) || !doc->getView(address, RD_NVAL, &view)) continue;
+        if(fnview.data != view.data) continue; // Blocks before the entry point: not a linear prefix
+
+        auto mask = SignatureAnalyzer::relocationMask(ctx, address, &view, fnview.size);
+        signatures.add(view.data, mask.data(), fnview.size, *label);
+    }
+
+    ctx->log("Generated " + std::to_string(signatures.size()) + " signature(s)");
+    if(!signatures.save(filepath)) return false;
+
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    m_signatures.erase(signatures.assembler()); // Reload on next analysis
+    return true;
+}
+
+std::vector<u8> SignatureAnalyzer::relocationMask(Context* ctx, rd_address address, const RDBufferView* view, size_t size)
+{
+    // Bytes that encode addresses change with the link address: they are masked when signatures are generated and matched
+    size = std::min<size_t>(size, view->size);
+    std::vector<u8> mask(size, 0xFF);
+
+    Assembler* assembler = ctx->getAssembler(address);
+    if(!assembler) return mask;
+
+    EmulateResult result(ctx);
+
+    for(size_t offset = 0; offset < size; )
+    {
+        RDBufferView v{ view->data + offset, view->size - offset };
+        result.reset(address + offset, &v);
+        assembler->emulate(&result);
+
+        if(!result.size() || result.invalid() || (result.size() > v.size))
+        {
+            offset++;
+            continue;
+        }
+
+        size_t isize = std::min<size_t>(result.size(), size - offset);
+        rd_address nextaddress = address + offset + result.size();
+
+        for(const auto& [forktype, res] : result.results())
+        {
+            switch(forktype)
+            {
+                case EmulateResult::Branch:
+                case EmulateResult::BranchTrue:
+                case EmulateResult::BranchFalse:
+                case EmulateResult::BranchTable:
+                case EmulateResult::Call:
+                case EmulateResult::CallTable:
+                case EmulateResult::Ref:
+                case EmulateResult::RefData:
+                case EmulateResult::RefString:
+                case EmulateResult::RefType:
+                case EmulateResult::Table:
+                    SignatureDatabase::maskAddress(v.data, mask.data() + offset, isize, res.address, nextaddress, assembler->addressWidth());
+                    break;
+
+                default: break;
+            }
+        }
+
+        offset += result.size();
+    }
+
+    return mask;
+}
+
+SignatureAnalyzer::SignatureDatabasePtr SignatureAnalyzer::loadSignatures(const std::string& assembler)
+{
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    if(auto it = m_signatures.find(assembler); it != m_signatures.end()) return it->second;
+
+    auto signatures = std::make_shared<SignatureDatabase>();
+    signatures->setAssembler(assembler);
+
+    for(const auto& filepath : SignatureAnalyzer::signatureFiles())
+    {
+        if(signatures->load(filepath)) spdlog::info("SignatureAnalyzer::loadSignatures(): Loaded {}", filepath.string());
+        else spdlog::warn("SignatureAnalyzer::loadSignatures(): Skipping {}", filepath.string());
+    }
+
+    m_signatures[assembler] = signatures;
+    return signatures;
+}
+
+std::string SignatureAnalyzer::fingerprint()
+{
+    std::string s;
+
+    for(const auto& filepath : SignatureAnalyzer::signatureFiles())
+    {
+        std::error_code ec; // Same as plugin modules: a rebuilt file changes size or timestamp
+        auto size = fs::file_size(filepath, ec);
+        auto mtime = fs::last_write_time(filepath, ec).time_since_epoch().count();
+        s += filepath.string() + ":" + std::to_string(size) + ":" + std::to_string(mtime) + ";";
+    }
+
+    return s;
+}
+
+std::vector<fs::path> SignatureAnalyzer::signatureFiles()
+{
+    std::vector<fs::path> files;
+
+    for(const auto& searchpath : rd_cfg->databasePaths())
+    {
+        for(const auto& sigpath : { searchpath / SIGNATURE_FOLDER_NAME, searchpath / DATABASE_FOLDER_NAME / SIGNATURE_FOLDER_NAME })
+        {
+            std::error_code ec;
+
+            for(const auto& entry : fs::directory_iterator(sigpath, ec))
+            {
+                if(entry.is_regular_file() && (entry.path().extension() == SIGNATURE_EXT))
+                    files.push_back(entry.path());
+            }
+        }
+    }
+
+    std::sort(files.begin(), files.end()); // Directory order is unspecified
+    return files;
+}
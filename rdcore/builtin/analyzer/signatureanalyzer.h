@@ -0,0 +1,41 @@
+#pragma once
+
+#include <rdapi/types.h>
+#include <rdapi/plugin/analyzer.h>
+#include <unordered_set>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "../../database/signaturedatabase.h"
+
+class Context;
+
+extern RDEntryAnalyzer analyzerEntry_Signature;
+
+class SignatureAnalyzer
+{
+    private:
+        typedef std::shared_ptr<const SignatureDatabase> SignatureDatabasePtr;
+
+        struct State {
+            SignatureDatabasePtr signatures;
+            std::unordered_set<rd_address> done;
+        };
+
+    public:
+        SignatureAnalyzer() = delete;
+        static void analyze(Context* ctx);
+        static bool generate(Context* ctx, const std::string& filepath);
+        static std::string fingerprint(); // Changes when a signature file is added, removed or rebuilt
+
+    private:
+        static std::vector<u8> relocationMask(Context* ctx, rd_address address, const RDBufferView* view, size_t size);
+        static SignatureDatabasePtr loadSignatures(const std::string& assembler);
+        static std::vector<fs::path> signatureFiles();
+
+    private:
+        static std::unordered_map<std::string, SignatureDatabasePtr> m_signatures; // Shared between contexts, by assembler
+        static std::mutex m_mutex;
+};
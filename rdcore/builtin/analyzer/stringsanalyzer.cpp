@@ -3,14 +3,18 @@
 #include "../../disassembler.h"
 #include "../../context.h"
 #include "../../engine/stringfinder.h"
+#include "../../engine/gibberish/gibberishdetector.h"
 #include "../builtin.h"
+#include <string_view>
 #include <algorithm>
+#include <memory>
 #include <deque>
 
 RDEntryAnalyzer analyzerEntry_Strings = RD_BUILTIN_ENTRY(analyzerstring_builtin, "Find All Strings", std::numeric_limits<u32>::max() - 1,
-                                                         "Mark strings in all segments", AnalyzerFlags_RunOnce,
+                                                         "Mark strings in all segments", AnalyzerFlags_RunOnce | AnalyzerFlags_ThreadSafe,
                                                          [](const RDContext*) -> bool { return true; },
-                                                         [](RDContext* ctx) { StringsAnalyzer::analyze(CPTR(Context, ctx)); });
+                                                         [](RDContext* ctx) { StringsAnalyzer::analyze(CPTR(Context, ctx)); },
+                                                         AnalyzerResources_Code | AnalyzerResources_Data, AnalyzerResources_Data | AnalyzerResources_Labels);
 
 void StringsAnalyzer::analyze(Context* ctx)
 {
@@ -35,9 +39,24 @@ void StringsAnalyzer::analyze(Context* ctx)
         }
     }
 
+    StringFinder::Candidates candidates;
+
     std::for_each(pendingblocks.begin(), pendingblocks.end(), [&](const RDBlock& b) {
         RDBufferView view;
         if(!doc->getView(b.address, BlockContainer::size(&b), &view)) return;
-        StringFinder::find(ctx, view);
+        StringFinder::find(ctx, view, candidates);
     });
+
+    // Score every candidate in one pass, texts don't move anymore
+    std::vector<std::string_view> texts;
+    texts.reserve(candidates.items.size());
+
+    for(const auto& item : candidates.items)
+        texts.emplace_back(candidates.texts.data() + item.offset, item.length);
+
+    std::unique_ptr<bool[]> gibberish(new bool[texts.size()]);
+    GibberishDetector::isGibberish(texts.data(), texts.size(), gibberish.get());
+
+    for(size_t i = 0; i < candidates.items.size(); i++)
+        StringFinder::mark(ctx, candidates.items[i], gibberish[i]);
 }
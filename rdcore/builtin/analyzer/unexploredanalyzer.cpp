@@ -12,13 +12,13 @@
 
 RDEntryAnalyzer analyzerEntry_Unexplored = RD_BUILTIN_ENTRY(analyzerunexplored_builtin, "Unexplored Blocks", std::numeric_limits<u32>::max(),
                                                             "Disassemble unexplored blocks", AnalyzerFlags_Experimental,
-                                                            [](const RDContext*) -> bool { UnexploredAnalyzer::clearDone(); return true; },
-                                                            [](RDContext* ctx) { UnexploredAnalyzer::analyze(CPTR(Context, ctx)); });
-
-std::unordered_set<rd_address> UnexploredAnalyzer::m_done;
+                                                            [](const RDContext*) -> bool { return true; },
+                                                            [](RDContext* ctx) { UnexploredAnalyzer::analyze(CPTR(Context, ctx)); },
+                                                            AnalyzerResources_Code | AnalyzerResources_Data, AnalyzerResources_All);
 
 void UnexploredAnalyzer::analyze(Context* ctx)
 {
+    auto& done = ctx->analyzerData<State>()->done;
     auto& doc = ctx->document();
     size_t bits = ctx->assembler()->bits();
     std::deque<RDBlock> pending;
@@ -36,18 +36,18 @@ void UnexploredAnalyzer::analyze(Context* ctx)
 
         for(auto it = blocks->begin(); it != blocks->end(); it++)
         {
-            rd_cfg->status("Searching unexplored blocks @ " + Utils::hex(it->address, bits));
+            ctx->status("Searching unexplored blocks @ " + Utils::hex(it->address, bits));
 
             const RDBlock& block = *it;
-            if(!IS_TYPE(&block, BlockType_Unknown) || m_done.count(block.address)) continue;
+            if(!IS_TYPE(&block, BlockType_Unknown) || done.count(block.address)) continue;
             if(doc->getFlags(block.address) & AddressFlags_Explored) continue;
 
-            m_done.insert(block.address);
+            done.insert(block.address);
             pending.push_back(block);
         }
     }
 
-    if(!pending.empty()) rd_cfg->log("Found " + std::to_string(pending.size()) + " unknown block(s)");
+    if(!pending.empty()) ctx->log("Found " + std::to_string(pending.size()) + " unknown block(s)");
 
     while(!pending.empty())
     {
@@ -56,4 +56,3 @@ void UnexploredAnalyzer::analyze(Context* ctx)
     }
 }
 
-void UnexploredAnalyzer::clearDone() { m_done.clear(); }
@@ -13,9 +13,8 @@ class UnexploredAnalyzer
     public:
         UnexploredAnalyzer() = delete;
         static void analyze(Context* ctx);
-        static void clearDone();
 
     private:
-        static std::unordered_set<rd_address> m_done;
+        struct State { std::unordered_set<rd_address> done; };
 };
 
@@ -2,6 +2,7 @@
 #include "loader/binary.h"
 #include "analyzer/functionanalyzer.h"
 #include "analyzer/stringsanalyzer.h"
+#include "analyzer/signatureanalyzer.h"
 #include "analyzer/unexploredanalyzer.h"
 #include "../plugin/interface/category.h"
 
@@ -14,6 +15,7 @@ Builtins::Builtins()
 
     // Analyzers
     entries.insert({ EntryCategory_Analyzer, BUILTIN_ENTRY(&analyzerEntry_Function) });
+    entries.insert({ EntryCategory_Analyzer, BUILTIN_ENTRY(&analyzerEntry_Signature) });
     entries.insert({ EntryCategory_Analyzer, BUILTIN_ENTRY(&analyzerEntry_Strings) });
     entries.insert({ EntryCategory_Analyzer, BUILTIN_ENTRY(&analyzerEntry_Unexplored) });
 }
@@ -16,66 +16,29 @@ void CallGraph::walk(rd_address address)
 
 CallGraphItem* CallGraph::walkFrom(rd_address address)
 {
-    auto& doc = this->context()->document();
+    s_lock_document doc(this->context()->document()); // Held while walking the net
     auto loc = doc->getFunctionStart(address);
     if(loc.valid) address = loc.address;
 
-    auto* net = doc->net();
+    const auto* net = doc->net();
     auto* nn = net->findNode(address);
-    return nn ? this->cgraph(net, nn) : nullptr;
-}
-
-CallGraphItem* CallGraph::cgraph(DocumentNet* net, const DocumentNetNode* nn, int maxdepth)
-{
-    m_maxdepth = maxdepth;
+    if(!nn) return nullptr;
 
     auto [cgitem, added] = this->pushCallItem(nn);
-    m_queue.push({ nn, cgitem, 0 });
-
-    while(!m_queue.empty())
-    {
-        auto cg = m_queue.front();
-        m_queue.pop();
-        this->cgraph(net, std::get<0>(cg), std::get<1>(cg), std::get<2>(cg));
-    }
-
-    return cgitem;
-}
 
-void CallGraph::cgraph(DocumentNet* net, CallGraphItem* cgitem, rd_address address, int depth)
-{
-    auto* nn = net->findNode(address);
-    if(nn) m_queue.push({ nn, cgitem, depth});
-}
-
-void CallGraph::cgraph(DocumentNet* net, const DocumentNetNode* nn, CallGraphItem* cgitem, int depth)
-{
-    if(depth >= m_maxdepth) return;
+    const rd_address* callees = nullptr;
+    size_t c = doc->getCallees(address, &callees); // Precomputed by Document::setFunctionBounds()
 
-    for(auto* node = nn; node; node = net->nextNode(node))
+    for(size_t i = 0; i < c; i++)
     {
-        for(rd_address branch : node->branchestrue)
-        {
-            if(branch <= node->address) continue; // Ignore loops
-            this->cgraph(net, cgitem, branch, depth);
-        }
+        auto* cnn = net->findNode(callees[i]);
+        if(!cnn) continue;
 
-        for(rd_address branch : node->branchesfalse)
-        {
-            if(branch <= node->address) continue; // Ignore loops
-            this->cgraph(net, cgitem, branch, depth);
-        }
-
-        for(rd_address call : node->calls)
-        {
-            auto* cnn = net->findNode(call);
-            if(!cnn) continue;
-
-            auto [ccgitem, added] = this->pushCallItem(cnn);
-            this->pushEdge(cgitem->node(), ccgitem->node());
-            if(added) m_queue.push({ cnn, ccgitem, depth + 1 });
-        }
+        auto [ccgitem, cadded] = this->pushCallItem(cnn);
+        this->pushEdge(cgitem->node(), ccgitem->node());
     }
+
+    return cgitem;
 }
 
 std::pair<CallGraphItem*, bool> CallGraph::pushCallItem(const DocumentNetNode* nn)
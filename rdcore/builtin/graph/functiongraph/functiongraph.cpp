@@ -4,6 +4,8 @@
 #include "../../../support/utils.h"
 #include "../../../document/document.h"
 #include "../../../context.h"
+#include <rdapi/config.h>
+#include <algorithm>
 #include <stack>
 
 FunctionGraph::FunctionGraph(Context* ctx): StyledGraph(ctx), m_document(ctx->document()) { }
@@ -11,21 +13,17 @@ const FunctionBasicBlock* FunctionGraph::basicBlock(rd_address address) const {
 
 FunctionBasicBlock* FunctionGraph::basicBlock(rd_address address)
 {
-    auto it = m_basicblocks.lower_bound(address);
+    auto it = std::upper_bound(m_basicblocks.begin(), m_basicblocks.end(), address, [](rd_address a, const FunctionBasicBlock& fbb) {
+        return a < fbb.startaddress;
+    });
 
-    if(it == m_basicblocks.end())
+    while(it != m_basicblocks.begin())
     {
-        if(m_basicblocks.size() == 1) it = m_basicblocks.begin();
-        else return nullptr;
-    }
-
-    while(!it->second.contains(address))
-    {
-        if(it == m_basicblocks.begin()) return nullptr;
         it--;
+        if(it->contains(address)) return std::addressof(*it);
     }
 
-    return std::addressof(it->second);
+    return nullptr;
 }
 
 const FunctionGraph::BasicBlocks& FunctionGraph::basicBlocks() const { return m_basicblocks; }
@@ -41,7 +39,7 @@ size_t FunctionGraph::blocksCount() const
 {
     if(m_blockscount) return m_blockscount;
 
-    for(const auto& [_, fbb] : m_basicblocks)
+    for(const auto& fbb : m_basicblocks)
     {
         RDBlock startb, endb;
         if(!m_document->addressToBlock(fbb.startaddress, &startb)) REDasmError("Cannot find start block", fbb.startaddress);
@@ -63,7 +61,7 @@ size_t FunctionGraph::bytesCount() const
 {
     if(m_bytescount) return m_bytescount;
 
-    for(const auto& [_, fbb] : m_basicblocks)
+    for(const auto& fbb : m_basicblocks)
     {
         RDBlock startb, endb;
         if(!m_document->addressToBlock(fbb.startaddress, &startb)) REDasmError("Cannot find start block", fbb.startaddress);
@@ -85,6 +83,7 @@ bool FunctionGraph::contains(rd_address address) const { return this->basicBlock
 bool FunctionGraph::build(rd_address address)
 {
     m_blockscount = m_bytescount = 0;
+    s_lock_document lock(m_document); // The net and the blocks must not change while they are walked
 
     if(!m_document->addressToBlock(address, &m_graphstart))
     {
@@ -120,6 +119,16 @@ bool FunctionGraph::build(rd_address address)
 
 bool FunctionGraph::complete() const { return m_complete; }
 
+rd_type FunctionGraph::theme(RDGraphNode source, RDGraphNode target) const
+{
+    auto it = std::lower_bound(m_themes.begin(), m_themes.end(), std::make_pair(source, target), [](const EdgeTheme& et, const auto& e) {
+        return std::tie(et.source, et.target) < std::tie(e.first, e.second);
+    });
+
+    if((it != m_themes.end()) && (it->source == source) && (it->target == target)) return it->theme;
+    return Theme_GraphEdge;
+}
+
 std::string FunctionGraph::nodeLabel(RDGraphNode n) const
 {
     auto* fbb = reinterpret_cast<FunctionBasicBlock*>(this->data(n)->p_data);
@@ -127,16 +136,15 @@ std::string FunctionGraph::nodeLabel(RDGraphNode n) const
     return Graph::nodeLabel(n);
 }
 
-FunctionBasicBlock* FunctionGraph::createBasicBlock(rd_address startaddress)
+size_t FunctionGraph::createBasicBlock(rd_address startaddress)
 {
-    auto [it, _] = m_basicblocks.emplace(startaddress, FunctionBasicBlock(m_document, this->pushNode(), startaddress));
-    this->setData(it->second.node, std::addressof(it->second));
-    return std::addressof(it->second);
+    m_basicblocks.emplace_back(this, this->pushNode(), startaddress);
+    return m_basicblocks.size() - 1;
 }
 
-void FunctionGraph::buildBasicBlocks(FunctionGraph::BasicBlocksPtrs& basicblocks)
+void FunctionGraph::buildBasicBlocks(FunctionGraph::BasicBlocksIndex& basicblocks)
 {
-    const DocumentNet* net = this->context()->net();
+    const DocumentNet* net = m_document->net();
     std::stack<rd_address> pending;
     pending.push(m_graphstart.address);
 
@@ -175,12 +183,13 @@ void FunctionGraph::buildBasicBlocks(FunctionGraph::BasicBlocksPtrs& basicblocks
 
 void FunctionGraph::buildBasicBlocks()
 {
-    const DocumentNet* net = this->context()->net();
-    BasicBlocksPtrs basicblocks;
+    const DocumentNet* net = m_document->net();
+    BasicBlocksIndex basicblocks;
     this->buildBasicBlocks(basicblocks);
 
-    for(auto& [bbaddress, basicblock] : basicblocks)
+    for(auto& [bbaddress, bbindex] : basicblocks)
     {
+        FunctionBasicBlock* basicblock = std::addressof(m_basicblocks[bbindex]);
         rd_address address = bbaddress;
         auto* link = net->findNode(address);
 
@@ -200,8 +209,9 @@ void FunctionGraph::buildBasicBlocks()
                 it = basicblocks.find(jmpaddress);
                 if(it == basicblocks.end()) continue;
 
-                this->pushEdge(basicblock->node, it->second->node);
-                basicblock->bTrue(it->second->node);
+                const FunctionBasicBlock& target = m_basicblocks[it->second];
+                this->pushEdge(basicblock->node, target.node);
+                m_themes.push_back({ basicblock->node, target.node, Theme_Success });
             }
 
             for(rd_address jmpaddress : link->branchesfalse)
@@ -209,15 +219,16 @@ void FunctionGraph::buildBasicBlocks()
                 it = basicblocks.find(jmpaddress);
                 if(it == basicblocks.end()) continue;
 
-                this->pushEdge(basicblock->node, it->second->node);
-                basicblock->bFalse(it->second->node);
+                const FunctionBasicBlock& target = m_basicblocks[it->second];
+                this->pushEdge(basicblock->node, target.node);
+                m_themes.push_back({ basicblock->node, target.node, Theme_Fail });
             }
 
             it = basicblocks.find(link->next);
 
             if(it != basicblocks.end()) // Connect the block only
             {
-                this->pushEdge(basicblock->node, it->second->node);
+                this->pushEdge(basicblock->node, m_basicblocks[it->second].node);
                 break;
             }
 
@@ -225,4 +236,28 @@ void FunctionGraph::buildBasicBlocks()
             link = net->findNode(address);
         }
     }
+
+    this->compact();
+}
+
+void FunctionGraph::compact()
+{
+    std::sort(m_basicblocks.begin(), m_basicblocks.end(), [](const FunctionBasicBlock& fbb1, const FunctionBasicBlock& fbb2) {
+        return fbb1.startaddress < fbb2.startaddress;
+    });
+
+    m_basicblocks.shrink_to_fit();
+    for(FunctionBasicBlock& fbb : m_basicblocks) this->setData(fbb.node, std::addressof(fbb)); // Addresses are stable from now on
+
+    // The last theme assigned to an edge wins
+    std::stable_sort(m_themes.begin(), m_themes.end(), [](const EdgeTheme& et1, const EdgeTheme& et2) {
+        return std::tie(et1.source, et1.target) < std::tie(et2.source, et2.target);
+    });
+
+    auto last = std::unique(m_themes.rbegin(), m_themes.rend(), [](const EdgeTheme& et1, const EdgeTheme& et2) {
+        return std::tie(et1.source, et1.target) == std::tie(et2.source, et2.target);
+    });
+
+    m_themes.erase(m_themes.begin(), last.base());
+    m_themes.shrink_to_fit();
 }
@@ -1,15 +1,18 @@
 #pragma once
 
 #include <string>
+#include <vector>
 #include <map>
+#include "../../../document/document_fwd.h"
 #include "../../../document/documentnet.h"
 #include "functionbasicblock.h"
 
 class FunctionGraph: public StyledGraph
 {
     private:
-        typedef std::map<rd_address, FunctionBasicBlock*> BasicBlocksPtrs;
-        typedef std::map<rd_address, FunctionBasicBlock> BasicBlocks;
+        typedef std::map<rd_address, size_t> BasicBlocksIndex;
+        typedef std::vector<FunctionBasicBlock> BasicBlocks; // Sorted by start address once built
+        struct EdgeTheme { RDGraphNode source, target; rd_type theme; };
 
     public:
         FunctionGraph(Context* ctx);
@@ -23,20 +26,23 @@ class FunctionGraph: public StyledGraph
         bool contains(rd_address address) const;
         bool build(rd_address address);
         bool complete() const;
+        rd_type theme(RDGraphNode source, RDGraphNode target) const;
 
     protected:
         std::string nodeLabel(RDGraphNode n) const override;
 
     private:
-        FunctionBasicBlock* createBasicBlock(rd_address startaddress);
-        void buildBasicBlocks(BasicBlocksPtrs& basicblocks);
+        size_t createBasicBlock(rd_address startaddress);
+        void buildBasicBlocks(BasicBlocksIndex& basicblocks);
         void buildBasicBlocks();
+        void compact();
 
     private:
         mutable size_t m_bytescount{0}, m_blockscount{0};
         mutable RDBlock m_graphend{ };
         BasicBlocks m_basicblocks;
-        SafeDocument& m_document;
+        std::vector<EdgeTheme> m_themes; // Only non default edges, sorted by (source, target)
+        const SafeDocument& m_document; // Read only: builds can run under a shared lock
         RDBlock m_graphstart{ };
         bool m_complete{true};
 };
@@ -1,6 +1,7 @@
 #include "rdilgraph.h"
 #include "../../../document/document.h"
 #include "../../../disassembler.h"
+#include "../../../rdil/ilcache.h"
 #include "../../../rdil/rdil.h"
 #include "../../../context.h"
 #include <queue>
@@ -9,9 +10,20 @@ RDILGraph::RDILGraph(Context* ctx): StyledGraph(ctx) { }
 
 void RDILGraph::build(rd_address address)
 {
-    const auto* net = this->context()->net();
-    auto* node = net->findNode(address);
-    if(!node) return;
+    RDLocation loc = this->context()->document()->getFunctionStart(address);
+    ILCache::ILFunctionPtr cachedil;
+    if(loc.valid && (loc.address == address)) cachedil = this->context()->ilCache()->function(address);
+    const ILExpression* e = cachedil ? cachedil->expressionAt(address) : nullptr;
+
+    if(e)
+    {
+        m_strings.clear();
+        this->setRoot(this->generate(e, RD_NVAL));
+        return;
+    }
+
+    const SafeDocument& doc = this->context()->document();
+    if(!doc->net()->findNode(address)) return;
 
     RDBlock block;
 
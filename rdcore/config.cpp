@@ -165,8 +165,17 @@ const char* Config::theme(rd_type theme) const
     return nullptr;
 }
 
-void Config::statusProgress(const char* s, size_t progress) const
+void Config::statusProgress(const char* s, size_t progress, const LogRoute* route) const
 {
+    if((route = Config::route(route)) && (route->statuscallback.callback || route->progresscallback.callback))
+    {
+        log_lock lock(route->mutex);
+        if(progress && !this->debounce(route->laststatusreport)) return;
+        if(route->statuscallback.callback) route->statuscallback(s);
+        if(route->progresscallback.callback) route->progresscallback(progress);
+        return;
+    }
+
     log_lock lock(m_mutex);
 
     if(progress) {
@@ -177,8 +186,19 @@ void Config::statusProgress(const char* s, size_t progress) const
     m_progresscallback(progress);
 }
 
-void Config::statusAddress(const char* s, rd_address address) const
+void Config::statusAddress(const char* s, rd_address address, const LogRoute* route) const
 {
+    if((route = Config::route(route)) && route->statuscallback.callback)
+    {
+        log_lock lock(route->mutex);
+        if(!this->debounce(route->laststatusreport)) return;
+
+        std::stringstream ss;
+        ss << s << " @ " << Utils::hex(address);
+        route->statuscallback(ss.str().c_str());
+        return;
+    }
+
     log_lock lock(m_mutex);
     CONTEXT_DEBOUNCE_CHECK
 
@@ -187,20 +207,48 @@ void Config::statusAddress(const char* s, rd_address address) const
     m_statuscallback(ss.str().c_str());
 }
 
-void Config::status(const char* s) const
+void Config::status(const char* s, const LogRoute* route) const
 {
+    if((route = Config::route(route)) && route->statuscallback.callback)
+    {
+        log_lock lock(route->mutex);
+        if(this->debounce(route->laststatusreport)) route->statuscallback(s);
+        return;
+    }
+
     log_lock lock(m_mutex);
     CONTEXT_DEBOUNCE_CHECK
     m_statuscallback(s);
 }
 
-void Config::log(const char* s) const
+void Config::log(const char* s, const LogRoute* route) const
 {
+    if((route = Config::route(route)) && route->logcallback.callback)
+    {
+        log_lock lock(route->mutex);
+        route->logcallback(s); // Routed logs are never dropped
+        return;
+    }
+
     log_lock lock(m_mutex);
     CONTEXT_DEBOUNCE_CHECK
     m_logcallback(s);
 }
 
+static thread_local const LogRoute* g_threadroute = nullptr;
+
+void Config::setThreadRoute(const LogRoute* route) { g_threadroute = route; }
+const LogRoute* Config::threadRoute() { return g_threadroute; }
+const LogRoute* Config::route(const LogRoute* route) { return route ? route : g_threadroute; }
+
+bool Config::debounce(std::chrono::steady_clock::time_point& lastreport) const
+{
+    auto now = std::chrono::steady_clock::now();
+    if((now - lastreport) < m_debouncetimeout) return false;
+    lastreport = now;
+    return true;
+}
+
 void Config::getDatabasePaths(RD_PathCallback callback, void* userdata) const { for(const auto& dbpath : m_dbpaths) callback(dbpath.string().c_str(), userdata); }
 void Config::getPluginPaths(RD_PathCallback callback, void* userdata) const { for(const auto& pluginpath : m_pluginpaths) callback(pluginpath.string().c_str(), userdata); }
 const CallbackStruct<RD_ProgressCallback>& Config::progressCallback() const { return m_progresscallback; }
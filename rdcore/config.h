@@ -24,6 +24,15 @@ struct CallbackStruct
     template<typename Args> void operator()(Args&& args) const { callback(std::forward<Args>(args), userdata); }
 };
 
+struct LogRoute // Per context callbacks, the ones not set fall back to Config's
+{
+    CallbackStruct<RD_LogCallback> logcallback;
+    CallbackStruct<RD_StatusCallback> statuscallback;
+    CallbackStruct<RD_ProgressCallback> progresscallback;
+    mutable std::chrono::steady_clock::time_point laststatusreport;
+    mutable std::mutex mutex;
+};
+
 struct ThemeColors
 {
     std::string fg{"#000000"}, bg{"#ffffff"}, seek;
@@ -71,15 +80,21 @@ class Config
         const char* theme(rd_type theme) const;
 
     public:
-        void statusProgress(const char* s, size_t progress) const;
-        void statusAddress(const char* s, rd_address address) const;
-        void status(const char* s) const;
-        void log(const char* s) const;
-        inline void status(const std::string& s) const { this->status(static_cast<const char*>(s.c_str())); }
-        inline void log(const std::string& s) const { this->log(s.c_str()); }
+        void statusProgress(const char* s, size_t progress, const LogRoute* route = nullptr) const;
+        void statusAddress(const char* s, rd_address address, const LogRoute* route = nullptr) const;
+        void status(const char* s, const LogRoute* route = nullptr) const;
+        void log(const char* s, const LogRoute* route = nullptr) const;
+        inline void status(const std::string& s, const LogRoute* route = nullptr) const { this->status(static_cast<const char*>(s.c_str()), route); }
+        inline void log(const std::string& s, const LogRoute* route = nullptr) const { this->log(s.c_str(), route); }
+
+    public:
+        static void setThreadRoute(const LogRoute* route); // Default route for this thread (plugins, rd_cfg calls)
+        static const LogRoute* threadRoute();
 
     private:
         static const char* themeAlt(const std::string& color, const std::string& altcolor);
+        static const LogRoute* route(const LogRoute* route);
+        bool debounce(std::chrono::steady_clock::time_point& lastreport) const;
 
     private:
         UniqueContainer<fs::path> m_pluginpaths, m_dbpaths;
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <unordered_map>
+#include <functional>
+#include <list>
+
+template<typename K, typename V, typename Hash = std::hash<K>>
+class LRUContainer // Bounded map, inserting past capacity evicts the least recently used item
+{
+    private:
+        typedef std::pair<K, V> Item;
+        typedef std::list<Item> ItemList;
+
+    public:
+        typedef std::function<void(const K&, V&)> EvictedCallback;
+
+    public:
+        LRUContainer(size_t capacity, const EvictedCallback& evictedcb = nullptr): m_capacity(capacity), m_evictedcb(evictedcb) { }
+        size_t size() const { return m_index.size(); }
+        size_t capacity() const { return m_capacity; }
+        bool empty() const { return m_index.empty(); }
+        void clear() { m_index.clear(); m_items.clear(); }
+
+        V* find(const K& k) {
+            auto it = m_index.find(k);
+            if(it == m_index.end()) return nullptr;
+            m_items.splice(m_items.begin(), m_items, it->second); // Most recent at front
+            return std::addressof(it->second->second);
+        }
+
+        V* insert(const K& k, V v) {
+            auto it = m_index.find(k);
+
+            if(it != m_index.end()) {
+                it->second->second = std::move(v);
+                m_items.splice(m_items.begin(), m_items, it->second);
+                return std::addressof(it->second->second);
+            }
+
+            while(!m_items.empty() && (m_items.size() >= m_capacity)) {
+                if(m_evictedcb) m_evictedcb(m_items.back().first, m_items.back().second);
+                m_index.erase(m_items.back().first);
+                m_items.pop_back();
+            }
+
+            m_items.emplace_front(k, std::move(v));
+            m_index[k] = m_items.begin();
+            return std::addressof(m_items.front().second);
+        }
+
+        void evictAll() {
+            while(!m_items.empty()) {
+                if(m_evictedcb) m_evictedcb(m_items.back().first, m_items.back().second);
+                m_index.erase(m_items.back().first);
+                m_items.pop_back();
+            }
+        }
+
+        bool remove(const K& k) {
+            auto it = m_index.find(k);
+            if(it == m_index.end()) return false;
+            m_items.erase(it->second);
+            m_index.erase(it);
+            return true;
+        }
+
+        template<typename Predicate> size_t removeIf(const Predicate& pred) { // Not an eviction, the callback is skipped
+            size_t c = 0;
+
+            for(auto it = m_items.begin(); it != m_items.end(); ) {
+                if(!pred(it->first, it->second)) { it++; continue; }
+                m_index.erase(it->first);
+                it = m_items.erase(it);
+                c++;
+            }
+
+            return c;
+        }
+
+    private:
+        size_t m_capacity;
+        EvictedCallback m_evictedcb;
+        ItemList m_items;
+        std::unordered_map<K, typename ItemList::iterator, Hash> m_index;
+};
@@ -4,24 +4,30 @@
 #include "plugin/analyzer.h"
 #include "plugin/loader.h"
 #include "plugin/interface/pluginmanager.h"
+#include "plugin/interface/category.h"
 #include "builtin/analyzer/unexploredanalyzer.h"
 #include "builtin/analyzer/functionanalyzer.h"
 #include "builtin/analyzer/stringsanalyzer.h"
+#include "builtin/analyzer/signatureanalyzer.h"
 #include "builtin/loader/binary.h"
 #include "document/document.h"
 #include "database/addressdatabase.h"
 #include "database/database.h"
+#include "surface/instructioncache.h"
+#include "rdil/ilcache.h"
 #include "disassembler.h"
 
 #define INSTRUCTION_START_COL 16
 
-Context::Context(): Object(this)
+Context::Context(const Context* runtime): Object(this)
 {
     m_surfacestate.instrstartcol = INSTRUCTION_START_COL;
 
-    m_pluginmanager = std::make_unique<PluginManager>(this);
+    m_pluginmanager = std::make_unique<PluginManager>(this, runtime ? runtime->pluginManager() : nullptr);
     m_addrdatabase = std::make_unique<AddressDatabase>(this);
     m_database = std::make_unique<Database>(this);
+    m_instructioncache = std::make_unique<InstructionCache>(this);
+    m_ilcache = std::make_unique<ILCache>(this);
     m_database->setName("Active Database");
 
     spdlog::info("*** Context::Context() ***");
@@ -34,9 +40,12 @@ Context::~Context()
 }
 
 Database* Context::database() const { return m_database.get(); }
+PluginManager* Context::pluginManager() const { return m_pluginmanager.get(); }
 AddressDatabase* Context::addressDatabase() const { return m_addrdatabase.get(); }
 const Context::SurfaceState& Context::surfaceState() const { return m_surfacestate; }
 Context::SurfaceState& Context::surfaceState() { return m_surfacestate; }
+InstructionCache* Context::instructionCache() const { return m_instructioncache.get(); }
+ILCache* Context::ilCache() const { return m_ilcache.get(); }
 bool Context::disassembling() const { return m_disassembler ? m_disassembler->disassembling() : false; }
 bool Context::busy() const { return m_disassembler ? m_disassembler->busy() : false; }
 size_t Context::bits() const { return m_disassembler ? m_disassembler->assembler()->bits() : CHAR_BIT; }
@@ -57,6 +66,25 @@ bool Context::matchAssembler(const std::string& q) const
 }
 
 const Context::AnalyzerList& Context::selectedAnalyzers() const { return m_selectedanalyzers; }
+const LogRoute* Context::logRoute() const { return &m_logroute; }
+
+void Context::setLogCallback(RD_LogCallback callback, void* userdata)
+{
+    m_logroute.logcallback.callback = callback;
+    m_logroute.logcallback.userdata = userdata;
+}
+
+void Context::setStatusCallback(RD_StatusCallback callback, void* userdata)
+{
+    m_logroute.statuscallback.callback = callback;
+    m_logroute.statuscallback.userdata = userdata;
+}
+
+void Context::setProgressCallback(RD_ProgressCallback callback, void* userdata)
+{
+    m_logroute.progresscallback.callback = callback;
+    m_logroute.progresscallback.userdata = userdata;
+}
 bool Context::executeCommand(const char* cmd, const RDArguments* a) const { return cmd ? m_pluginmanager->executeCommand(cmd, a) : false; }
 bool Context::isWeak() const { return m_disassembler ? m_disassembler->isWeak() : false; }
 void Context::disassembleBlock(const RDBlock* block) { if(m_disassembler) m_disassembler->disassembleBlock(block); }
@@ -122,7 +150,7 @@ void Context::findLoaderEntries(const RDLoaderRequest* req, Callback_LoaderEntry
         const char* assemblerid = Loader::test(entryloader, req);
         if(!assemblerid) continue;
 
-        if(!std::string(assemblerid).empty() && !m_pluginmanager->findAssembler(assemblerid))
+        if(!std::string(assemblerid).empty() && !m_pluginmanager->hasEntry(EntryCategory_Assembler, assemblerid))
         {
             this->log("Invalid assembler id: " + Utils::quoted(assemblerid));
             continue;
@@ -156,7 +184,8 @@ const RDEntryAssembler* Context::findAssemblerEntry(const RDEntryLoader* entrylo
     auto it = m_proposedassembler.find(entryloader->id);
     if(it == m_proposedassembler.end()) return nullptr;
     if(res) *res = it->second;
-    return m_pluginmanager->findAssembler(it->second);
+    if(!m_pluginmanager->hasEntry(EntryCategory_Assembler, it->second)) return nullptr;
+    return m_pluginmanager->getAssembler(it->second); // Loaded on demand
 }
 
 bool Context::bind(const RDLoaderRequest* req, const RDEntryLoader* entryloader, const RDEntryAssembler* entryassembler)
@@ -199,8 +228,14 @@ bool Context::bind(const RDLoaderRequest* req, const RDEntryLoader* entryloader,
 
             return false;
         }
+    }
+
+    entryassembler = m_pluginmanager->selectAssembler(entryassembler->id); // Listed entries can come from the manifest, not loaded yet
 
-        entryassembler = m_pluginmanager->selectAssembler(entryassembler->id);
+    if(!entryassembler)
+    {
+        this->log("Cannot load assembler for " + Utils::quoted(entryloader->id));
+        return false;
     }
 
     const RDEntryLoader* loaderentry = m_pluginmanager->selectLoader(entryloader->id);
@@ -241,6 +276,7 @@ Assembler* Context::getAssembler(const std::string& id) const
 {
     if(m_disassembler->assembler()->id() == id) return m_disassembler->assembler();
 
+    std::scoped_lock<std::mutex> lock(m_assemblersmutex);
     auto it = m_assemblers.find(id);
     if(it != m_assemblers.end()) return it->second.get();
 
@@ -251,8 +287,6 @@ Assembler* Context::getAssembler(const std::string& id) const
     return iit.first->second.get();
 }
 
-const DocumentNet* Context::net() const { return m_disassembler ? m_disassembler->document()->net() : nullptr; }
-DocumentNet* Context::net() { return m_disassembler ? m_disassembler->document()->net() : nullptr; }
 Disassembler* Context::disassembler() const { return m_disassembler.get(); }
 Assembler* Context::assembler() const { return m_disassembler ? m_disassembler->assembler() : nullptr; }
 Loader* Context::loader() const { return m_disassembler ? m_disassembler->loader() : nullptr; }
@@ -260,6 +294,13 @@ MemoryBuffer* Context::buffer() const { return m_disassembler ? m_disassembler->
 void Context::setWeak(bool b) { if(m_disassembler) m_disassembler->setWeak(b); }
 void Context::disassembleAt(rd_address address) { if(m_disassembler) m_disassembler->disassembleAt(address); }
 void Context::disassemble() { if(m_disassembler) m_disassembler->disassemble(); }
+void Context::disassembleAsync() { if(m_disassembler) m_disassembler->disassembleAsync(); }
+bool Context::exportSignatures(const std::string& filepath) { return SignatureAnalyzer::generate(this, filepath); }
+void Context::setPaused(bool b) { if(m_disassembler) m_disassembler->setPaused(b); }
+bool Context::paused() const { return m_disassembler ? m_disassembler->paused() : false; }
+bool Context::analysisStatus(RDAnalysisStatus* status) const { return m_disassembler ? m_disassembler->analysisStatus(status) : false; }
+void Context::wait() { if(m_disassembler) m_disassembler->wait(); }
+void Context::stop() { if(m_disassembler) m_disassembler->stop(); }
 Surface* Context::activeSurface() const { return m_activesurface; }
 
 void Context::setActiveSurface(Surface* sf)
@@ -3,8 +3,10 @@
 #define DEFAULT_MIN_STRING 4
 
 #include <unordered_set>
+#include <typeindex>
 #include <memory>
 #include <string>
+#include <mutex>
 #include <rdapi/context.h>
 #include <rdapi/plugin/loader.h>
 #include <rdapi/plugin/analyzer.h>
@@ -15,6 +17,7 @@
 #include "document/document_fwd.h"
 #include "database/database.h"
 #include "object.h"
+#include "config.h"
 
 class AddressDatabase;
 class Disassembler;
@@ -23,6 +26,8 @@ class Analyzer;
 class Assembler;
 class Loader;
 class MemoryBuffer;
+class InstructionCache;
+class ILCache;
 class Surface;
 
 typedef std::shared_ptr<Analyzer> AnalyzerPtr;
@@ -43,12 +48,15 @@ class Context: public Object
         typedef std::unordered_map<std::string, RDEntry*> PluginMap;
 
     public:
-        Context();
+        explicit Context(const Context* runtime = nullptr);
         ~Context();
         Database* database() const;
+        PluginManager* pluginManager() const;
         AddressDatabase* addressDatabase() const;
         const SurfaceState& surfaceState() const;
         SurfaceState& surfaceState();
+        InstructionCache* instructionCache() const;
+        ILCache* ilCache() const;
         bool disassembling() const;
         bool busy() const;
         size_t bits() const;
@@ -65,6 +73,12 @@ class Context: public Object
         void setMinString(size_t s);
         size_t minString() const;
 
+    public: // Logging
+        void setLogCallback(RD_LogCallback callback, void* userdata);
+        void setStatusCallback(RD_StatusCallback callback, void* userdata);
+        void setProgressCallback(RD_ProgressCallback callback, void* userdata);
+        const LogRoute* logRoute() const;
+
     public: // Document
         RDLocation functionStart(rd_address address) const;
 
@@ -86,13 +100,12 @@ class Context: public Object
         void selectAnalyzer(const Analyzer* panalyzer, bool select);
         bool isAnalyzerSelected(const Analyzer* panalyzer) const;
         const AnalyzerList& selectedAnalyzers() const;
+        template<typename T> T* analyzerData() const;
 
     public: // Command
         bool executeCommand(const char* cmd, const RDArguments* a) const;
 
     public: // Disassembler
-        const DocumentNet* net() const;
-        DocumentNet* net();
         bool bind(const RDLoaderRequest* req, const RDEntryLoader* entryloader, const RDEntryAssembler* entryassembler);
         Disassembler* disassembler() const;
         MemoryBuffer* buffer() const;
@@ -101,6 +114,13 @@ class Context: public Object
         void disassembleBlock(const RDBlock* block);
         void disassembleAt(rd_address address);
         void disassemble();
+        void disassembleAsync();
+        bool exportSignatures(const std::string& filepath);
+        void setPaused(bool b);
+        bool paused() const;
+        bool analysisStatus(RDAnalysisStatus* status) const;
+        void wait();
+        void stop();
 
     public:
         Surface* activeSurface() const;
@@ -122,6 +142,7 @@ class Context: public Object
 
     private:
         mutable std::unordered_map<std::string, std::unique_ptr<Assembler>> m_assemblers;
+        mutable std::mutex m_assemblersmutex; // Renderers can run concurrently
         std::unordered_map<std::string, std::string> m_proposedassembler; // LoaderID -> AssemblerID
         std::unordered_map<std::string, uintptr_t> m_userdata;
         std::shared_ptr<MemoryBuffer> m_buffer;
@@ -133,6 +154,8 @@ class Context: public Object
         std::unique_ptr<AddressDatabase> m_addrdatabase;
         std::pair<rd_type, rd_type> m_compilerabi{CompilerABI_Unknown, CompilerCC_Unknown};
         SurfaceState m_surfacestate;
+        std::unique_ptr<InstructionCache> m_instructioncache;
+        std::unique_ptr<ILCache> m_ilcache;
         Surface* m_activesurface{nullptr};
         rd_flag m_flags{ContextFlags_None};
         PluginMap m_commands;
@@ -142,8 +165,21 @@ class Context: public Object
         UniqueContainer<std::string> m_problems;
         size_t m_minstring{DEFAULT_MIN_STRING};
         bool m_ignoreproblems{false};
+        LogRoute m_logroute;
+
+    private:
+        mutable std::unordered_map<std::type_index, std::shared_ptr<void>> m_analyzerdata; // Builtin analyzers' state
+        mutable std::mutex m_analyzerdatamutex;
 };
 
+template<typename T>
+T* Context::analyzerData() const {
+    std::scoped_lock<std::mutex> lock(m_analyzerdatamutex);
+    auto& data = m_analyzerdata[std::type_index(typeid(T))];
+    if(!data) data = std::make_shared<T>();
+    return static_cast<T*>(data.get());
+}
+
 class WeakScope
 {
     public:
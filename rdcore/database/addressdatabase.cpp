@@ -2,6 +2,7 @@
 #include "../support/demangler.h"
 #include "../support/utils.h"
 #include "../document/document.h"
+#include "../surface/instructioncache.h"
 #include "../context.h"
 
 AddressDatabase::AddressDatabase(Context* context): Object(context) { }
@@ -31,9 +32,13 @@ void AddressDatabase::setLabel(rd_address address, const std::string& label, rd_
     auto e = this->getEntry(address);
     if(!e->weak && this->context()->isWeak()) return;
 
+    std::string newlabel = Demangler::demangled(label);
+    bool changed = (e->label != newlabel) || ((e->flags & flags) != flags);
+
     e->weak = this->context()->isWeak();
-    e->label = Demangler::demangled(label);
+    e->label = std::move(newlabel);
     e->flags |= flags;
+    if(changed) this->labelChanged(address);
 
     m_labels[e->label] = address;
     if(!flags) return;
@@ -64,11 +69,13 @@ bool AddressDatabase::updateLabel(rd_address address, const std::string& label)
     e->label = label;
     m_labels.erase(e->label);
     m_labels[label] = address;
+    this->labelChanged(address);
 
     spdlog::info("AddressDatabase::updateLabel({:x}, '{}')", address, label);
     return true;
 }
 
+size_t AddressDatabase::labelsRevision() const { return m_labelsrevision; }
 bool AddressDatabase::findLabel(const std::string& q, rd_address* resaddress) const { return this->findLabelR(Utils::wildcardToRegex(q), resaddress); }
 
 bool AddressDatabase::findLabelR(const std::string& q, rd_address* resaddress) const
@@ -87,14 +94,17 @@ size_t AddressDatabase::findLabels(const std::string& q, const rd_address** resa
 
 size_t AddressDatabase::findLabelsR(const std::string& q, const rd_address** resaddresses) const
 {
+    static thread_local std::vector<rd_address> result; // Per thread, const readers can run concurrently
+    result.clear();
+
     for(const auto& [label, addr] : m_labels)
     {
         if(!Utils::matchRegex(label, q)) continue;
-        m_result.push_back(addr);
+        result.push_back(addr);
     }
 
-    if(resaddresses) *resaddresses = m_result.data();
-    return m_result.size();
+    if(resaddresses) *resaddresses = result.data();
+    return result.size();
 }
 
 bool AddressDatabase::isWeak(rd_address address) const
@@ -122,7 +132,12 @@ std::optional<std::string> AddressDatabase::indexToAssembler(size_t index) const
 {
     if(!index)
     {
-        if(this->context()->disassembling() && m_lastassembler) return m_lastassembler;
+        if(this->context()->disassembling())
+        {
+            std::scoped_lock<std::mutex> lock(m_lastmutex);
+            if(m_lastassembler) return m_lastassembler;
+        }
+
         return this->indexToAssembler(1);
     }
 
@@ -130,6 +145,7 @@ std::optional<std::string> AddressDatabase::indexToAssembler(size_t index) const
 
     if(this->context()->disassembling())
     {
+        std::scoped_lock<std::mutex> lock(m_lastmutex);
         m_lastassembler = m_assemblers.at(index);
         return m_lastassembler;
     }
@@ -154,34 +170,38 @@ void AddressDatabase::updateFlags(rd_address address, rd_flag flags, bool set)
     auto* e = m_entries.find(address);
     if(!e) return;
 
-    if(set) e->flags |= flags;
-    else e->flags &= ~flags;
+    rd_flag newflags = set ? (e->flags | flags) : (e->flags & ~flags);
+    if(newflags == e->flags) return;
+
+    e->flags = newflags;
+    this->labelChanged(address);
 }
 
-bool AddressDatabase::setTypeField(rd_address address, const Type* type, int indent, const std::string& name)
+bool AddressDatabase::setTypeField(rd_address address, const std::shared_ptr<const Type>& type, int indent, const std::string& name)
 {
     if(!type) return false;
 
     auto* e = this->getEntry(address);
-    e->typefield.reset(type->clone(this->context()));
+    e->typefield = type;
     e->label = name;
     e->indent = indent;
     e->flags |= AddressFlags_TypeField;
+    this->labelChanged(address);
 
     return true;
 }
 
-void AddressDatabase::setType(rd_address address, const Type* type, const std::string& label)
+void AddressDatabase::setType(rd_address address, const std::shared_ptr<const Type>& type, const std::string& label)
 {
     if(!type) return;
 
     auto* e = this->getEntry(address);
-    e->type.reset(type->clone(this->context()));
-    if(!label.empty()) e->type->setName(label);
-    e->label = e->type->name();
+    e->type = type;
+    e->label = label.empty() ? type->name() : label;
     e->flags |= AddressFlags_Type;
 
     m_labels[e->label] = address;
+    this->labelChanged(address);
 }
 
 const Type* AddressDatabase::getTypeField(rd_address address, int* indent) const
@@ -224,3 +244,9 @@ AddressDatabase::Entry* AddressDatabase::getEntry(rd_address address)
     m_entries.insert(address, Entry{ });
     return m_entries.find(address);
 }
+
+void AddressDatabase::labelChanged(rd_address address)
+{
+    m_labelsrevision++;
+    if(auto* cache = this->context()->instructionCache(); cache) cache->invalidate(address);
+}
@@ -4,6 +4,8 @@
 #include <unordered_map>
 #include <vector>
 #include <memory>
+#include <mutex>
+#include <atomic>
 #include <rdapi/document/block.h>
 #include "../containers/addresscontainer.h"
 #include "../containers/uniquecontainer.h"
@@ -20,7 +22,7 @@ class AddressDatabase: public Object
             bool weak{true};
             u8 indent{0};
             std::string label;
-            std::shared_ptr<Type> type, typefield;
+            std::shared_ptr<const Type> type, typefield; // Shared, never modified
             Comments comments;
             rd_flag flags{AddressFlags_None};
         };
@@ -39,6 +41,7 @@ class AddressDatabase: public Object
         bool findLabelR(const std::string& q, rd_address* resaddress) const;
         size_t findLabels(const std::string& q, const rd_address** resaddresses) const;
         size_t findLabelsR(const std::string& q, const rd_address** resaddresses) const;
+        size_t labelsRevision() const;
 
     public: // Flags
         bool isWeak(rd_address address) const;
@@ -50,8 +53,8 @@ class AddressDatabase: public Object
         void updateFlags(rd_address address, rd_flag flags, bool set = true);
 
     public: // Types
-        bool setTypeField(rd_address address, const Type* type, int indent, const std::string& name);
-        void setType(rd_address address, const Type* type, const std::string& label = std::string());
+        bool setTypeField(rd_address address, const std::shared_ptr<const Type>& type, int indent, const std::string& name);
+        void setType(rd_address address, const std::shared_ptr<const Type>& type, const std::string& label = std::string());
         const Type* getTypeField(rd_address address, int* indent) const;
         const Type* getType(rd_address address) const;
 
@@ -62,12 +65,14 @@ class AddressDatabase: public Object
 
     private:
         Entry* getEntry(rd_address address);
+        void labelChanged(rd_address address);
 
     private:
-        mutable std::vector<rd_address> m_result;
         mutable std::optional<std::string> m_lastassembler;
+        mutable std::mutex m_lastmutex; // Const readers can run concurrently
         UniqueContainer<std::string> m_assemblers;
         std::unordered_map<rd_type, SortedAddresses> m_labelflags;
         std::unordered_map<std::string, rd_address> m_labels;
         AddressContainer<Entry> m_entries;
+        std::atomic<size_t> m_labelsrevision{0};
 };
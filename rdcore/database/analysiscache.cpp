@@ -0,0 +1,644 @@
+#include "analysiscache.h"
+#include "addressdatabase.h"
+#include "../plugin/interface/pluginmanager.h"
+#include "../plugin/analyzer.h"
+#include "../plugin/assembler.h"
+#include "../plugin/loader.h"
+#include "../document/document.h"
+#include "../serializer/writer.h"
+#include "../serializer/reader.h"
+#include "../support/endian.h"
+#include "../support/utils.h"
+#include "../support/hash.h"
+#include "../builtin/analyzer/signatureanalyzer.h"
+#include "../disassembler.h"
+#include "../context.h"
+#include "../config.h"
+#include <rdapi/level.h>
+#include <unordered_set>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#define CHUNK_HEADER     "RDAC"
+#define CHUNK_ASSEMBLERS "ASMS"
+#define CHUNK_BLOCKS     "BLKS"
+#define CHUNK_LABELS     "LBLS"
+#define CHUNK_NETNODES   "NETN"
+#define CHUNK_REFERENCES "NREF"
+#define CHUNK_TYPES      "TYPS"
+
+#pragma pack(push, 1)
+struct AnalysisCacheHeader
+{
+    apilevel_t apilevel;
+    u32 version;
+    u64 buffersize;
+};
+#pragma pack(pop)
+
+struct CacheStream // Little endian, length prefixed fields
+{
+    RawData data;
+    bool ok{true}; // Cleared when a length doesn't fit its u32 prefix
+
+    void u8v(u8 v) { data.push_back(v); }
+    void u16v(u16 v) { v = Endian::tolittleendian16(v); this->raw(&v, sizeof(v)); }
+    void u32v(u32 v) { v = Endian::tolittleendian32(v); this->raw(&v, sizeof(v)); }
+    void u64v(u64 v) { v = Endian::tolittleendian64(v); this->raw(&v, sizeof(v)); }
+    void str(const std::string& s) { if(this->length(s.size())) this->raw(s.data(), s.size()); }
+    void raw(const void* p, size_t size) { auto* b = reinterpret_cast<const u8*>(p); data.insert(data.end(), b, b + size); }
+
+    void addresses(const SortedAddresses& a) {
+        if(!this->length(a.size())) return;
+        for(rd_address address : a) this->u64v(address);
+    }
+
+    bool length(size_t size) { // Same limit as CacheCursor's u32 prefixes
+        if(size > std::numeric_limits<u32>::max()) return (ok = false);
+        this->u32v(static_cast<u32>(size));
+        return true;
+    }
+};
+
+struct CacheCursor // Bounds checked reader of CacheStream data
+{
+    const RawData& data;
+    size_t pos{0};
+    bool ok{true};
+
+    CacheCursor(const RawData& d): data(d) { }
+    bool atEnd() const { return !ok || (pos >= data.size()); }
+
+    bool raw(void* p, size_t size) {
+        if(!ok || (size > (data.size() - pos))) return (ok = false);
+        std::memcpy(p, data.data() + pos, size);
+        pos += size;
+        return true;
+    }
+
+    u8 u8v() { u8 v = 0; this->raw(&v, sizeof(v)); return v; }
+    u16 u16v() { u16 v = 0; this->raw(&v, sizeof(v)); return Endian::tolittleendian16(v); }
+    u32 u32v() { u32 v = 0; this->raw(&v, sizeof(v)); return Endian::tolittleendian32(v); }
+    u64 u64v() { u64 v = 0; this->raw(&v, sizeof(v)); return Endian::tolittleendian64(v); }
+
+    std::string str() {
+        u32 len = this->u32v();
+        if(!ok || (len > (data.size() - pos))) { ok = false; return std::string(); }
+        std::string s(reinterpret_cast<const char*>(data.data() + pos), len);
+        pos += len;
+        return s;
+    }
+
+    void addresses(SortedAddresses& a) {
+        u32 c = this->u32v();
+        for(u32 i = 0; ok && (i < c); i++) a.insert(this->u64v());
+    }
+};
+
+static bool pushChunk(SerializerWriter& writer, const std::string& id, const CacheStream& s)
+{
+    if(!s.ok) return false;
+    if(s.data.empty()) return true;
+    return writer.push(id, s.data);
+}
+
+AnalysisCache::AnalysisCache(Context* ctx): Object(ctx) { }
+bool AnalysisCache::enabled() const { return this->context()->hasFlag(ContextFlags_AnalysisCache) && !rd_cfg->tempPath().empty(); }
+
+bool AnalysisCache::restore()
+{
+    if(!this->enabled()) return false;
+
+    std::string filepath = this->filePath();
+    std::error_code ec;
+    if(!fs::exists(filepath, ec)) return false;
+
+    SerializerReader reader;
+
+    if(!reader.read(filepath) || !this->checkHeader(reader))
+    {
+        spdlog::warn("AnalysisCache::restore(): Ignoring '{}': {}", filepath, reader.lastError());
+        return false;
+    }
+
+    State state;
+
+    if(!this->readAssemblers(reader, state) || !this->readBlocks(reader, state) || !this->readNet(reader, state) || !this->readLabels(reader, state) ||
+       !this->readTypes(reader, state))
+    {
+        this->log("Analysis cache is corrupted, analyzing from scratch");
+        return false;
+    }
+
+    if(!this->validate(state)) return false; // Nothing is touched until the whole state fits
+    this->apply(state);
+
+    spdlog::info("AnalysisCache::restore(): Restored from '{}'", filepath);
+    this->log("Analysis restored from cache");
+    return true;
+}
+
+bool AnalysisCache::save()
+{
+    if(!this->enabled()) return false;
+
+    fs::path filepath = this->filePath();
+    std::error_code ec;
+    fs::create_directories(filepath.parent_path(), ec);
+
+    SerializerWriter writer;
+    this->writeHeader(writer);
+
+    if(!this->writeAssemblers(writer) || !this->writeBlocks(writer) || !this->writeLabels(writer) || !this->writeNet(writer) || !this->writeTypes(writer))
+    {
+        spdlog::warn("AnalysisCache::save(): Oversized entry, the cache is not saved");
+        return false;
+    }
+
+    fs::path tmppath = filepath;
+    tmppath += ".tmp";
+
+    if(!writer.save(tmppath.string())) // Readers never see partial files
+    {
+        spdlog::warn("AnalysisCache::save(): {}", writer.lastError());
+        return false;
+    }
+
+    fs::rename(tmppath, filepath, ec);
+
+    if(ec)
+    {
+        fs::remove(tmppath, ec);
+        return false;
+    }
+
+    spdlog::info("AnalysisCache::save(): Saved to '{}'", filepath.string());
+    return true;
+}
+
+std::string AnalysisCache::key() const
+{
+    const auto& doc = this->context()->document();
+    auto* pm = this->context()->pluginManager();
+    auto* buffer = this->context()->buffer();
+
+    // Input bytes: a cryptographic digest, a colliding file must not restore another binary's analysis
+    Hash::SHA256Digest bufferhash = Hash::sha256(buffer->data(), buffer->size());
+
+    // Plugins and options, everything that can change the result
+    CacheStream s;
+    s.str(LIBREDASM_VERSION);
+    s.u32v(RDAPI_LEVEL);
+    s.u32v(ANALYSIS_CACHE_VERSION);
+    s.u64v(buffer->size());
+    s.str(pm->fingerprint(reinterpret_cast<const RDEntry*>(this->context()->loader()->plugin())));
+    s.str(pm->fingerprint(reinterpret_cast<const RDEntry*>(this->context()->assembler()->plugin())));
+
+    for(const Analyzer* a : this->context()->selectedAnalyzers())
+    {
+        s.str(pm->fingerprint(reinterpret_cast<const RDEntry*>(a->plugin())));
+        if(a->plugin() == &analyzerEntry_Signature) s.str(SignatureAnalyzer::fingerprint()); // Its results depend on the loaded databases
+    }
+
+    s.u32v(this->context()->flags() & ~(ContextFlags_ShowRDIL | ContextFlags_AnalysisCache)); // Rendering only
+    s.u64v(this->context()->minString());
+    s.u32v(this->context()->compilerABI());
+    s.u32v(this->context()->compilerCC());
+
+    // Loader output depends on build parameters (base address, entry point, ...)
+    RDLocation entry = doc->getEntry();
+    s.u64v(entry.valid ? entry.address : RD_NVAL);
+
+    for(size_t i = 0; i < doc->addressSpace()->size(); i++)
+    {
+        RDSegment segment;
+        if(doc->addressSpace()->indexToSegment(i, &segment)) s.raw(&segment, sizeof(RDSegment));
+    }
+
+    Hash::SHA256Digest optionshash = Hash::sha256(s.data.data(), s.data.size());
+
+    RDBufferView bufferview{ bufferhash.data(), bufferhash.size() }, optionsview{ optionshash.data(), optionshash.size() };
+    return Utils::hexString(&bufferview) + "-" + Utils::hexString(&optionsview);
+}
+
+std::string AnalysisCache::filePath() const
+{
+    if(m_key.empty()) m_key = this->key();
+    return (fs::path(rd_cfg->tempPath()) / ANALYSIS_CACHE_FOLDER_NAME / (m_key + ANALYSIS_CACHE_EXT)).string();
+}
+
+void AnalysisCache::writeHeader(SerializerWriter& writer) const
+{
+    AnalysisCacheHeader ach;
+    ach.apilevel = Endian::tolittleendian32(RDAPI_LEVEL);
+    ach.version = Endian::tolittleendian32(ANALYSIS_CACHE_VERSION);
+    ach.buffersize = Endian::tolittleendian64(this->context()->buffer()->size());
+    writer.push(CHUNK_HEADER, &ach);
+}
+
+bool AnalysisCache::writeAssemblers(SerializerWriter& writer) const
+{
+    CacheStream s; // Block infos are indices in this list
+    auto* db = this->context()->addressDatabase();
+
+    for(size_t i = 1; ; i++)
+    {
+        auto assembler = db->indexToAssembler(i);
+        if(!assembler) break;
+        s.str(*assembler);
+    }
+
+    return pushChunk(writer, CHUNK_ASSEMBLERS, s);
+}
+
+bool AnalysisCache::writeBlocks(SerializerWriter& writer) const
+{
+    const auto* aspace = this->context()->document()->addressSpace();
+
+    for(size_t i = 0; i < aspace->size(); i++)
+    {
+        RDSegment segment;
+        if(!aspace->indexToSegment(i, &segment)) continue;
+
+        const auto* blocks = aspace->getBlocks(segment.address);
+        if(!blocks) continue;
+
+        CacheStream s; // One chunk per segment
+        s.u64v(segment.address);
+        s.u64v(blocks->size());
+
+        for(const RDBlock& b : *blocks)
+        {
+            s.u64v(b.start);
+            s.u64v(b.end);
+            s.u32v(b.type);
+            s.u16v(b.info);
+        }
+
+        if(!pushChunk(writer, CHUNK_BLOCKS, s)) return false;
+    }
+
+    return true;
+}
+
+bool AnalysisCache::writeLabels(SerializerWriter& writer) const
+{
+    const auto& doc = this->context()->document();
+
+    const rd_address* addresses = nullptr;
+    size_t c = doc->getLabels(&addresses);
+
+    CacheStream s;
+    s.u64v(c);
+
+    for(size_t i = 0; i < c; i++)
+    {
+        rd_address address = addresses[i];
+        auto label = doc->getLabel(address);
+
+        s.u64v(address);
+        s.u32v(doc->getFlags(address));
+        s.u8v(doc->isWeak(address));
+        s.str(label ? *label : std::string());
+        s.str(doc->getComments(address));
+    }
+
+    // Functions can exist without the flag (user edits)
+    c = doc->getFunctions(&addresses);
+    s.u64v(c);
+    for(size_t i = 0; i < c; i++) s.u64v(addresses[i]);
+
+    return pushChunk(writer, CHUNK_LABELS, s);
+}
+
+bool AnalysisCache::writeNet(SerializerWriter& writer) const
+{
+    s_lock_document lock(this->context()->document()); // The net has no lock of its own
+    const auto* net = lock->net();
+
+    CacheStream nodes;
+    nodes.u64v(net->nodes().size());
+
+    for(const auto& [address, n] : net->nodes())
+    {
+        nodes.u64v(n.address);
+        nodes.u64v(n.next);
+        nodes.u64v(n.syscall);
+        nodes.u32v(n.branchtype);
+        nodes.addresses(n.prev);
+        nodes.addresses(n.from);
+        nodes.addresses(n.branchestrue);
+        nodes.addresses(n.branchesfalse);
+        nodes.addresses(n.calls);
+    }
+
+    CacheStream refs;
+    refs.u64v(net->references().size());
+
+    for(const auto& [address, r] : net->references())
+    {
+        refs.u64v(address);
+        if(!refs.length(r.size())) break;
+
+        for(const RDReference& ref : r)
+        {
+            refs.u64v(ref.address);
+            refs.u32v(ref.flags);
+        }
+    }
+
+    return pushChunk(writer, CHUNK_NETNODES, nodes) && pushChunk(writer, CHUNK_REFERENCES, refs);
+}
+
+bool AnalysisCache::writeTypes(SerializerWriter& writer) const
+{
+    const auto& doc = this->context()->document();
+
+    const rd_address* addresses = nullptr;
+    size_t c = doc->getLabels(&addresses);
+    std::vector<rd_address> sorted(addresses, addresses + c);
+    std::sort(sorted.begin(), sorted.end());
+
+    CacheStream s;
+    rd_address lastend = 0;
+
+    for(rd_address address : sorted)
+    {
+        if(address < lastend) continue; // Field or item of the previous type
+
+        const Type* t = doc->getType(address); // The outer type wins when they share the address
+
+        if(!t)
+        {
+            int indent = 0;
+            t = doc->getTypeField(address, &indent);
+            if(indent) continue;
+        }
+
+        if(!t) continue;
+
+        s.u64v(address);
+        s.str(tao::json::to_string(t->toJson()));
+        lastend = address + std::max<size_t>(t->size(), 1);
+    }
+
+    return pushChunk(writer, CHUNK_TYPES, s);
+}
+
+bool AnalysisCache::checkHeader(const SerializerReader& reader) const
+{
+    auto chunks = reader.find(CHUNK_HEADER);
+    if(!chunks || (chunks->size() != 1) || (chunks->front().size() != sizeof(AnalysisCacheHeader))) return false;
+
+    AnalysisCacheHeader ach;
+    std::memcpy(&ach, chunks->front().data(), sizeof(AnalysisCacheHeader));
+
+    return (Endian::tolittleendian32(ach.apilevel) == RDAPI_LEVEL) &&
+           (Endian::tolittleendian32(ach.version) == ANALYSIS_CACHE_VERSION) &&
+           (Endian::tolittleendian64(ach.buffersize) == this->context()->buffer()->size());
+}
+
+bool AnalysisCache::readAssemblers(const SerializerReader& reader, State& state) const
+{
+    auto chunks = reader.find(CHUNK_ASSEMBLERS);
+    if(!chunks) return true;
+
+    for(const auto& chunk : *chunks)
+    {
+        CacheCursor c(chunk);
+        while(!c.atEnd()) state.assemblers.push_back(c.str());
+        if(!c.ok) return false;
+    }
+
+    return true;
+}
+
+bool AnalysisCache::readBlocks(const SerializerReader& reader, State& state) const
+{
+    auto chunks = reader.find(CHUNK_BLOCKS);
+    if(!chunks) return false;
+
+    const auto& doc = this->context()->document();
+
+    for(const auto& chunk : *chunks)
+    {
+        CacheCursor c(chunk);
+        rd_address address = c.u64v();
+        u64 count = c.u64v();
+
+        RDSegment segment;
+        if(!c.ok || !doc->addressToSegment(address, &segment) || (segment.address != address)) return false;
+        if(count > (chunk.size() / (sizeof(u64) * 2))) return false;
+
+        auto& blocks = state.blocks.emplace_back(address, std::vector<RDBlock>()).second;
+        blocks.reserve(count);
+        rd_address next = segment.address;
+
+        for(u64 i = 0; i < count; i++)
+        {
+            RDBlock b{ };
+            b.start = c.u64v();
+            b.end = c.u64v();
+            b.type = c.u32v();
+            b.info = c.u16v();
+
+            // Blocks must cover the segment without gaps
+            if(!c.ok || (b.start != next) || (b.end <= b.start) || (b.end > segment.endaddress)) return false;
+            next = b.end;
+            blocks.push_back(b);
+        }
+
+        if(next != segment.endaddress) return false;
+    }
+
+    return state.blocks.size() == doc->addressSpace()->size();
+}
+
+bool AnalysisCache::readLabels(const SerializerReader& reader, State& state) const
+{
+    auto chunks = reader.find(CHUNK_LABELS);
+    if(!chunks || (chunks->size() != 1)) return false;
+
+    CacheCursor c(chunks->front());
+    u64 count = c.u64v();
+
+    for(u64 i = 0; c.ok && (i < count); i++)
+    {
+        Label item;
+        item.address = c.u64v();
+        item.flags = c.u32v();
+        item.weak = c.u8v();
+        item.label = c.str();
+        item.comments = c.str();
+        state.labels.push_back(std::move(item));
+    }
+
+    count = c.u64v();
+    for(u64 i = 0; c.ok && (i < count); i++) state.functions.push_back(c.u64v());
+    return c.ok;
+}
+
+bool AnalysisCache::readNet(const SerializerReader& reader, State& state) const
+{
+    auto nodechunks = reader.find(CHUNK_NETNODES);
+    if(!nodechunks) return true; // No code at all
+
+    for(const auto& chunk : *nodechunks)
+    {
+        CacheCursor c(chunk);
+        u64 count = c.u64v();
+
+        for(u64 i = 0; c.ok && (i < count); i++)
+        {
+            DocumentNetNode n;
+            n.address = c.u64v();
+            n.next = c.u64v();
+            n.syscall = c.u64v();
+            n.branchtype = c.u32v();
+            c.addresses(n.prev);
+            c.addresses(n.from);
+            c.addresses(n.branchestrue);
+            c.addresses(n.branchesfalse);
+            c.addresses(n.calls);
+            state.nodes.push_back(std::move(n));
+        }
+
+        if(!c.ok) return false;
+    }
+
+    auto refchunks = reader.find(CHUNK_REFERENCES);
+    if(!refchunks) return true;
+
+    for(const auto& chunk : *refchunks)
+    {
+        CacheCursor c(chunk);
+        u64 count = c.u64v();
+
+        for(u64 i = 0; c.ok && (i < count); i++)
+        {
+            auto& refs = state.references.emplace_back(c.u64v(), std::vector<RDReference>()).second;
+            u32 nrefs = c.u32v();
+
+            for(u32 j = 0; c.ok && (j < nrefs); j++)
+            {
+                RDReference r;
+                r.address = c.u64v();
+                r.flags = c.u32v();
+                refs.push_back(r);
+            }
+        }
+
+        if(!c.ok) return false;
+    }
+
+    return true;
+}
+
+bool AnalysisCache::readTypes(const SerializerReader& reader, State& state) const
+{
+    auto chunks = reader.find(CHUNK_TYPES);
+    if(!chunks) return true; // Untyped document
+
+    for(const auto& chunk : *chunks)
+    {
+        CacheCursor c(chunk);
+
+        while(!c.atEnd())
+        {
+            rd_address address = c.u64v();
+            std::string json = c.str();
+            if(!c.ok) return false;
+
+            try {
+                TypePtr t(Type::load(tao::json::from_string(json)));
+                if(!t) return false;
+                state.types.emplace_back(address, std::move(t));
+            }
+            catch(std::exception& e) {
+                spdlog::warn("AnalysisCache::readTypes(): {}", e.what());
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+bool AnalysisCache::validate(const State& state) const
+{
+    auto* db = this->context()->addressDatabase();
+    const auto& doc = this->context()->document();
+
+    // Block infos refer to these indices: the known assemblers must be a prefix of the cached ones
+    std::unordered_set<std::string> assemblers(state.assemblers.begin(), state.assemblers.end());
+
+    if(assemblers.size() != state.assemblers.size())
+    {
+        spdlog::warn("AnalysisCache::validate(): Duplicate assemblers");
+        return false;
+    }
+
+    for(size_t i = 1; ; i++)
+    {
+        auto assembler = db->indexToAssembler(i);
+        if(!assembler) break;
+
+        if((i > state.assemblers.size()) || (*assembler != state.assemblers[i - 1]))
+        {
+            spdlog::warn("AnalysisCache::validate(): Assembler order mismatch");
+            return false;
+        }
+    }
+
+    for(const auto& item : state.blocks)
+    {
+        if(!doc->addressSpace()->getBlocks(item.first)) return false;
+    }
+
+    return true;
+}
+
+void AnalysisCache::apply(State& state)
+{
+    auto* db = this->context()->addressDatabase();
+    auto& doc = this->context()->document();
+
+    for(const std::string& assembler : state.assemblers) db->pushAssembler(assembler); // Order checked by validate()
+
+    for(const auto& [address, blocks] : state.blocks)
+        doc->restoreBlocks(address, blocks.data(), blocks.size());
+
+    {
+        x_lock_document lock(doc);
+        auto* net = lock->net();
+        for(auto& n : state.nodes) net->restoreNode(std::move(n));
+        for(const auto& [address, refs] : state.references) net->restoreReferences(address, refs.data(), refs.size());
+    }
+
+    std::unordered_set<rd_address> functions(state.functions.begin(), state.functions.end());
+    bool weak = this->context()->isWeak();
+
+    for(const auto& item : state.labels)
+    {
+        if(item.flags & AddressFlags_TypeField) continue; // Rebuilt with their type below
+
+        this->context()->setWeak(item.weak);
+        if(functions.count(item.address)) doc->setFunction(item.address, item.label);
+        doc->setLabel(item.address, item.flags & ~(AddressFlags_Type | AddressFlags_TypeEnd), item.label);
+        if(!item.comments.empty()) doc->setComments(item.address, item.comments);
+    }
+
+    this->context()->setWeak(weak);
+
+    for(const auto& [address, type] : state.types)
+    {
+        if(doc->getType(address) || doc->getTypeField(address, nullptr)) continue; // Attached again by the loader
+        doc->setType(address, type.get());
+    }
+
+    for(rd_address address : state.functions)
+    {
+        if(!doc->getLabel(address)) doc->setFunction(address);
+    }
+}
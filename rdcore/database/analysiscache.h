@@ -0,0 +1,58 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <rdapi/types.h>
+#include "../document/documentnet.h"
+#include "../types/type.h"
+#include "../object.h"
+
+#define ANALYSIS_CACHE_FOLDER_NAME "analysis"
+#define ANALYSIS_CACHE_EXT         ".rdac"
+#define ANALYSIS_CACHE_VERSION     2
+
+class SerializerWriter;
+class SerializerReader;
+
+class AnalysisCache: public Object // Completed analysis state, keyed by input bytes, plugins and options
+{
+    private:
+        struct Label { rd_address address; rd_flag flags; bool weak; std::string label, comments; };
+
+        struct State { // Fully read and validated before it's applied
+            std::vector<std::string> assemblers;
+            std::vector<std::pair<rd_address, std::vector<RDBlock>>> blocks;
+            std::vector<Label> labels;
+            std::vector<rd_address> functions;
+            std::vector<DocumentNetNode> nodes;
+            std::vector<std::pair<rd_address, std::vector<RDReference>>> references;
+            std::vector<std::pair<rd_address, TypePtr>> types; // Outermost types only, fields are rebuilt from them
+        };
+
+    public:
+        AnalysisCache(Context* ctx);
+        bool enabled() const;
+        bool restore();
+        bool save();
+
+    private:
+        std::string key() const;
+        std::string filePath() const;
+        void writeHeader(SerializerWriter& writer) const;
+        bool writeAssemblers(SerializerWriter& writer) const;
+        bool writeBlocks(SerializerWriter& writer) const;
+        bool writeLabels(SerializerWriter& writer) const;
+        bool writeNet(SerializerWriter& writer) const;
+        bool writeTypes(SerializerWriter& writer) const;
+        bool checkHeader(const SerializerReader& reader) const;
+        bool readAssemblers(const SerializerReader& reader, State& state) const;
+        bool readBlocks(const SerializerReader& reader, State& state) const;
+        bool readLabels(const SerializerReader& reader, State& state) const;
+        bool readNet(const SerializerReader& reader, State& state) const;
+        bool readTypes(const SerializerReader& reader, State& state) const;
+        bool validate(const State& state) const;
+        void apply(State& state);
+
+    private:
+        mutable std::string m_key; // Hashed once, restore() and save() use the same file
+};
@@ -0,0 +1,208 @@
+#include "compileddatabase.h"
+#include <tao/pegtl.hpp>
+#include <fstream>
+#include <cstring>
+#include <limits>
+
+namespace {
+
+struct Node { std::string path; size_t offset, size; };
+
+void writeBE(std::string& out, u64 v, size_t n) { for(size_t i = n; i-- > 0; ) out.push_back(static_cast<char>((v >> (i * 8)) & 0xFF)); }
+
+void writeHeader(std::string& out, size_t n, u8 fix, u8 fixmax, u8 op16, u8 op32)
+{
+    if(n < fixmax) out.push_back(static_cast<char>(fix | n));
+    else if(n <= std::numeric_limits<u16>::max()) { out.push_back(static_cast<char>(op16)); writeBE(out, n, 2); }
+    else { out.push_back(static_cast<char>(op32)); writeBE(out, n, 4); }
+}
+
+void writeKey(std::string& out, const std::string& key)
+{
+    if(key.size() < 32) out.push_back(static_cast<char>(0xA0 | key.size()));
+    else if(key.size() <= std::numeric_limits<u8>::max()) { out.push_back(static_cast<char>(0xD9)); writeBE(out, key.size(), 1); }
+    else if(key.size() <= std::numeric_limits<u16>::max()) { out.push_back(static_cast<char>(0xDA)); writeBE(out, key.size(), 2); }
+    else { out.push_back(static_cast<char>(0xDB)); writeBE(out, key.size(), 4); }
+
+    out.append(key);
+}
+
+std::string escapeToken(const std::string& token)
+{
+    std::string res;
+
+    for(char c : token)
+    {
+        if(c == '~') res += "~0";
+        else if(c == '/') res += "~1";
+        else res.push_back(c);
+    }
+
+    return res;
+}
+
+// Emits msgpack by hand for containers, so that every node's byte range is known
+void serialize(const tao::json::value& v, const std::string& path, std::string& out, std::vector<Node>& nodes)
+{
+    size_t idx = nodes.size();
+    nodes.push_back({path, out.size(), 0});
+
+    if(v.is_object())
+    {
+        const auto& obj = v.get_object();
+        writeHeader(out, obj.size(), 0x80, 16, 0xDE, 0xDF);
+
+        for(const auto& [key, item] : obj)
+        {
+            writeKey(out, key);
+            serialize(item, path + "/" + escapeToken(key), out, nodes);
+        }
+    }
+    else if(v.is_array())
+    {
+        const auto& arr = v.get_array();
+        writeHeader(out, arr.size(), 0x90, 16, 0xDC, 0xDD);
+
+        for(size_t i = 0; i < arr.size(); i++)
+            serialize(arr[i], path + "/" + std::to_string(i), out, nodes);
+    }
+    else
+        out += tao::json::msgpack::to_string(v);
+
+    nodes[idx].size = out.size() - nodes[idx].offset;
+}
+
+template<typename T> void append(std::vector<u8>& out, const T* data, size_t size)
+{
+    const u8* p = reinterpret_cast<const u8*>(data);
+    out.insert(out.end(), p, p + size);
+}
+
+} // namespace
+
+bool CompiledDatabase::open(const fs::path& filepath)
+{
+    if(!m_file.open(filepath) || (m_file.size() < sizeof(Header))) return false;
+
+    const u8* base = m_file.data();
+    const Header* header = reinterpret_cast<const Header*>(base);
+    if(std::memcmp(header->magic, COMPILED_DATABASE_MAGIC, sizeof(header->magic)) || (header->version != COMPILED_DATABASE_VERSION)) return false;
+    if(!header->buckets || (header->buckets & (header->buckets - 1))) return false;
+
+    // Untrusted offsets: compare by subtraction, the sums could wrap
+    u64 size = m_file.size();
+    if((header->index < sizeof(Header)) || (header->index % alignof(Entry))) return false;
+    if((header->index > size) || (header->buckets > ((size - header->index) / sizeof(Entry)))) return false;
+    if((header->paths < (header->index + (header->buckets * sizeof(Entry)))) || (header->paths > header->values)) return false;
+    if((header->values > size) || (header->valuessize > (size - header->values))) return false;
+
+    m_header = header;
+    m_buckets = reinterpret_cast<const Entry*>(base + header->index);
+    m_paths = reinterpret_cast<const char*>(base + header->paths);
+    m_values = base + header->values;
+    return true;
+}
+
+bool CompiledDatabase::contains(std::string_view path) const { return this->lookup(path); }
+
+bool CompiledDatabase::find(std::string_view path, tao::json::value& v) const
+{
+    const Entry* e = this->lookup(path);
+    if(!e) return false;
+
+    try {
+        v = tao::json::msgpack::from_string(std::string_view(reinterpret_cast<const char*>(m_values + e->value), e->valuesize));
+    }
+    catch(tao::pegtl::parse_error&) {
+        return false;
+    }
+
+    return true;
+}
+
+bool CompiledDatabase::isCompiled(const fs::path& filepath)
+{
+    std::ifstream ifs(filepath, std::ios::binary);
+    char magic[4];
+    return ifs.read(magic, sizeof(magic)) && !std::memcmp(magic, COMPILED_DATABASE_MAGIC, sizeof(magic));
+}
+
+bool CompiledDatabase::build(const tao::json::value& tree, std::vector<u8>& outdata)
+{
+    std::string values;
+    std::vector<Node> nodes;
+    serialize(tree, std::string(), values, nodes);
+
+    size_t buckets = 1;
+    while(buckets < nodes.size() * 2) buckets <<= 1; // Load factor <= 0.5
+
+    std::vector<Entry> index(buckets, Entry{ });
+    std::string paths;
+
+    for(const Node& n : nodes)
+    {
+        if((paths.size() > std::numeric_limits<u32>::max()) || (n.offset > std::numeric_limits<u32>::max())) return false;
+
+        u64 h = CompiledDatabase::hash(n.path);
+        size_t b = h & (buckets - 1);
+        while(index[b].valuesize) b = (b + 1) & (buckets - 1);
+
+        index[b] = { h, static_cast<u32>(paths.size()), static_cast<u32>(n.path.size()),
+                     static_cast<u32>(n.offset), static_cast<u32>(n.size) };
+
+        paths += n.path;
+    }
+
+    Header header{ };
+    std::memcpy(header.magic, COMPILED_DATABASE_MAGIC, sizeof(header.magic));
+    header.version = COMPILED_DATABASE_VERSION;
+    header.buckets = static_cast<u32>(buckets);
+    header.count = static_cast<u32>(nodes.size());
+    header.index = sizeof(Header);
+    header.paths = header.index + (buckets * sizeof(Entry));
+    header.values = header.paths + paths.size();
+    header.valuessize = values.size();
+
+    outdata.clear();
+    outdata.reserve(header.values + header.valuessize);
+    append(outdata, &header, sizeof(Header));
+    append(outdata, index.data(), index.size() * sizeof(Entry));
+    append(outdata, paths.data(), paths.size());
+    append(outdata, values.data(), values.size());
+    return true;
+}
+
+const CompiledDatabase::Entry* CompiledDatabase::lookup(std::string_view path) const
+{
+    if(!m_header) return nullptr;
+
+    u64 h = CompiledDatabase::hash(path), mask = m_header->buckets - 1;
+
+    u64 pathssize = m_header->values - m_header->paths;
+
+    for(u64 i = 0, b = h & mask; i < m_header->buckets; i++, b = (b + 1) & mask)
+    {
+        const Entry* e = &m_buckets[b];
+        if(!e->valuesize) break;
+        if(e->hash != h) continue;
+
+        // Don't trust offsets coming from the file
+        if((static_cast<u64>(e->path) + e->pathsize > pathssize) || (static_cast<u64>(e->value) + e->valuesize > m_header->valuessize)) return nullptr;
+        if(std::string_view(m_paths + e->path, e->pathsize) == path) return e;
+    }
+
+    return nullptr;
+}
+
+u64 CompiledDatabase::hash(std::string_view path)
+{
+    u64 h = 0xcbf29ce484222325; // FNV-1a
+
+    for(char c : path)
+    {
+        h ^= static_cast<u8>(c);
+        h *= 0x100000001b3;
+    }
+
+    return h;
+}
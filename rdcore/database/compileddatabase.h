@@ -0,0 +1,62 @@
+#pragma once
+
+/*
+ * Indexed .rdb format: the whole tree is stored once as uncompressed msgpack,
+ * every node (object member or array item) is indexed by its JSON pointer,
+ * so the file can be mapped as-is and queries decode only the requested subtree.
+ */
+
+#include <filesystem>
+#include <string_view>
+#include <string>
+#include <vector>
+#include <tao/json.hpp>
+#include <rdapi/types.h>
+#include "../support/mappedfile.h"
+
+#define COMPILED_DATABASE_MAGIC   "RDBI"
+#define COMPILED_DATABASE_VERSION 1
+
+namespace fs = std::filesystem;
+
+class CompiledDatabase
+{
+    public:
+        struct Header {
+            char magic[4];
+            u32 version;
+            u32 buckets;    // Power of two, open addressing
+            u32 count;
+            u64 index;      // Offset of the bucket table
+            u64 paths;      // Offset of the path strings
+            u64 values;     // Offset of the msgpack tree
+            u64 valuessize;
+        };
+
+        struct Entry {
+            u64 hash;
+            u32 path, pathsize;   // Relative to Header::paths
+            u32 value, valuesize; // Relative to Header::values, an empty bucket has no value
+        };
+
+    public:
+        CompiledDatabase() = default;
+        bool open(const fs::path& filepath);
+        bool contains(std::string_view path) const;
+        bool find(std::string_view path, tao::json::value& v) const;
+
+    public:
+        static bool isCompiled(const fs::path& filepath);
+        static bool build(const tao::json::value& tree, std::vector<u8>& outdata);
+
+    private:
+        const Entry* lookup(std::string_view path) const;
+        static u64 hash(std::string_view path);
+
+    private:
+        MappedFile m_file;
+        const Header* m_header{nullptr};
+        const Entry* m_buckets{nullptr};
+        const char* m_paths{nullptr};
+        const u8* m_values{nullptr};
+};
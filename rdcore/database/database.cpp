@@ -8,7 +8,38 @@
 
 #define DATABASE_NAME_FIELD "@name"
 
-Database::Database(const tao::json::value& tree): Object(), m_tree(tree) { }
+SharedTypePtr Database::TypeRegistry::find(const std::string& path)
+{
+    std::scoped_lock<std::mutex> lock(mutex);
+    auto it = types.find(path);
+    return (it != types.end()) ? it->second : nullptr;
+}
+
+SharedTypePtr Database::TypeRegistry::intern(const std::string& path, const tao::json::value& obj)
+{
+    std::scoped_lock<std::mutex> lock(mutex);
+
+    auto it = types.find(path);
+    if(it != types.end()) return it->second;
+
+    SharedTypePtr t(Type::load(obj));
+    if(t) types[path] = t;
+    return t;
+}
+
+void Database::TypeRegistry::insert(const std::string& path, const SharedTypePtr& t) { std::scoped_lock<std::mutex> lock(mutex); types[path] = t; }
+void Database::TypeRegistry::clear() { std::scoped_lock<std::mutex> lock(mutex); types.clear(); }
+
+Database::Database(const MountSourcePtr& source): Object()
+{
+    Database::initializeTree(m_tree);
+
+    if(source->compiled) source->compiled->find("/" DATABASE_NAME_FIELD, m_tree[DATABASE_NAME_FIELD]);
+    else m_tree[DATABASE_NAME_FIELD] = source->tree.at(DATABASE_NAME_FIELD);
+
+    m_mounts.emplace_back(std::string(), source);
+}
+
 Database::Database(): Object() { Database::initializeTree(m_tree); }
 Database::Database(Context* ctx): Object(ctx) { Database::initializeTree(m_tree); }
 const std::string& Database::name() const { m_tree.at(DATABASE_NAME_FIELD).to(m_name); return m_name; }
@@ -18,12 +49,30 @@ bool Database::query(std::string q, RDDatabaseValue* dbvalue) const
 {
     if(!this->checkPointer(q)) return false;
 
-    auto* val = m_tree.find(tao::json::pointer(q));
-    return val ? this->extract(*val, dbvalue) : false;
+    tao::json::value mounted;
+    const Mount* mount = nullptr;
+    auto* val = this->findValue(q, mounted, &mount);
+    return val ? this->extract(q, *val, mount, dbvalue) : false;
+}
+
+SharedTypePtr Database::findType(std::string q) const
+{
+    if(!this->checkPointer(q)) return nullptr;
+
+    if(auto t = m_types.find(q)) return t;
+
+    tao::json::value mounted;
+    const Mount* mount = nullptr;
+    auto* val = this->findValue(q, mounted, &mount);
+    if(!val || !val->is_object()) return nullptr;
+    return this->internType(q, *val, mount);
 }
 
 bool Database::write(const std::string& path, const std::string& val)
 {
+    if(this->isMounted(path)) this->materialize();
+    this->invalidateTypes();
+
     tao::json::pointer p = this->checkTree(path);
     if(p.empty()) return false;
 
@@ -33,6 +82,9 @@ bool Database::write(const std::string& path, const std::string& val)
 
 bool Database::write(const std::string& path, const Type* type)
 {
+    if(this->isMounted(path)) this->materialize();
+    this->invalidateTypes();
+
     tao::json::pointer p = this->checkTree(path);
     if(p.empty()) return false;
 
@@ -51,26 +103,23 @@ bool Database::add(const std::string& dbpath, const std::string& filepath)
     auto dbloc = Database::locate(filepath);
     if(dbloc.empty()) return false;
 
-    tao::json::pointer p = this->checkTree(dbpath);
-    if(p.empty()) return false;
+    std::string prefix = dbpath;
+    if(!this->checkPointer(prefix) || prefix.empty()) return false;
 
-    tao::json::value tree;
-    if(!Database::parseFile(dbloc, tree)) return false;
-    if(!Database::validateTree(tree)) return false;
+    auto source = Database::openSource(dbloc); // Parsed or mapped once, other contexts adding it reuse it
+    if(!source) return false;
 
-    m_tree[p] = tree;
+    m_mounts.emplace_back(prefix, source);
+    this->invalidateTypes(); // It can shadow paths of older mounts
     return true;
 }
 
 bool Database::compile(const std::string& filepath) const
 {
-    if(!filepath.empty()) return false;
-
-    auto res = tao::json::msgpack::to_string(m_tree);
-    if(res.empty()) return false;
+    if(filepath.empty()) return false;
 
-    Data data(res.begin(), res.end()), outdata;
-    if(!Compression::compress(data, outdata) || outdata.empty()) return false;
+    Data outdata;
+    if(!CompiledDatabase::build(this->tree(), outdata)) return false;
 
     std::ofstream ofs(filepath, std::ios::binary);
     if(!ofs.is_open()) return false;
@@ -80,7 +129,7 @@ bool Database::compile(const std::string& filepath) const
 
 const std::string& Database::decompile() const
 {
-    m_decompiled = tao::json::to_string(m_tree);
+    m_decompiled = tao::json::to_string(this->tree());
     return m_decompiled;
 }
 
@@ -104,23 +153,16 @@ Database* Database::open(const std::string& dbname)
     auto dbloc = Database::locate(dbname);
     if(dbloc.empty()) return nullptr;
 
-    tao::json::value tree;
-    if(!Database::parseFile(dbloc, tree)) return nullptr;
-    if(!Database::validateTree(tree)) return nullptr;
-    return new Database(tree);
+    auto source = Database::openSource(dbloc);
+    return source ? new Database(source) : nullptr;
 }
 
 bool Database::compileFile(const fs::path& filepath, Database::Data& outdata)
 {
     tao::json::value v;
     if(!Database::parseDecompiledFile(filepath, v)) return false;
-
-    auto res = tao::json::msgpack::to_string(v);
-    if(res.empty()) return false;
-
-    Data data(res.begin(), res.end());
-    if(!Compression::compress(data, outdata)) return false;
-    return !outdata.empty();
+    if(!Database::validateTree(v)) return false;
+    return CompiledDatabase::build(v, outdata);
 }
 
 bool Database::decompileFile(const fs::path& filepath, Database::Data& outdata)
@@ -135,15 +177,12 @@ bool Database::decompileFile(const fs::path& filepath, Database::Data& outdata)
     return !outdata.empty();
 }
 
-void Database::extractObject(const tao::json::value& obj, RDDatabaseValue* outval) const
+void Database::extractObject(const std::string& path, const tao::json::value& obj, const Mount* mount, RDDatabaseValue* outval) const
 {
-    Type* t = Type::load(obj);
-
-    if(t)
+    if(auto t = this->internType(path, obj, mount))
     {
-        m_typecache.reset(t); // Take ownership
         outval->type = DatabaseValueType_Type;
-        outval->t = CPTR(RDType, t);
+        outval->t = CPTR(const RDType, t.get()); // Valid until the database changes
         return;
     }
 
@@ -152,7 +191,7 @@ void Database::extractObject(const tao::json::value& obj, RDDatabaseValue* outva
     outval->obj = it.first->second.c_str();
 }
 
-bool Database::extract(const tao::json::value& inval, RDDatabaseValue* outval) const
+bool Database::extract(const std::string& path, const tao::json::value& inval, const Mount* mount, RDDatabaseValue* outval) const
 {
     switch(inval.type())
     {
@@ -184,7 +223,7 @@ bool Database::extract(const tao::json::value& inval, RDDatabaseValue* outval) c
             return true;
 
         case tao::json::type::OBJECT:
-            this->extractObject(inval, outval);
+            this->extractObject(path, inval, mount, outval);
             return true;
 
         default: break;
@@ -193,6 +232,26 @@ bool Database::extract(const tao::json::value& inval, RDDatabaseValue* outval) c
     return false;
 }
 
+const tao::json::value* Database::findValue(const std::string& path, tao::json::value& mounted, const Mount** mount) const
+{
+    if(auto* v = this->findMounted(path, mounted, mount)) return v;
+    return m_tree.find(tao::json::pointer(path));
+}
+
+SharedTypePtr Database::internType(const std::string& path, const tao::json::value& obj, const Mount* mount) const
+{
+    if(!mount) return m_types.intern(path, obj);
+
+    // Mounted types are loaded once for every context, this database only keeps a shortcut
+    const auto& [prefix, source] = *mount;
+    auto t = source->types.intern(path.substr(prefix.size()), obj);
+    if(t) m_types.insert(path, t);
+    return t;
+}
+
+// Addresses keep their own references, only future lookups are affected
+void Database::invalidateTypes() { m_types.clear(); }
+
 bool Database::checkPointer(std::string& path) const
 {
     if(path.front() != '/') path = "/" + path;
@@ -204,15 +263,128 @@ bool Database::checkPointer(std::string& path) const
 bool Database::pathExists(std::string path) const
 {
     this->checkPointer(path);
-    return m_tree.find(path);
+    return m_tree.find(path) || this->isMounted(path);
+}
+
+const tao::json::value* Database::findMounted(const std::string& path, tao::json::value& mounted, const Mount** mount) const
+{
+    for(auto it = m_mounts.rbegin(); it != m_mounts.rend(); it++) // Latest mount wins
+    {
+        const auto& [prefix, source] = *it;
+        if(path.compare(0, prefix.size(), prefix)) continue;
+        if((path.size() > prefix.size()) && (path[prefix.size()] != '/')) continue;
+
+        const tao::json::value* v = nullptr;
+
+        if(source->compiled) // Decoded on demand
+        {
+            if(source->compiled->find(std::string_view(path).substr(prefix.size()), mounted)) v = &mounted;
+        }
+        else
+            v = source->tree.find(tao::json::pointer(path.substr(prefix.size())));
+
+        if(!v) continue;
+        if(mount) *mount = std::addressof(*it);
+        return v;
+    }
+
+    return nullptr;
+}
+
+bool Database::isMounted(const std::string& path) const
+{
+    std::string p = path;
+    if(!this->checkPointer(p)) return false;
+
+    for(const auto& [prefix, source] : m_mounts)
+    {
+        if(!p.compare(0, prefix.size(), prefix) && ((p.size() == prefix.size()) || (p[prefix.size()] == '/')))
+            return true;
+    }
+
+    return false;
+}
+
+tao::json::value Database::tree() const
+{
+    if(m_mounts.empty()) return m_tree;
+
+    tao::json::value tree = m_tree;
+
+    for(const auto& [prefix, source] : m_mounts)
+    {
+        if(!source->compiled) Database::graft(tree, prefix, source->tree);
+        else if(tao::json::value v; source->compiled->find(std::string_view(), v)) Database::graft(tree, prefix, std::move(v));
+    }
+
+    return tree;
 }
 
 tao::json::pointer Database::checkTree(std::string path)
 {
     if(!this->checkPointer(path)) return { };
+    return Database::createPath(m_tree, path);
+}
+
+void Database::materialize()
+{
+    // Writes need a plain tree: decode mounted databases once
+    m_tree = this->tree();
+    m_mounts.clear();
+}
+
+Database::MountSourcePtr Database::openSource(const fs::path& filepath)
+{
+    // Sources are read only: share them between contexts, a rewritten file is loaded again
+    static std::unordered_map<std::string, std::weak_ptr<const MountSource>> opened;
+    static std::mutex mutex;
+
+    std::error_code ec;
+    std::string key = fs::weakly_canonical(filepath, ec).string();
+    if(ec) key = filepath.string();
+    key += ":" + std::to_string(fs::last_write_time(filepath, ec).time_since_epoch().count());
 
+    std::scoped_lock<std::mutex> lock(mutex); // Concurrent adds of the same file wait for a single parse
+    if(auto source = opened[key].lock()) return source;
+
+    auto source = std::make_shared<MountSource>();
+
+    if(CompiledDatabase::isCompiled(filepath))
+    {
+        source->compiled = std::make_unique<CompiledDatabase>();
+        if(!source->compiled->open(filepath)) return nullptr;
+
+        tao::json::value name;
+        if(!source->compiled->find("/" DATABASE_NAME_FIELD, name) || !name.is_string()) return nullptr;
+    }
+    else if(!Database::parseFile(filepath, source->tree) || !Database::validateTree(source->tree))
+        return nullptr;
+
+    opened[key] = source;
+    return source;
+}
+
+void Database::graft(tao::json::value& tree, const std::string& path, tao::json::value v)
+{
+    if(path.empty()) // Root mount: merge everything but the name
+    {
+        if(!v.is_object()) return;
+
+        for(auto& [key, item] : v.get_object())
+        {
+            if(key != DATABASE_NAME_FIELD) tree[key] = std::move(item);
+        }
+
+        return;
+    }
+
+    tree[Database::createPath(tree, path)] = std::move(v);
+}
+
+tao::json::pointer Database::createPath(tao::json::value& tree, const std::string& path)
+{
     tao::json::pointer ptr(path);
-    auto* obj = &m_tree;
+    auto* obj = &tree;
 
     for(const auto& item : ptr)
     {
@@ -245,7 +417,13 @@ bool Database::parseDecompiledFile(const fs::path& filepath, tao::json::value& j
 
 bool Database::parseCompiledFile(const fs::path& filepath, tao::json::value& j)
 {
-    try {
+    if(CompiledDatabase::isCompiled(filepath))
+    {
+        CompiledDatabase compiled;
+        return compiled.open(filepath) && compiled.find(std::string_view(), j);
+    }
+
+    try { // Legacy format: compressed msgpack
         Data data;
         if(!Compression::decompressFile(filepath.string(), data)) return false;
 
@@ -3,11 +3,14 @@
 #include <rdapi/database/database.h>
 #include <filesystem>
 #include <unordered_map>
+#include <memory>
+#include <mutex>
 #include <set>
 #include <tao/json.hpp>
 #include "../types/definitions.h"
 #include "../object.h"
 #include "../config.h"
+#include "compileddatabase.h"
 
 namespace fs = std::filesystem;
 
@@ -17,7 +20,29 @@ class Database: public Object
         typedef std::vector<u8> Data;
 
     private:
-        Database(const tao::json::value& tree);
+        struct TypeRegistry // Interned by path
+        {
+            std::unordered_map<std::string, SharedTypePtr> types;
+            std::mutex mutex;
+
+            SharedTypePtr find(const std::string& path);
+            SharedTypePtr intern(const std::string& path, const tao::json::value& obj);
+            void insert(const std::string& path, const SharedTypePtr& t);
+            void clear();
+        };
+
+        struct MountSource // A database file, shared by every context that adds it
+        {
+            std::unique_ptr<CompiledDatabase> compiled; // Indexed databases are queried in place
+            tao::json::value tree;                      // The others are parsed once, read only
+            mutable TypeRegistry types;                 // Paths are relative to the source
+        };
+
+        typedef std::shared_ptr<const MountSource> MountSourcePtr;
+        typedef std::pair<std::string, MountSourcePtr> Mount; // JSON Pointer, Source
+
+    private:
+        Database(const MountSourcePtr& source);
 
     public:
         Database();
@@ -25,6 +50,7 @@ class Database: public Object
         const std::string& name() const;
         void setName(const std::string& name);
         bool query(std::string q, RDDatabaseValue* dbvalue) const;
+        SharedTypePtr findType(std::string q) const;
         bool write(const std::string& path, const std::string& val);
         bool write(const std::string& path, const Type* type);
         bool add(const std::string& dbpath, const std::string& filepath);
@@ -39,24 +65,35 @@ class Database: public Object
         static bool decompileFile(const fs::path& filepath, Data& outdata);
 
     private:
-        void extractObject(const tao::json::value& obj, RDDatabaseValue* outval) const;
-        bool extract(const tao::json::value& inval, RDDatabaseValue* outval) const;
+        void extractObject(const std::string& path, const tao::json::value& obj, const Mount* mount, RDDatabaseValue* outval) const;
+        bool extract(const std::string& path, const tao::json::value& inval, const Mount* mount, RDDatabaseValue* outval) const;
+        const tao::json::value* findValue(const std::string& path, tao::json::value& mounted, const Mount** mount = nullptr) const;
+        SharedTypePtr internType(const std::string& path, const tao::json::value& obj, const Mount* mount) const;
+        void invalidateTypes();
         bool checkPointer(std::string& path) const;
         bool pathExists(std::string path) const;
+        const tao::json::value* findMounted(const std::string& path, tao::json::value& mounted, const Mount** mount) const;
+        bool isMounted(const std::string& path) const;
+        tao::json::value tree() const;
         tao::json::pointer checkTree(std::string path);
+        void materialize();
 
     private:
         static bool parseDecompiledFile(const fs::path &filepath, tao::json::value& j);
         static bool parseCompiledFile(const fs::path &filepath, tao::json::value& j);
         static bool parseFile(const fs::path &filepath, tao::json::value& j);
+        static MountSourcePtr openSource(const fs::path& filepath);
+        static tao::json::pointer createPath(tao::json::value& tree, const std::string& path);
+        static void graft(tao::json::value& tree, const std::string& path, tao::json::value v);
         static fs::path locatePath(const fs::path& dbpath);
         static fs::path locateAs(fs::path dbpath, const std::string& ext);
         static fs::path locate(fs::path dbpath);
 
     private:
-        mutable std::unique_ptr<Type> m_typecache;
+        mutable TypeRegistry m_types;
         mutable std::unordered_map<tao::json::type, std::string> m_valuecache;
         mutable std::string m_decompiled, m_name;
         std::set<std::pair<std::string, std::string>> m_importeddb;
+        std::vector<Mount> m_mounts;
         tao::json::value m_tree;
 };
@@ -0,0 +1,211 @@
+#include "signaturedatabase.h"
+#include "../support/hash.h"
+#include <rdapi/buffer.h>
+#include <algorithm>
+#include <limits>
+#include <fstream>
+#include <cstring>
+
+bool SignatureDatabase::load(const fs::path& filepath)
+{
+    std::ifstream ifs(filepath, std::ios::binary);
+    if(!ifs.is_open()) return false;
+
+    Header header{ };
+    if(!ifs.read(reinterpret_cast<char*>(&header), sizeof(Header))) return false;
+    if(std::memcmp(header.magic, SIGNATURE_MAGIC, sizeof(header.magic)) || (header.version != SIGNATURE_VERSION)) return false;
+
+    // Untrusted sizes: the payload must fit in the file before anything is allocated
+    std::error_code ec;
+    u64 filesize = fs::file_size(filepath, ec);
+    if(ec || (filesize < sizeof(Header))) return false;
+
+    u64 payloadsize = (static_cast<u64>(header.count) * sizeof(Signature)) + header.namessize; // u32 fields, can't wrap
+    if(payloadsize > (filesize - sizeof(Header))) return false;
+
+    std::vector<Signature> signatures(header.count);
+    std::vector<char> names(header.namessize);
+
+    if(!ifs.read(reinterpret_cast<char*>(signatures.data()), signatures.size() * sizeof(Signature))) return false;
+    if(!ifs.read(names.data(), names.size())) return false;
+    if(!names.empty() && names.back()) return false; // Names must be null terminated
+
+    std::string assembler(header.assembler, strnlen(header.assembler, SIGNATURE_ID_SIZE));
+    if(!m_assembler.empty() && (m_assembler != assembler)) return false;
+    m_assembler = assembler;
+
+    size_t namebase = m_names.size(); // Files are merged into a single index
+    m_names.insert(m_names.end(), names.begin(), names.end());
+    m_index.reserve(m_index.size() + signatures.size());
+
+    for(Signature& sig : signatures)
+    {
+        if((sig.size > SIGNATURE_PREFIX_SIZE) || (sig.name >= names.size())) continue;
+
+        sig.name += namebase;
+        m_signatures.push_back(sig);
+        this->index(m_signatures.size() - 1);
+    }
+
+    return true;
+}
+
+bool SignatureDatabase::save(const fs::path& filepath) const
+{
+    std::ofstream ofs(filepath, std::ios::binary | std::ios::trunc);
+    if(!ofs.is_open()) return false;
+
+    Header header{ };
+    std::memcpy(header.magic, SIGNATURE_MAGIC, sizeof(header.magic));
+    std::strncpy(header.assembler, m_assembler.c_str(), SIGNATURE_ID_SIZE - 1);
+    header.version = SIGNATURE_VERSION;
+    header.count = static_cast<u32>(m_signatures.size());
+    header.namessize = static_cast<u32>(m_names.size());
+
+    ofs.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+    ofs.write(reinterpret_cast<const char*>(m_signatures.data()), m_signatures.size() * sizeof(Signature));
+    ofs.write(m_names.data(), m_names.size());
+    return ofs.good();
+}
+
+bool SignatureDatabase::add(const u8* data, const u8* mask, size_t size, const std::string& name)
+{
+    if(!data || (size < SIGNATURE_MIN_SIZE) || name.empty()) return false;
+
+    Signature sig{ };
+    sig.size = static_cast<u16>(std::min<size_t>(size, SIGNATURE_PREFIX_SIZE));
+    sig.crcsize = static_cast<u16>(std::min<size_t>(size - sig.size, std::numeric_limits<u16>::max()));
+    sig.crc = sig.crcsize ? SignatureDatabase::maskedCrc(data + sig.size, mask ? mask + sig.size : nullptr, sig.crcsize) : 0;
+
+    for(size_t i = 0; i < sig.size; i++)
+    {
+        if(mask && !mask[i]) continue; // Stored as zero, never compared
+        sig.fixedmask |= (1u << i);
+        sig.prefix[i] = data[i];
+    }
+
+    RDBufferView view{ const_cast<u8*>(data), size };
+    if(const char* found = this->match(&view, mask, size); found && (name == found)) return false; // Already known
+
+    sig.name = static_cast<u32>(m_names.size());
+    m_names.insert(m_names.end(), name.begin(), name.end());
+    m_names.push_back('\0');
+
+    m_signatures.push_back(sig);
+    this->index(m_signatures.size() - 1);
+    return true;
+}
+
+const char* SignatureDatabase::match(const RDBufferView* view, const u8* mask, size_t length) const
+{
+    if(!view || !view->data) return nullptr;
+
+    const char* name = nullptr;
+
+    for(u8 keymask : m_keymasks)
+    {
+        auto [first, last] = m_index.equal_range(SignatureDatabase::key(view->data, view->size, keymask));
+
+        for(auto it = first; it != last; it++)
+        {
+            const Signature& sig = m_signatures[it->second];
+            if(!this->matchSignature(sig, view, mask, length)) continue;
+
+            const char* signame = m_names.data() + sig.name;
+            if(name && std::strcmp(name, signame)) return nullptr; // Ambiguous: don't guess
+            name = signame;
+        }
+    }
+
+    return name;
+}
+
+const std::string& SignatureDatabase::assembler() const { return m_assembler; }
+void SignatureDatabase::setAssembler(const std::string& assembler) { m_assembler = assembler; }
+size_t SignatureDatabase::size() const { return m_signatures.size(); }
+
+bool SignatureDatabase::matchSignature(const Signature& sig, const RDBufferView* view, const u8* mask, size_t length) const
+{
+    size_t sigsize = static_cast<size_t>(sig.size + sig.crcsize);
+    if(view->size < sigsize) return false;
+
+    // A signature covers the whole function it was generated from (up to the CRC limit), a longer or shorter one is a different function
+    if((length != RD_NVAL) && (sigsize != std::min<size_t>(length, SIGNATURE_PREFIX_SIZE + std::numeric_limits<u16>::max()))) return false;
+
+    for(size_t i = 0; i < sig.size; i++)
+    {
+        if((sig.fixedmask & (1u << i)) && (view->data[i] != sig.prefix[i]))
+            return false;
+    }
+
+    return !sig.crcsize || (SignatureDatabase::maskedCrc(view->data + sig.size, mask ? mask + sig.size : nullptr, sig.crcsize) == sig.crc);
+}
+
+bool SignatureDatabase::maskAddress(const u8* data, u8* mask, size_t size, rd_address address, rd_address nextaddress, size_t width)
+{
+    // The byte order isn't known here: both are tried, the first occurrence wins
+    auto clear = [&](u64 value, size_t n) {
+        if((n < 2) || (n > sizeof(u64)) || (n > size)) return false;
+
+        u8 le[sizeof(u64)], be[sizeof(u64)];
+
+        for(size_t i = 0; i < n; i++)
+        {
+            le[i] = static_cast<u8>(value >> (i * 8));
+            be[n - i - 1] = le[i];
+        }
+
+        for(const u8* encoded : { le, be })
+        {
+            for(size_t i = 0; (i + n) <= size; i++)
+            {
+                if(std::memcmp(data + i, encoded, n)) continue;
+                std::fill_n(mask + i, n, 0);
+                return true;
+            }
+        }
+
+        return false;
+    };
+
+    if(clear(address, width)) return true; // Absolute
+    if((width > sizeof(u32)) && (address <= std::numeric_limits<u32>::max()) && clear(address, sizeof(u32))) return true; // 32 bit immediate
+
+    // Relative to the next instruction
+    auto disp = static_cast<s64>(address - nextaddress);
+    if((disp < std::numeric_limits<s32>::min()) || (disp > std::numeric_limits<s32>::max())) return false;
+    return clear(static_cast<u32>(disp), sizeof(u32));
+}
+
+u32 SignatureDatabase::maskedCrc(const u8* data, const u8* mask, size_t size)
+{
+    if(!mask) return Hash::crc32(data, size);
+
+    std::vector<u8> masked(data, data + size);
+    for(size_t i = 0; i < size; i++) masked[i] &= mask[i];
+    return Hash::crc32(masked.data(), masked.size());
+}
+
+void SignatureDatabase::index(size_t idx)
+{
+    const Signature& sig = m_signatures[idx];
+    u8 keymask = static_cast<u8>(sig.fixedmask & ((1u << std::min<size_t>(sig.size, SIGNATURE_KEY_SIZE)) - 1));
+
+    if(std::find(m_keymasks.begin(), m_keymasks.end(), keymask) == m_keymasks.end())
+        m_keymasks.push_back(keymask);
+
+    m_index.emplace(SignatureDatabase::key(sig.prefix, sig.size, keymask), static_cast<u32>(idx));
+}
+
+u64 SignatureDatabase::key(const u8* data, size_t size, u8 keymask)
+{
+    u64 k = keymask;
+
+    for(size_t i = 0; i < SIGNATURE_KEY_SIZE; i++)
+    {
+        u8 b = ((keymask & (1u << i)) && (i < size)) ? data[i] : 0;
+        k = (k << 8) ^ (k >> 56) ^ b;
+    }
+
+    return k;
+}
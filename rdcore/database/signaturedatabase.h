@@ -0,0 +1,70 @@
+#pragma once
+
+#include <unordered_map>
+#include <filesystem>
+#include <vector>
+#include <string>
+#include <rdapi/types.h>
+
+#define SIGNATURE_FOLDER_NAME "signatures"
+#define SIGNATURE_EXT         ".rdsig"
+#define SIGNATURE_MAGIC       "RDSG"
+#define SIGNATURE_VERSION     2 // CRCs cover masked bytes
+#define SIGNATURE_PREFIX_SIZE 32 // Masked bytes at function start
+#define SIGNATURE_KEY_SIZE    8  // Bytes hashed by the index
+#define SIGNATURE_MIN_SIZE    8
+#define SIGNATURE_ID_SIZE     32
+
+namespace fs = std::filesystem;
+
+struct RDBufferView;
+
+class SignatureDatabase
+{
+    public:
+#pragma pack(push, 1)
+        struct Header {
+            char magic[4];
+            u16 version;
+            u16 reserved;
+            u32 count;
+            u32 namessize;
+            char assembler[SIGNATURE_ID_SIZE];
+        };
+
+        struct Signature {
+            u8 prefix[SIGNATURE_PREFIX_SIZE];
+            u32 fixedmask;                        // Bit N set: prefix[N] must match, clear for addresses and relocations
+            u16 size;                             // Prefix bytes in use
+            u16 crcsize;                          // Bytes after the prefix covered by 'crc'
+            u32 crc;                              // Variable bytes are hashed as zero
+            u32 name;                             // Offset in the names table
+        };
+#pragma pack(pop)
+
+    public:
+        SignatureDatabase() = default;
+        bool load(const fs::path& filepath); // Appends, the file must target the same assembler
+        bool save(const fs::path& filepath) const;
+        bool add(const u8* data, const u8* mask, size_t size, const std::string& name); // 'mask': zero for variable bytes, null if all are fixed
+        const char* match(const RDBufferView* view, const u8* mask = nullptr, size_t length = RD_NVAL) const; // 'length': function size, if known
+        const std::string& assembler() const;
+        void setAssembler(const std::string& assembler);
+        size_t size() const;
+
+    public:
+        static bool maskAddress(const u8* data, u8* mask, size_t size, rd_address address, rd_address nextaddress, size_t width); // Clears the bytes of one instruction that encode 'address'
+
+    private:
+        bool matchSignature(const Signature& sig, const RDBufferView* view, const u8* mask, size_t length) const;
+        void index(size_t idx);
+        static u32 maskedCrc(const u8* data, const u8* mask, size_t size);
+        static u64 key(const u8* data, size_t size, u8 keymask);
+
+    private:
+        std::string m_assembler;
+        std::vector<Signature> m_signatures;
+        std::vector<char> m_names;
+        std::vector<u8> m_keymasks;                  // Distinct masks over the first SIGNATURE_KEY_SIZE bytes
+        std::unordered_multimap<u64, u32> m_index;
+};
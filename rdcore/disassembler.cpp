@@ -4,17 +4,27 @@
 #include "context.h"
 #include "database/addressdatabase.h"
 #include "document/document.h"
-#include "builtin/graph/functiongraph/functiongraph.h"
 #include "support/utils.h"
 #include <deque>
 
 Disassembler::Disassembler(Context* ctx): Object(ctx) { }
+Disassembler::~Disassembler() { this->stop(); } // Join the worker before the algorithm goes away
 Assembler* Disassembler::assembler() const { return m_assembler.get(); }
 Loader* Disassembler::loader() const { return m_loader.get(); }
 SafeAlgorithm& Disassembler::algorithm() { return m_algorithm; }
 bool Disassembler::isWeak() const { return m_engine ? m_engine->isWeak() : false; }
 bool Disassembler::disassembling() const { return m_engine ? m_engine->disassembling() : false; }
 bool Disassembler::busy() const { return m_engine ? m_engine->busy() : false; }
+bool Disassembler::paused() const { return m_engine ? m_engine->paused() : false; }
+void Disassembler::setPaused(bool b) { if(m_engine) m_engine->setPaused(b); }
+
+bool Disassembler::analysisStatus(RDAnalysisStatus* status) const
+{
+    if(!m_engine || !status) return false;
+    *status = m_engine->status();
+    return true;
+}
+
 void Disassembler::enqueue(rd_address address) { m_algorithm->enqueue(address); }
 
 bool Disassembler::disassembleFunction(rd_address address)
@@ -33,11 +43,23 @@ void Disassembler::disassembleAt(rd_address address)
 
 void Disassembler::disassemble()
 {
-    if(this->ignite()) return;
+    if(this->ignite(false) || !this->prepare()) return;
+    m_engine->execute();
+}
 
+void Disassembler::disassembleAsync()
+{
+    if(this->ignite(true) || !this->prepare()) return;
+    m_engine->executeAsync();
+}
+
+bool Disassembler::prepare()
+{
     auto& doc = this->document();
     m_engine.reset(new Engine(this->context()));
-    if(!doc->getSegments(nullptr)) return;
+    if(!doc->getSegments(nullptr)) return false;
+
+    if(m_engine->restore()) return true;
 
     const rd_address* addresses = nullptr;
     size_t c = doc->getLabelsByFlag(AddressFlags_Exported, &addresses);
@@ -47,10 +69,10 @@ void Disassembler::disassemble()
 
     c = doc->getFunctions(&addresses); // Preload functions for analysis
     for(size_t i = 0; i < c; i++) m_algorithm->enqueue(addresses[i]);
-
-    m_engine->execute();
+    return true;
 }
 
+void Disassembler::wait() { if(m_engine) m_engine->wait(); }
 void Disassembler::stop() { if(m_engine) m_engine->stop(); }
 
 const char* Disassembler::getFunctionHexDump(rd_address address, rd_address* resaddress) const
@@ -73,42 +95,37 @@ const char* Disassembler::getFunctionHexDump(rd_address address, rd_address* res
 void Disassembler::setWeak(bool b) { if(m_engine) m_engine->setWeak(b); }
 bool Disassembler::encode(RDEncodedInstruction* encoded) const { return m_assembler->encode(encoded); }
 
-bool Disassembler::ignite()
+bool Disassembler::ignite(bool async)
 {
     if(!m_engine) return false;
 
     // Just wake up the engine, if not busy
-    if(!m_engine->busy()) m_engine->execute(Engine::State_Algorithm);
+    if(!m_engine->busy())
+    {
+        if(async) m_engine->executeAsync(Engine::State_Algorithm);
+        else m_engine->execute(Engine::State_Algorithm);
+    }
+
     return true;
 }
 
 bool Disassembler::getFunctionBytes(rd_address& address, RDBufferView* view) const
 {
-    RDLocation loc = this->document()->getFunctionStart(address);
-    if(!loc.valid) return { };
-
-    const auto* graph = this->document()->getGraph(loc.address);
-    if(!graph) return { };
-
-    const RDGraphNode* nodes = nullptr;
-    size_t c = graph->nodes(&nodes);
+    FunctionBounds fb;
+    RDLocation loc = this->document()->getFunctionBounds(address, &fb);
+    if(!loc.valid || fb.blocks.empty()) return { };
 
     rd_address startaddress = RD_NVAL, endaddress = RD_NVAL;
 
-    for(size_t i = 0; i < c; i++)
+    for(const auto& [blockstart, blockend] : fb.blocks)
     {
-        const auto* fbb = reinterpret_cast<const FunctionBasicBlock*>(graph->data(nodes[i])->p_data);
-        if(!fbb) return { };
+        if((startaddress == RD_NVAL) || (startaddress > blockstart))
+            startaddress = blockstart;
 
-        if((startaddress == RD_NVAL) || (startaddress > fbb->startaddress))
-            startaddress = fbb->startaddress;
-
-        if((endaddress == RD_NVAL) || (endaddress < fbb->endaddress))
-            endaddress = fbb->endaddress;
+        if((endaddress == RD_NVAL) || (endaddress < blockend))
+            endaddress = blockend;
     }
 
-    if((startaddress == RD_NVAL) || (endaddress == RD_NVAL)) return { };
-
     address = loc.address;
     return this->document()->getView(startaddress, (endaddress - startaddress) + 1, view);
 }
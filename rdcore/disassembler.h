@@ -12,6 +12,7 @@ class Disassembler: public Object
 {
     public:
         Disassembler(Context* ctx);
+        ~Disassembler();
         Assembler* assembler() const;
         Loader* loader() const;
         SafeAlgorithm& algorithm();
@@ -22,24 +23,30 @@ class Disassembler: public Object
     public:
         bool disassembleFunction(rd_address address);
         const char* getFunctionHexDump(rd_address address, rd_address* resaddress) const;
+        bool getFunctionBytes(rd_address& address, RDBufferView* view) const;
 
     public: // Engine/Algorithm
         void setWeak(bool b);
         bool isWeak() const;
         bool disassembling() const;
         bool busy() const;
+        bool paused() const;
+        void setPaused(bool b);
+        bool analysisStatus(RDAnalysisStatus* status) const;
         void enqueue(rd_address address);
         void disassembleBlock(const RDBlock* block);
         void disassembleAt(rd_address address);
         void disassemble();
+        void disassembleAsync();
+        void wait();
         void stop();
 
     public: // Assembler
         bool encode(RDEncodedInstruction* encoded) const;
 
     private:
-        bool ignite();
-        bool getFunctionBytes(rd_address& address, RDBufferView* view) const;
+        bool prepare();
+        bool ignite(bool async);
 
     private:
         std::unique_ptr<Engine> m_engine;
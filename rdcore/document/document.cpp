@@ -1,12 +1,13 @@
 #include "document.h"
 #include "../database/addressdatabase.h"
 #include "../plugin/assembler.h"
+#include "../plugin/analyzer.h"
 #include "../plugin/loader.h"
 #include "../support/utils.h"
 #include "../disassembler.h"
 #include "../context.h"
 
-Document::Document(const MemoryBufferPtr& buffer, Context* ctx): Object(ctx), m_buffer(buffer), m_addressspace(ctx), m_net(ctx) { }
+Document::Document(const MemoryBufferPtr& buffer, Context* ctx): Object(ctx), m_buffer(buffer), m_functions(ctx), m_addressspace(ctx), m_net(ctx) { }
 rd_endianness Document::endianness() const { return m_endianness; }
 void Document::setEndianness(rd_endianness endianness) { m_endianness = endianness; }
 MemoryBuffer* Document::buffer() const { return m_buffer.get(); }
@@ -66,7 +67,9 @@ bool Document::setSegment(const std::string& name, rd_offset offset, rd_address
 
 void Document::setFunction(rd_address address, const std::string& label)
 {
+    size_t oldcount = m_functions.size();
     m_functions.insert(address);
+    if(m_functions.size() != oldcount) m_functionsrevision++;
     this->setLabel(address, AddressFlags_Function, label.empty() ? Document::makeLabel(address, "sub") : label);
 }
 
@@ -132,7 +135,18 @@ void Document::setEntry(rd_address address)
     m_entry = { {address}, true };
 }
 
-void Document::setGraph(FunctionGraph* g) { m_functions.bind(g->startAddress(), g); }
+void Document::setFunctionBounds(rd_address address, FunctionBounds fb, std::vector<rd_address> calls)
+{
+    m_callgraph.update(address, std::move(calls));
+    m_functions.setBounds(address, std::move(fb));
+}
+
+void Document::setFunctionBounds(FunctionContainer::Values bounds, CallGraphIndex::Calls calls)
+{
+    m_callgraph.update(std::move(calls));
+    m_functions.setBounds(std::move(bounds));
+}
+
 const char16_t* Document::readWString(rd_address address, size_t* len) const { return this->readStringT<char16_t>(address, len); }
 const char* Document::readString(rd_address address, size_t* len) const { return this->readStringT<char>(address, len); }
 std::string Document::readWString(rd_address address, size_t len) const { const char16_t* s = this->readWString(address, &len); return s ? Utils::toString(std::u16string(s, len)) : std::string(); }
@@ -176,8 +190,8 @@ size_t Document::getFunctions(const rd_address** addresses) const { return m_fun
 
 size_t Document::getFunctionInstrCount(rd_address address) const
 {
-    auto* g = this->getGraph(address);
-    return g ? g->blocksCount() : 0;
+    FunctionBounds fb;
+    return this->getFunctionBounds(address, &fb).valid ? fb.blocks.size() : 0;
 }
 
 rd_address Document::getAddress(const std::string& label) const { return this->addressDatabase()->getAddress(label); }
@@ -227,15 +241,16 @@ const Type* Document::getType(rd_address address) const { return this->addressDa
 
 bool Document::setTypeName(rd_address address, const std::string& q)
 {
-    RDDatabaseValue v;
-
-    if(this->context()->database()->query(q, &v) && v.t && (v.type == DatabaseValueType_Type))
-        return this->setType(address, CPTR(const Type, v.t));
+    auto type = this->context()->database()->findType(q);
+    return type ? this->setTypeFields(address, type, 0) : false; // Interned: no copies
+}
 
-    return false;
+bool Document::setType(rd_address address, const Type* type)
+{
+    if(!type) return false;
+    return this->setTypeFields(address, SharedTypePtr(type->clone(this->context())), 0); // Caller keeps ownership
 }
 
-bool Document::setType(rd_address address, const Type* type) { return this->setTypeFields(address, type, 0); }
 bool Document::findLabel(const std::string& q, rd_address* resaddress) const { return this->addressDatabase()->findLabel(q, resaddress); }
 bool Document::findLabelR(const std::string& q, rd_address* resaddress) const { return this->addressDatabase()->findLabelR(q, resaddress); }
 size_t Document::findLabels(const std::string& q, const rd_address** resaddresses) const { return this->addressDatabase()->findLabels(q, resaddresses); }
@@ -284,27 +299,14 @@ rd_address Document::checkLocation(rd_address fromaddress, rd_address address, s
     return resaddress;
 }
 
-void Document::checkTypeName(rd_address fromaddress, rd_address address, const char* q)
-{
-    if(!q || (fromaddress == address)) return; // Ignore self references
-
-    RDSegment segment;
-    if(!this->addressToSegment(address, &segment)) return;
-
-    if(!this->setTypeName(address, q)) return;
-
-    m_net.addRef(fromaddress, address);
-    spdlog::info("Document::checkTypeName({:x}, {:x})", fromaddress, address);
-}
-
-void Document::checkType(rd_address fromaddress, rd_address address, const Type* t)
+void Document::checkType(rd_address fromaddress, rd_address address, const SharedTypePtr& t)
 {
     if(!t || (fromaddress == address)) return; // Ignore self references
 
     RDSegment segment;
     if(!this->addressToSegment(address, &segment)) return;
 
-    if(!this->setType(address, t)) return;
+    if(!this->setTypeFields(address, t, 0)) return; // Shared with the emulate result, no copies
 
     m_net.addRef(fromaddress, address);
     spdlog::info("Document::checkType({:x}, {:x}): '{}'", fromaddress, address, t->name());
@@ -346,17 +348,17 @@ size_t Document::checkTable(rd_address fromaddress, rd_address address, size_t s
     return i;
 }
 
-bool Document::setTypeFields(rd_address address, const Type* type, int level)
+bool Document::setTypeFields(rd_address address, const SharedTypePtr& type, int level)
 {
     if(!type) return false;
 
-    if(auto* stt = dynamic_cast<const StructureType*>(type))
+    if(auto* stt = dynamic_cast<const StructureType*>(type.get()))
     {
         rd_address fieldaddress = address;
 
         for(const auto& [n, f] : stt->fields())
         {
-            this->setTypeFields(fieldaddress, f, level + 1);
+            this->setTypeFields(fieldaddress, SharedTypePtr(type, f), level + 1); // Fields share the structure's lifetime
             RDLocation loc{ };
 
             if(f->bits() == this->context()->bits())
@@ -373,15 +375,16 @@ bool Document::setTypeFields(rd_address address, const Type* type, int level)
             fieldaddress += f->size();
         }
 
-        this->addressDatabase()->setType(address, stt, level ? std::string() : Document::makeLabel(address, stt->autoName()));
+        this->addressDatabase()->setType(address, type, level ? std::string() : Document::makeLabel(address, stt->autoName()));
     }
-    else if(auto* at = dynamic_cast<const ArrayType*>(type))
+    else if(auto* at = dynamic_cast<const ArrayType*>(type.get()))
     {
         rd_address itemaddress = address;
+        SharedTypePtr itemtype(type, at->type());
 
         for(size_t i = 0; i < at->itemsCount(); i++)
         {
-            this->setType(itemaddress, at->type());
+            this->setTypeFields(itemaddress, itemtype, 0);
             this->addressDatabase()->updateLabel(itemaddress, Document::makeLabel(itemaddress, at->type()->autoName() + "_" + std::to_string(i)));
 
             if(!level && i == (at->itemsCount() - 1))
@@ -390,12 +393,12 @@ bool Document::setTypeFields(rd_address address, const Type* type, int level)
             itemaddress += at->type()->size();
         }
 
-        this->addressDatabase()->setType(address, at, Document::makeLabel(address, at->autoName()));
+        this->addressDatabase()->setType(address, type, Document::makeLabel(address, at->autoName()));
     }
-    else if(auto* str = dynamic_cast<const StringType*>(type))
+    else if(auto* str = dynamic_cast<const StringType*>(type.get()))
     {
-        TypePtr cst(str->clone(this->context()));
-        static_cast<StringType*>(cst.get())->calculateSize(address);
+        std::shared_ptr<StringType> cst(static_cast<StringType*>(str->clone(this->context()))); // Size depends on the address
+        cst->calculateSize(address);
 
         switch(cst->type())
         {
@@ -411,12 +414,12 @@ bool Document::setTypeFields(rd_address address, const Type* type, int level)
         }
 
         if(m_addressspace.markData(address, type->size()))
-            this->addressDatabase()->setTypeField(address, cst.get(), level, Document::makeLabel(address, cst->autoName())); // Take copy
+            this->addressDatabase()->setTypeField(address, cst, level, Document::makeLabel(address, cst->autoName()));
     }
-    else if(auto* nt = dynamic_cast<const NumericType*>(type))
+    else if(auto* nt = dynamic_cast<const NumericType*>(type.get()))
     {
         if(m_addressspace.markData(address, type->size()))
-            this->addressDatabase()->setTypeField(address, nt, level, Document::makeLabel(address, nt->autoName()));
+            this->addressDatabase()->setTypeField(address, type, level, Document::makeLabel(address, nt->autoName()));
     }
     else
     {
@@ -470,7 +473,11 @@ bool Document::checkPointer(rd_address fromaddress, rd_address address, size_t s
 }
 
 FunctionGraph* Document::getGraph(rd_address address) const { return m_functions.getGraph(address); }
+size_t Document::getCallers(rd_address address, const rd_address** addresses) const { return m_callgraph.callers(address, addresses); }
+size_t Document::getCallees(rd_address address, const rd_address** addresses) const { return m_callgraph.callees(address, addresses); }
 RDLocation Document::getFunctionStart(rd_address address) const { return m_functions.getFunction(address); }
+RDLocation Document::getFunctionBounds(rd_address address, FunctionBounds* fb) const { return m_functions.getBounds(address, fb); }
+size_t Document::getFunctionStarts(const rd_address* addresses, size_t count, rd_address* starts) const { return m_functions.getFunctions(addresses, count, starts); }
 
 RDLocation Document::dereference(rd_address address) const
 {
@@ -493,7 +500,17 @@ std::string Document::getHexDump(rd_address address, size_t size) const
     return hexdump.c_str();
 }
 
-void Document::invalidateGraphs() { m_functions.invalidateGraphs(); }
+size_t Document::revision(rd_flag resources) const
+{
+    size_t rev = 0; // Counters only grow, their sum changes when any of them does
+    if(resources & AnalyzerResources_Code) rev += m_addressspace.codeRevision() + m_functionsrevision;
+    if(resources & AnalyzerResources_Data) rev += m_addressspace.dataRevision();
+    if(resources & AnalyzerResources_Labels) rev += this->addressDatabase()->labelsRevision();
+    if(resources & AnalyzerResources_Net) rev += m_net.revision();
+    return rev;
+}
+
+bool Document::restoreBlocks(rd_address address, const RDBlock* blocks, size_t count) { return m_addressspace.restoreBlocks(address, blocks, count); }
 
 size_t Document::checkString(rd_address address, rd_flag* resflags)
 {
@@ -3,6 +3,7 @@
 #include "document_fwd.h"
 #include "documentnet.h"
 #include "model/functioncontainer.h"
+#include "model/callgraphindex.h"
 #include "model/addressspace.h"
 #include "../engine/stringfinder.h"
 #include "../types/definitions.h"
@@ -10,6 +11,7 @@
 #include <rdapi/support/utils.h>
 #include <functional>
 #include <optional>
+#include <atomic>
 
 #define COMMENT_SEPARATOR  " | "
 
@@ -44,7 +46,8 @@ class Document: public Object
         void setExported(rd_address address, size_t size, const std::string& label = std::string());
         void setImported(rd_address address, size_t size, const std::string& label = std::string());
         void setEntry(rd_address address);
-        void setGraph(FunctionGraph* g);
+        void setFunctionBounds(rd_address address, FunctionBounds fb, std::vector<rd_address> calls);
+        void setFunctionBounds(FunctionContainer::Values bounds, CallGraphIndex::Calls calls); // Replaces every function
         void setComments(rd_address address, const std::string& s);
         void addComment(rd_address address, const std::string& s);
         bool createFunction(rd_address address, const std::string& label);
@@ -96,19 +99,25 @@ class Document: public Object
         size_t findLabelsR(const std::string& q, const rd_address** resaddresses) const;
         rd_address checkData(rd_address fromaddress, rd_address address, size_t size = RD_NVAL);
         rd_address checkLocation(rd_address fromaddress, rd_address address, size_t size = RD_NVAL, bool dataonly = false);
-        void checkTypeName(rd_address fromaddress, rd_address address, const char* q);
-        void checkType(rd_address fromaddress, rd_address address, const Type* t);
+        void checkType(rd_address fromaddress, rd_address address, const SharedTypePtr& t);
         void checkString(rd_address fromaddress, rd_address address, size_t size = RD_NVAL);
         size_t checkTable(rd_address fromaddress, rd_address address, size_t size, const TableCallback& cb);
         bool checkPointer(rd_address fromaddress, rd_address address, size_t size, rd_address* firstaddress);
         FunctionGraph* getGraph(rd_address address) const;
+        size_t getCallers(rd_address address, const rd_address** addresses) const;
+        size_t getCallees(rd_address address, const rd_address** addresses) const;
         RDLocation getFunctionStart(rd_address address) const;
+        RDLocation getFunctionBounds(rd_address address, FunctionBounds* fb) const;
+        size_t getFunctionStarts(const rd_address* addresses, size_t count, rd_address* starts) const;
         std::string getHexDump(rd_address address, size_t size) const;
         RDLocation dereference(rd_address address) const;
-        void invalidateGraphs();
+        size_t revision(rd_flag resources) const;
+
+    public: // Serialization
+        bool restoreBlocks(rd_address address, const RDBlock* blocks, size_t count);
 
     private:
-        bool setTypeFields(rd_address address, const Type* type, int level);
+        bool setTypeFields(rd_address address, const SharedTypePtr& type, int level);
         bool readAddress(rd_address address, u64 *value) const;
         RDLocation dereferenceAddress(rd_address address) const;
         size_t checkString(rd_address address, rd_flag* resflags);
@@ -124,8 +133,10 @@ class Document: public Object
         RDLocation m_entry{ };
         MemoryBufferPtr m_buffer;
         FunctionContainer m_functions;
+        CallGraphIndex m_callgraph;
         AddressSpace m_addressspace;
         DocumentNet m_net;
+        std::atomic<size_t> m_functionsrevision{0};
 };
 
 template<typename T>
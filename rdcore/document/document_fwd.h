@@ -6,6 +6,6 @@
 class Document;
 class DocumentNet;
 
-typedef safe_ptr<Document> SafeDocument;
+typedef shared_safe_ptr<Document> SafeDocument;
 using s_lock_document = s_locked_safe_ptr<SafeDocument>;
 using x_lock_document = x_locked_safe_ptr<SafeDocument>;
@@ -17,6 +17,7 @@ bool DocumentNet::unlinkPrev(rd_address address)
     if(nit == m_netnodes.end()) return false;
 
     auto& n = nit->second;
+    m_revision++;
 
     for(size_t i = 0; i < n.prev.size(); )
     {
@@ -43,6 +44,7 @@ bool DocumentNet::unlinkNext(rd_address address)
     rd_address nextaddress = it->second.next;
     if(nextaddress == RD_NVAL) return true;
     it->second.next = RD_NVAL;
+    m_revision++;
 
     it = m_netnodes.find(nextaddress);
     if(it == m_netnodes.end()) return false;
@@ -118,6 +120,7 @@ void DocumentNet::addRef(rd_address fromaddress, rd_address toaddress, rd_flag f
 
     spdlog::info("DocumentNet::addRef({:x}, {:x}, {:x})", fromaddress, toaddress, flags);
     m_refs[toaddress].insert({fromaddress, flags});
+    m_revision++;
 }
 
 void DocumentNet::removeRef(rd_address fromaddress, rd_address toaddress)
@@ -131,7 +134,9 @@ void DocumentNet::removeRef(rd_address fromaddress, rd_address toaddress)
         return r.address == fromaddress;
     });
 
-    if(it != refs.end()) refs.remove(*it);
+    if(it == refs.end()) return;
+    refs.remove(*it);
+    m_revision++;
 }
 
 const DocumentNetNode* DocumentNet::findNode(rd_address address) const
@@ -159,6 +164,24 @@ size_t DocumentNet::getReferences(rd_address address, const RDReference** refs)
     return it->second.data(refs);
 }
 
+size_t DocumentNet::revision() const { return m_revision; }
+const DocumentNet::NetNodes& DocumentNet::nodes() const { return m_netnodes; }
+const DocumentNet::ReferencesMap& DocumentNet::references() const { return m_refs; }
+
+void DocumentNet::restoreNode(DocumentNetNode&& node)
+{
+    rd_address address = node.address;
+    m_netnodes[address] = std::move(node);
+    m_revision++;
+}
+
+void DocumentNet::restoreReferences(rd_address address, const RDReference* refs, size_t count)
+{
+    auto& r = m_refs[address];
+    for(size_t i = 0; i < count; i++) r.insert(refs[i]);
+    m_revision++;
+}
+
 bool DocumentNet::isConditional(const DocumentNetNode* n) { return DocumentNet::isBranch(n) && (!n->branchestrue.empty() && !n->branchesfalse.empty()); }
 
 bool DocumentNet::isBranch(const DocumentNetNode* n)
@@ -184,5 +207,6 @@ DocumentNetNode& DocumentNet::n(rd_address address)
 {
     auto& nn = m_netnodes[address];
     nn.address = address;
+    m_revision++; // Callers always modify the node
     return nn;
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <unordered_map>
 #include <rdapi/types.h>
 #include "../engine/algorithm/emulateresult.h"
@@ -32,9 +33,10 @@ struct ReferenceSorter {
 
 class DocumentNet: public Object
 {
-    private:
+    public:
         typedef SortedContainer<RDReference, ReferenceComparator, ReferenceSorter, true> References;
         typedef std::unordered_map<rd_address, References> ReferencesMap;
+        typedef std::unordered_map<rd_address, DocumentNetNode> NetNodes;
 
     public:
         DocumentNet(Context* ctx);
@@ -55,6 +57,13 @@ class DocumentNet: public Object
         const DocumentNetNode* prevNode(const DocumentNetNode* n) const;
         const DocumentNetNode* nextNode(const DocumentNetNode* n) const;
         size_t getReferences(rd_address address, const RDReference** refs) const;
+        size_t revision() const;
+
+    public: // Serialization
+        const NetNodes& nodes() const;
+        const ReferencesMap& references() const;
+        void restoreNode(DocumentNetNode&& node);
+        void restoreReferences(rd_address address, const RDReference* refs, size_t count);
 
     public:
         static bool isConditional(const DocumentNetNode* n);
@@ -65,7 +74,8 @@ class DocumentNet: public Object
         DocumentNetNode& n(rd_address address);
 
     private:
-        std::unordered_map<rd_address, DocumentNetNode> m_netnodes;
+        NetNodes m_netnodes;
         ReferencesMap m_refs;
+        std::atomic<size_t> m_revision{0};
 };
 
@@ -1,5 +1,6 @@
 #include "addressspace.h"
 #include "../../support/utils.h"
+#include "../../surface/instructioncache.h"
 #include "../../context.h"
 #include <algorithm>
 #include <tuple>
@@ -16,7 +17,10 @@ bool AddressSpace::markUnknown(rd_address address, size_t size)
     auto* blocks = this->findBlocks(address);
     if(!blocks) return false;
 
+    this->invalidate(address, size);
     blocks->unknownSize(address, size);
+    m_coderevision++;
+    m_datarevision++;
     return true;
 }
 
@@ -25,7 +29,9 @@ bool AddressSpace::markExplored(rd_address address, size_t size)
     auto* blocks = this->findBlocks(address);
     if(!blocks) return false;
 
+    this->invalidate(address, size);
     blocks->exploredSize(address, size);
+    m_coderevision++;
     return true;
 }
 
@@ -34,7 +40,9 @@ bool AddressSpace::markCode(rd_address address, size_t size, u16 info)
     auto* blocks = this->findBlocks(address);
     if(!blocks) return false;
 
+    this->invalidate(address, size);
     blocks->codeSize(address, size, info);
+    m_coderevision++;
     return true;
 }
 
@@ -43,7 +51,9 @@ bool AddressSpace::markData(rd_address address, size_t size)
     auto* blocks = this->findBlocks(address);
     if(!blocks) return false;
 
+    this->invalidate(address, size);
     blocks->dataSize(address, size);
+    m_datarevision++;
     return true;
 }
 
@@ -52,7 +62,9 @@ bool AddressSpace::markString(rd_address address, size_t size)
     auto* blocks = this->findBlocks(address);
     if(!blocks) return false;
 
+    this->invalidate(address, size);
     blocks->stringSize(address, size);
+    m_datarevision++;
     return true;
 }
 
@@ -61,7 +73,21 @@ bool AddressSpace::markInfo(rd_address address, rd_type type, u16 info)
     auto* blocks = this->findBlocks(address);
     if(!blocks) return false;
 
+    this->invalidate(address, 1);
     blocks->info(address, type, info);
+    m_coderevision++;
+    return true;
+}
+
+bool AddressSpace::restoreBlocks(rd_address address, const RDBlock* blocks, size_t count)
+{
+    auto* b = this->findBlocks(address);
+    if(!b) return false;
+
+    if(count) this->invalidate(blocks[0].start, blocks[count - 1].end - blocks[0].start);
+    b->restore(blocks, count);
+    m_coderevision++;
+    m_datarevision++;
     return true;
 }
 
@@ -95,6 +121,9 @@ bool AddressSpace::insert(const RDSegment& segment)
         m_buffers.emplace(segment.address, AddressSpace::addressSize(segment));
 
 
+    m_coderevision++;
+    m_datarevision++;
+
     spdlog::info("Creating segment '{}' @ {:x} -> {:x}", segment.name, segment.address, segment.endaddress);
     return true;
 }
@@ -178,6 +207,8 @@ rd_address AddressSpace::lastAddress() const
 }
 
 size_t AddressSpace::size() const { return m_segments.size(); }
+size_t AddressSpace::codeRevision() const { return m_coderevision; }
+size_t AddressSpace::dataRevision() const { return m_datarevision; }
 size_t AddressSpace::data(const rd_address** addresses) const { return m_segments.data(addresses); }
 size_t AddressSpace::indexOfSegment(const RDSegment* segment) const { return segment ? m_segments.indexOf(segment->address) : RD_NVAL; }
 
@@ -312,3 +343,15 @@ const MemoryBuffer* AddressSpace::getBuffer(rd_address address) const
     auto it = m_buffers.find(address);
     return (it != m_buffers.end()) ? std::addressof(it->second) : nullptr;
 }
+
+void AddressSpace::invalidate(rd_address address, size_t size) const
+{
+    auto* cache = this->context()->instructionCache();
+    if(!cache) return;
+
+    // Blocks around the range can be split or merged too
+    RDBlock first, last;
+    rd_address startaddress = this->addressToBlock(address, &first) ? first.start : address;
+    rd_address endaddress = this->addressToBlock(address + std::max<size_t>(size, 1) - 1, &last) ? last.end : (address + size);
+    cache->invalidate(startaddress, std::max(endaddress, address + size));
+}
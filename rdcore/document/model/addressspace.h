@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <unordered_map>
 #include "../../containers/addresscontainer.h"
 #include "../../buffer/buffer.h"
@@ -24,6 +25,8 @@ class AddressSpace: public Object
     public:
         bool empty() const;
         size_t size() const;
+        size_t codeRevision() const;
+        size_t dataRevision() const;
         const BlockContainer* getBlocks(rd_address address) const;
         const BlockContainer* getBlocksAt(size_t index) const;
         std::string defaultAssembler() const;
@@ -48,6 +51,7 @@ class AddressSpace: public Object
 
     public: // Serialization
         const MemoryBuffer* getBuffer(rd_address address) const;
+        bool restoreBlocks(rd_address address, const RDBlock* blocks, size_t count);
 
     public:
         static size_t addressSize(const RDSegment& segment);
@@ -55,8 +59,12 @@ class AddressSpace: public Object
         static bool containsAddress(const RDSegment* segment, rd_address address);
         static bool containsOffset(const RDSegment* segment, rd_offset offset);
 
+    private:
+        void invalidate(rd_address address, size_t size) const;
+
     private:
         AddressContainer<RDSegment> m_segments;
         std::unordered_map<rd_address, MemoryBuffer> m_buffers;
         std::unordered_map<rd_address, BlockContainer> m_blocks;
+        std::atomic<size_t> m_coderevision{0}, m_datarevision{0}; // Bumped on every change, see Engine::analyzeAll()
 };
@@ -33,6 +33,17 @@ void BlockContainer::info(rd_address address, rd_type type, u16 info)
     else REDasmError("Cannot set info: found an invalid block", address);
 }
 
+void BlockContainer::restore(const RDBlock* blocks, size_t count)
+{
+    m_container.clear();
+
+    for(size_t i = 0; i < count; i++) // Saved in order, append at the end
+    {
+        if(BlockContainer::empty(&blocks[i])) continue;
+        m_container.insert(m_container.end(), blocks[i]);
+    }
+}
+
 size_t BlockContainer::size() const { return m_container.size(); }
 bool BlockContainer::empty() const { return m_container.empty(); }
 
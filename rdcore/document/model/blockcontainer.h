@@ -33,6 +33,7 @@ class BlockContainer: public TreeContainer<RDBlock, BlockSorter>
         void codeSize(rd_address start, size_t size, u16 info = 0);
         void stringSize(rd_address start, size_t size);
         void info(rd_address address, rd_type type, u16 info);
+        void restore(const RDBlock* blocks, size_t count);
         size_t size() const;
         bool empty() const;
 
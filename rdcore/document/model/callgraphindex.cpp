@@ -0,0 +1,182 @@
+#include "callgraphindex.h"
+#include <algorithm>
+
+void CallGraphIndex::update(rd_address function, std::vector<rd_address> calls)
+{
+    std::sort(calls.begin(), calls.end());
+    calls.erase(std::unique(calls.begin(), calls.end()), calls.end());
+
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    auto& current = m_calls[function];
+    if(!m_dirty) this->patch(function, current, calls); // Rebuilt on the next query otherwise
+    current = std::move(calls);
+}
+
+void CallGraphIndex::update(Calls calls)
+{
+    for(auto& [function, callees] : calls)
+    {
+        std::sort(callees.begin(), callees.end());
+        callees.erase(std::unique(callees.begin(), callees.end()), callees.end());
+    }
+
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    m_calls = std::move(calls);
+    m_dirty = true;
+}
+
+void CallGraphIndex::clear()
+{
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    m_calls.clear();
+    m_rows.clear();
+    m_callees.clear();
+    m_callers.clear();
+    m_edges = 0;
+    m_edges = m_callees.size();
+    m_dirty = false;
+}
+
+size_t CallGraphIndex::callees(rd_address address, const rd_address** addresses) const
+{
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    this->compact();
+
+    auto it = m_rows.find(address);
+    if(it == m_rows.end()) return 0;
+    if(addresses) *addresses = m_callees.data() + it->second.callees;
+    return it->second.ncallees;
+}
+
+size_t CallGraphIndex::callers(rd_address address, const rd_address** addresses) const
+{
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    this->compact();
+
+    auto it = m_rows.find(address);
+    if(it == m_rows.end()) return 0;
+    if(addresses) *addresses = m_callers.data() + it->second.callers;
+    return it->second.ncallers;
+}
+
+size_t CallGraphIndex::edges() const
+{
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    this->compact();
+    return m_edges;
+}
+
+void CallGraphIndex::patch(rd_address function, const std::vector<rd_address>& oldcalls, const std::vector<rd_address>& newcalls)
+{
+    std::vector<rd_address> changed;
+    std::set_difference(oldcalls.begin(), oldcalls.end(), newcalls.begin(), newcalls.end(), std::back_inserter(changed));
+    for(rd_address callee : changed) this->removeCaller(callee, function);
+
+    changed.clear();
+    std::set_difference(newcalls.begin(), newcalls.end(), oldcalls.begin(), oldcalls.end(), std::back_inserter(changed));
+    for(rd_address callee : changed) this->addCaller(callee, function);
+
+    auto& row = m_rows.try_emplace(function, Row{0, 0, 0, 0, 0, 0}).first->second;
+
+    if(newcalls.size() > row.capcallees) // Moved to the end, the old slots become holes
+    {
+        row.callees = m_callees.size();
+        row.capcallees = newcalls.size();
+        m_callees.insert(m_callees.end(), newcalls.begin(), newcalls.end());
+    }
+    else
+        std::copy(newcalls.begin(), newcalls.end(), m_callees.begin() + row.callees);
+
+    row.ncallees = newcalls.size();
+    m_edges = m_edges - oldcalls.size() + newcalls.size();
+
+    // Each edge is stored twice, everything else is a hole
+    size_t holes = (m_callees.size() + m_callers.size()) - (m_edges * 2);
+    if(holes > std::max<size_t>(CALL_GRAPH_INDEX_HOLES_MIN, m_edges)) m_dirty = true;
+}
+
+void CallGraphIndex::addCaller(rd_address callee, rd_address caller)
+{
+    auto& row = m_rows.try_emplace(callee, Row{0, 0, 0, 0, 0, 0}).first->second;
+    auto begin = m_callers.begin() + row.callers, end = begin + row.ncallers;
+    size_t idx = std::lower_bound(begin, end, caller) - begin;
+
+    if(row.ncallers < row.capcallers) // Room left: shift the tail
+    {
+        std::copy_backward(begin + idx, end, end + 1);
+        m_callers[row.callers + idx] = caller;
+        row.ncallers++;
+        return;
+    }
+
+    // Full: move the row to the end with room to grow, the old slots become holes
+    size_t start = m_callers.size();
+    size_t cap = std::max<size_t>(row.ncallers * 2, 4);
+    m_callers.resize(start + cap);
+
+    begin = m_callers.begin() + row.callers;
+    auto it = std::copy(begin, begin + idx, m_callers.begin() + start);
+    *it++ = caller;
+    std::copy(begin + idx, begin + row.ncallers, it);
+
+    row.callers = start;
+    row.capcallers = cap;
+    row.ncallers++;
+}
+
+void CallGraphIndex::removeCaller(rd_address callee, rd_address caller)
+{
+    auto it = m_rows.find(callee);
+    if(it == m_rows.end()) return;
+
+    auto& row = it->second;
+    auto begin = m_callers.begin() + row.callers, end = begin + row.ncallers;
+    auto cit = std::lower_bound(begin, end, caller);
+    if((cit == end) || (*cit != caller)) return;
+
+    std::copy(cit + 1, end, cit);
+    row.ncallers--;
+}
+
+void CallGraphIndex::compact() const
+{
+    if(!m_dirty) return;
+
+    m_rows.clear();
+    m_callees.clear();
+    m_callers.clear();
+
+    // Callees: functions are already sorted, copy them as they are
+    for(const auto& [address, calls] : m_calls)
+    {
+        m_rows[address] = { m_callees.size(), calls.size(), calls.size(), 0, 0, 0 };
+        m_callees.insert(m_callees.end(), calls.begin(), calls.end());
+    }
+
+    // Callers: count, prefix sum, fill (callers end up sorted by address)
+    for(rd_address callee : m_callees) m_rows.try_emplace(callee, Row{0, 0, 0, 0, 0, 0}).first->second.ncallers++;
+
+    size_t offset = 0;
+
+    for(auto& [address, row] : m_rows)
+    {
+        row.callers = offset;
+        row.capcallers = row.ncallers;
+        offset += row.ncallers;
+        row.ncallers = 0;
+    }
+
+    m_callers.resize(offset);
+
+    for(const auto& [address, calls] : m_calls)
+    {
+        for(rd_address callee : calls)
+        {
+            auto& row = m_rows[callee];
+            m_callers[row.callers + row.ncallers++] = address;
+        }
+    }
+
+    m_edges = m_callees.size();
+    m_dirty = false;
+}
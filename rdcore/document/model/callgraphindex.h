@@ -0,0 +1,43 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+#include <mutex>
+#include <map>
+#include <rdapi/types.h>
+
+#define CALL_GRAPH_INDEX_HOLES_MIN 1024 // Unused slots tolerated before the arrays are compacted again
+
+class CallGraphIndex // Function level calls in CSR arrays, patched in place and compacted when they fragment
+{
+    private:
+        struct Row { size_t callees, ncallees, capcallees, callers, ncallers, capcallers; };
+
+    public:
+        typedef std::map<rd_address, std::vector<rd_address>> Calls; // Function -> Callees
+
+    public:
+        CallGraphIndex() = default;
+        void update(rd_address function, std::vector<rd_address> calls);
+        void update(Calls calls); // Replaces every function
+        void clear();
+        size_t callees(rd_address address, const rd_address** addresses) const; // Valid until the next update
+        size_t callers(rd_address address, const rd_address** addresses) const; // Valid until the next update
+        size_t edges() const;
+
+    private:
+        void patch(rd_address function, const std::vector<rd_address>& oldcalls, const std::vector<rd_address>& newcalls);
+        void addCaller(rd_address callee, rd_address caller);
+        void removeCaller(rd_address callee, rd_address caller);
+        void compact() const;
+
+    private:
+        Calls m_calls; // Function -> Sorted callees
+
+    private: // CSR, rows have room to grow, moved rows leave holes behind
+        mutable std::unordered_map<rd_address, Row> m_rows;
+        mutable std::vector<rd_address> m_callees, m_callers;
+        mutable size_t m_edges{0};
+        mutable bool m_dirty{false};
+        mutable std::mutex m_mutex;
+};
@@ -1,53 +1,193 @@
 #include "functioncontainer.h"
+#include "../../support/utils.h"
+#include "../document.h"
+#include <algorithm>
+#include <stack>
+#include <set>
 
-FunctionGraph* FunctionContainer::getGraph(rd_address address) const
+bool FunctionBounds::isBasicBlockTail(rd_address address) const
+{
+    for(size_t i = 0; (blocks.size() > 1) && (i < blocks.size() - 1); i++) // Skip function's tail
+    {
+        if(blocks[i].second == address) return true;
+    }
+
+    return false;
+}
+
+bool FunctionBounds::build(const SafeDocument& doc, rd_address address, FunctionBounds* fb, std::vector<rd_address>* calls)
 {
-    auto it = m_values.lower_bound(address);
+    s_lock_document lock(doc); // The net and the blocks must not change while they are walked
 
-    if(it == m_values.end())
+    RDBlock startb;
+
+    if(!doc->addressToBlock(address, &startb) || !IS_TYPE(&startb, BlockType_Code))
+    {
+        spdlog::warn("FunctionBounds::build({:x}): Code block not found, skipping...", address);
+        return false;
+    }
+
+    const DocumentNet* net = doc->net();
+    std::set<rd_address> starts;
+    std::stack<rd_address> pending;
+    pending.push(startb.address);
+
+    while(!pending.empty()) // Same basic blocks as FunctionGraph::buildBasicBlocks()
     {
-        if(m_values.size() == 1) it = m_values.begin();
-        return nullptr;
+        rd_address a = pending.top();
+        pending.pop();
+
+        if(!Utils::isCode(doc, a) || starts.count(a)) continue;
+
+        const auto* n = net->findNode(a);
+        if(!n) continue;
+
+        starts.insert(a);
+
+        for( ; n; n = net->findNode(n->next))
+        {
+            for(rd_address jump : n->branchestrue) { if(Utils::isCode(doc, jump)) pending.push(jump); }
+            for(rd_address jump : n->branchesfalse) { if(Utils::isCode(doc, jump)) pending.push(jump); }
+        }
     }
 
-    // Search near this location (backwards)
-    while(!it->second->contains(address))
+    fb->blocks.clear();
+    fb->blocks.reserve(starts.size());
+
+    for(rd_address start : starts) // Sorted already
     {
-        if(it == m_values.begin())
+        rd_address a = start, end = start;
+
+        for(const auto* n = net->findNode(a); n && Utils::isCode(doc, a); n = net->findNode(a))
         {
-            if(!it->second->contains(address)) return nullptr;
-            break;
+            end = a;
+            if(calls) calls->insert(calls->end(), n->calls.begin(), n->calls.end());
+            if(starts.count(n->next)) break;
+            a = n->next;
         }
 
-        it--;
+        fb->blocks.emplace_back(start, end);
+    }
+
+    return !fb->blocks.empty();
+}
+
+FunctionContainer::FunctionContainer(Context* ctx): m_context(ctx), m_graphs(FUNCTION_GRAPH_CACHE_SIZE, [this](const rd_address&, FunctionGraphPtr& g) { this->retireGraph(g); }) { }
+
+FunctionGraph* FunctionContainer::getGraph(rd_address address) const
+{
+    rd_address startaddress = RD_NVAL;
+    size_t generation = 0;
+
+    {
+        std::scoped_lock<std::mutex> lock(m_mutex);
+        if(!this->findBounds(address, &startaddress)) return nullptr;
+        if(auto* g = m_graphs.find(startaddress)) return g->get();
+        generation = m_generation;
+    }
+
+    auto g = std::make_unique<FunctionGraph>(m_context); // Evicted or never built, don't hold the lock while walking it
+    if(!g->build(startaddress)) return nullptr;
+
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    if(auto* cg = m_graphs.find(startaddress)) return cg->get(); // Another thread has cached it meanwhile
+
+    if(generation != m_generation) // Bounds changed while it was built: hand it out, but don't cache it
+    {
+        FunctionGraph* res = g.get();
+        this->retireGraph(g);
+        return res;
     }
 
-    return it->second.get();
+    return m_graphs.insert(startaddress, std::move(g))->get();
 }
 
 RDLocation FunctionContainer::getFunction(rd_address address) const
 {
-    auto* g = this->getGraph(address);
-    if(g) return { { g->startAddress() }, true };
+    rd_address startaddress = RD_NVAL;
+    if(m_extents.find(address, &startaddress)) return { { startaddress }, true };
     return { { 0 }, false };
 }
 
+size_t FunctionContainer::getFunctions(const rd_address* addresses, size_t count, rd_address* functions) const { return m_extents.find(addresses, count, functions); }
+
+RDLocation FunctionContainer::getBounds(rd_address address, FunctionBounds* fb) const
+{
+    std::scoped_lock<std::mutex> lock(m_mutex);
+
+    rd_address startaddress = RD_NVAL;
+    const FunctionBounds* b = this->findBounds(address, &startaddress);
+    if(!b) return { { 0 }, false };
+
+    if(fb) *fb = *b;
+    return { { startaddress }, true };
+}
+
 bool FunctionContainer::isBasicBlockTail(rd_address address) const
 {
-    auto* g = this->getGraph(address);
-    if(!g) return false;
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    const FunctionBounds* fb = this->findBounds(address, nullptr);
+    return fb ? fb->isBasicBlockTail(address) : false;
+}
 
-    const RDGraphNode* nodes = nullptr;
-    size_t c = g->nodes(&nodes);
+void FunctionContainer::setBounds(rd_address address, FunctionBounds fb)
+{
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    auto it = m_values.find(address);
 
-    for(size_t i = 0; (c > 1) && (i < c - 1); i++)
+    if(it != m_values.end())
     {
-        const auto* fbb = reinterpret_cast<const FunctionBasicBlock*>(g->data(nodes[i])->p_data);
-        if(!fbb || !fbb->contains(address)) continue;
-        if(fbb->endaddress == address) return true;
+        if(it->second == fb) return;
+        m_extents.remove(address);
     }
 
-    return false;
+    m_extents.insert(address, fb.blocks);
+    m_values[address] = std::move(fb);
+    m_generation++;
+
+    if(auto* g = m_graphs.find(address))
+    {
+        this->retireGraph(*g);
+        m_graphs.remove(address);
+    }
+}
+
+void FunctionContainer::setBounds(Values values)
+{
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    m_values = std::move(values);
+    m_extents.clear();
+
+    for(const auto& [address, fb] : m_values)
+        m_extents.insert(address, fb.blocks);
+
+    m_generation++;
+
+    // The net may have changed even where bounds did not (edges, themes): graphs are rebuilt on demand
+    m_graphs.evictAll();
+}
+
+void FunctionContainer::retireGraph(FunctionGraphPtr& g) const
+{
+    if(!g) return;
+
+    if(m_retired.size() >= FUNCTION_GRAPH_CACHE_SIZE) // The older generation has outlived a full one, release it
+    {
+        m_retiredold = std::move(m_retired);
+        m_retired.clear();
+    }
+
+    m_retired.push_back(std::move(g));
 }
 
-void FunctionContainer::invalidateGraphs() { this->clearValues(); }
+const FunctionBounds* FunctionContainer::findBounds(rd_address address, rd_address* startaddress) const
+{
+    rd_address function = RD_NVAL;
+    if(!m_extents.find(address, &function)) return nullptr;
+
+    auto it = m_values.find(function);
+    if(it == m_values.end()) return nullptr;
+
+    if(startaddress) *startaddress = function;
+    return std::addressof(it->second);
+}
@@ -2,19 +2,49 @@
 
 #include <rdapi/types.h>
 #include <memory>
+#include <vector>
+#include <mutex>
 #include "../../builtin/graph/functiongraph/functiongraph.h"
 #include "../../containers/addresscontainer.h"
+#include "../../containers/lrucontainer.h"
+#include "functionextents.h"
 
+#define FUNCTION_GRAPH_CACHE_SIZE 0x1000
+
+class Context;
 class FunctionGraph;
 typedef std::unique_ptr<FunctionGraph> FunctionGraphPtr;
 
-class FunctionContainer: public AddressContainer<FunctionGraphPtr, true>
+struct FunctionBounds // Basic block ranges [start, end], sorted by start address
+{
+    FunctionExtents::Ranges blocks;
+
+    bool isBasicBlockTail(rd_address address) const;
+    bool operator==(const FunctionBounds& rhs) const { return blocks == rhs.blocks; }
+    static bool build(const SafeDocument& doc, rd_address address, FunctionBounds* fb, std::vector<rd_address>* calls); // Walks the net only, no graph is built
+};
+
+class FunctionContainer: public AddressContainer<FunctionBounds, true>
 {
     public:
-        FunctionContainer() = default;
-        FunctionGraph* getGraph(rd_address address) const;
+        FunctionContainer(Context* ctx);
+        FunctionGraph* getGraph(rd_address address) const; // Valid until FUNCTION_GRAPH_CACHE_SIZE more graphs are retired after it
         RDLocation getFunction(rd_address address) const;
+        RDLocation getBounds(rd_address address, FunctionBounds* fb) const;
+        size_t getFunctions(const rd_address* addresses, size_t count, rd_address* functions) const;
         bool isBasicBlockTail(rd_address address) const;
-        void invalidateGraphs();
-};
+        void setBounds(rd_address address, FunctionBounds fb);
+        void setBounds(Values values); // Replaces every function
 
+    private:
+        const FunctionBounds* findBounds(rd_address address, rd_address* startaddress) const; // Requires m_mutex
+        void retireGraph(FunctionGraphPtr& g) const;                                          // Requires m_mutex
+
+    private:
+        Context* m_context;
+        FunctionExtents m_extents;
+        mutable LRUContainer<rd_address, FunctionGraphPtr> m_graphs;
+        mutable std::vector<FunctionGraphPtr> m_retired, m_retiredold; // Evicted graphs outlive one more generation, a caller may still use them
+        size_t m_generation{0};                                        // Bumped when bounds change, graphs built before are not cached
+        mutable std::mutex m_mutex;                                    // Guards m_values, m_extents, m_graphs and the retired generations
+};
@@ -0,0 +1,183 @@
+#include "functionextents.h"
+#include <algorithm>
+#include <queue>
+
+void FunctionExtents::insert(rd_address function, const Ranges& ranges)
+{
+    std::scoped_lock<std::mutex> lock(m_mutex);
+
+    for(const auto& [start, end] : ranges)
+    {
+        m_pending.push_back({ start, end, function });
+        this->mergePending(m_pending.back()); // Lookups don't need a rebuild until enough of them pile up
+    }
+}
+
+void FunctionExtents::remove(rd_address function)
+{
+    std::scoped_lock<std::mutex> lock(m_mutex);
+
+    m_pending.erase(std::remove_if(m_pending.begin(), m_pending.end(), [function](const Extent& e) {
+        return e.function == function;
+    }), m_pending.end());
+
+    m_removed.insert(function); // Owners can't be taken back from merged segments: the next lookup rebuilds
+}
+
+void FunctionExtents::clear()
+{
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    m_extents.clear();
+    m_pending.clear();
+    m_segments.clear();
+    m_starts.clear();
+    m_pendingsegments.clear();
+    m_removed.clear();
+}
+
+bool FunctionExtents::find(rd_address address, rd_address* function) const
+{
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    this->compact();
+
+    rd_address f = this->lookup(address);
+    if(f == RD_NVAL) return false;
+
+    if(function) *function = f;
+    return true;
+}
+
+size_t FunctionExtents::find(const rd_address* addresses, size_t count, rd_address* functions) const
+{
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    this->compact();
+
+    size_t found = 0;
+
+    for(size_t i = 0; i < count; i++)
+    {
+        functions[i] = this->lookup(addresses[i]);
+        if(functions[i] != RD_NVAL) found++;
+    }
+
+    return found;
+}
+
+rd_address FunctionExtents::lookup(rd_address address) const
+{
+    rd_address function = this->lookupPending(address);
+    auto it = std::upper_bound(m_starts.begin(), m_starts.end(), address);
+    if(it == m_starts.begin()) return function;
+
+    const Extent& e = m_segments[std::distance(m_starts.begin(), it) - 1];
+    if(e.end < address) return function;
+    return (function != RD_NVAL) ? std::max(function, e.function) : e.function; // Same rule as buildSegments()
+}
+
+rd_address FunctionExtents::lookupPending(rd_address address) const
+{
+    auto it = m_pendingsegments.upper_bound(address);
+    if(it == m_pendingsegments.begin()) return RD_NVAL;
+
+    it--;
+    return (it->second.end >= address) ? it->second.function : RD_NVAL;
+}
+
+void FunctionExtents::mergePending(const Extent& extent)
+{
+    this->splitPending(extent.start);
+    if(extent.end != RD_NVAL) this->splitPending(extent.end + 1);
+
+    // Segments inside the extent are whole now: raise their owner and fill the gaps between them
+    rd_address address = extent.start;
+    auto it = m_pendingsegments.lower_bound(extent.start);
+
+    for( ; (it != m_pendingsegments.end()) && (it->first <= extent.end); it++)
+    {
+        if(it->first > address) m_pendingsegments.emplace_hint(it, address, Extent{ address, it->first - 1, extent.function });
+        it->second.function = std::max(it->second.function, extent.function);
+        if(it->second.end == extent.end) return;
+        address = it->second.end + 1;
+    }
+
+    m_pendingsegments.emplace_hint(it, address, Extent{ address, extent.end, extent.function });
+}
+
+void FunctionExtents::splitPending(rd_address address)
+{
+    auto it = m_pendingsegments.upper_bound(address);
+    if(it == m_pendingsegments.begin()) return;
+
+    Extent& e = (--it)->second;
+    if((e.start == address) || (e.end < address)) return;
+
+    m_pendingsegments.emplace_hint(std::next(it), address, Extent{ address, e.end, e.function });
+    e.end = address - 1;
+}
+
+void FunctionExtents::compact() const
+{
+    // Pending inserts are looked up on the side: rebuilding every segment for each one
+    // would turn an analysis that alternates inserts and lookups into O(n^2 log n)
+    if(m_removed.empty() && (m_pending.size() <= std::max<size_t>(FUNCTION_EXTENTS_PENDING_MIN, m_extents.size()))) return;
+
+    if(!m_removed.empty())
+    {
+        m_extents.erase(std::remove_if(m_extents.begin(), m_extents.end(), [&](const Extent& e) {
+            return m_removed.count(e.function);
+        }), m_extents.end());
+
+        m_removed.clear();
+    }
+
+    auto cmp = [](const Extent& e1, const Extent& e2) { return e1.start < e2.start; };
+    std::sort(m_pending.begin(), m_pending.end(), cmp);
+
+    size_t mid = m_extents.size();
+    m_extents.insert(m_extents.end(), m_pending.begin(), m_pending.end());
+    std::inplace_merge(m_extents.begin(), m_extents.begin() + mid, m_extents.end(), cmp);
+    m_pending.clear();
+    m_pendingsegments.clear();
+
+    this->buildSegments();
+}
+
+void FunctionExtents::buildSegments() const
+{
+    m_segments.clear();
+    m_starts.clear();
+
+    std::vector<rd_address> points; // Every address where the owner may change
+    points.reserve(m_extents.size() * 2);
+
+    for(const Extent& e : m_extents)
+    {
+        points.push_back(e.start);
+        if(e.end != RD_NVAL) points.push_back(e.end + 1);
+    }
+
+    std::sort(points.begin(), points.end());
+    points.erase(std::unique(points.begin(), points.end()), points.end());
+
+    // Ranges may overlap (shared tails), the nearest function wins
+    auto cmp = [](const Extent& e1, const Extent& e2) { return e1.function < e2.function; };
+    std::priority_queue<Extent, std::vector<Extent>, decltype(cmp)> active(cmp);
+    size_t next = 0;
+
+    for(size_t i = 0; i < points.size(); i++)
+    {
+        rd_address p = points[i];
+        while((next < m_extents.size()) && (m_extents[next].start <= p)) active.push(m_extents[next++]);
+        while(!active.empty() && (active.top().end < p)) active.pop();
+        if(active.empty()) continue;
+
+        rd_address end = ((i + 1) < points.size()) ? points[i + 1] - 1 : RD_NVAL;
+        rd_address function = active.top().function;
+
+        if(!m_segments.empty() && (m_segments.back().function == function) && ((m_segments.back().end + 1) == p)) m_segments.back().end = end;
+        else m_segments.push_back({ p, end, function });
+    }
+
+    m_starts.reserve(m_segments.size());
+    for(const Extent& e : m_segments) m_starts.push_back(e.start);
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <unordered_set>
+#include <vector>
+#include <mutex>
+#include <map>
+#include <rdapi/types.h>
+
+#define FUNCTION_EXTENTS_PENDING_MIN 256 // Inserts looked up on the side before the segments are rebuilt
+
+class FunctionExtents // Basic block ranges of every function, flattened into disjoint segments sorted by start address
+{
+    private:
+        struct Extent { rd_address start, end, function; }; // [start, end]
+
+    public:
+        typedef std::vector<std::pair<rd_address, rd_address>> Ranges;
+
+    public:
+        FunctionExtents() = default;
+        void insert(rd_address function, const Ranges& ranges);
+        void remove(rd_address function);
+        void clear();
+        bool find(rd_address address, rd_address* function) const;
+        size_t find(const rd_address* addresses, size_t count, rd_address* functions) const;
+
+    private:
+        rd_address lookup(rd_address address) const;
+        rd_address lookupPending(rd_address address) const;
+        void mergePending(const Extent& extent);
+        void splitPending(rd_address address);
+        void compact() const;
+        void buildSegments() const;
+
+    private:
+        mutable std::vector<Extent> m_extents, m_pending; // Ranges as inserted, they may overlap (shared tails)
+        mutable std::vector<Extent> m_segments;          // Disjoint, each one owned by the nearest function
+        mutable std::vector<rd_address> m_starts;        // Searched first, parallel to m_segments
+        mutable std::map<rd_address, Extent> m_pendingsegments; // Disjoint, m_pending merged as inserted
+        mutable std::unordered_set<rd_address> m_removed;
+        mutable std::mutex m_mutex;
+};
@@ -5,9 +5,10 @@
 #include "../../support/utils.h"
 #include "../../disassembler.h"
 #include "../../context.h"
+#include <algorithm>
 #include <thread>
 
-Algorithm::Algorithm(Context* ctx): Object(ctx), m_document(ctx->document()), m_net(ctx->net()) { }
+Algorithm::Algorithm(Context* ctx): Object(ctx), m_batch(ctx), m_document(ctx->document()) { }
 bool Algorithm::hasNext() const { return !m_pending.empty(); }
 void Algorithm::enqueue(rd_address address) { if(this->isAddressValid(address)) m_pending.push_front(address); }
 void Algorithm::schedule(rd_address address) { if(this->isAddressValid(address)) m_pending.push_back(address); }
@@ -23,20 +24,11 @@ void Algorithm::disassembleBlock(const RDBlock* block)
 
     while(!BufferView::empty(&view))
     {
-        EmulateResult result(address, &view);
-        auto nextaddress = this->decode(&view, &result);
-
-        if(!nextaddress || !result.size())
-        {
-            BufferView::move(&view, 1);
-            address++;
-        }
-        else
-        {
-            BufferView::move(&view, result.size());
-            address = *nextaddress;
-        }
+        size_t size = this->decodeLinear(address, &view);
+        if(!size) size = 1; // Undecodable: skip one byte
 
+        BufferView::move(&view, size);
+        address += size;
         std::this_thread::yield();
     }
 
@@ -52,12 +44,184 @@ void Algorithm::disassemble()
     }
 }
 
+bool Algorithm::disassemble(std::chrono::milliseconds slice)
+{
+    auto lock = x_lock_safe_ptr(m_document); // Keep the document consistent for the whole slice
+    auto deadline = std::chrono::steady_clock::now() + slice;
+
+    while(this->hasNext())
+    {
+        this->next();
+        if(std::chrono::steady_clock::now() >= deadline) break;
+    }
+
+    return this->hasNext();
+}
+
+void Algorithm::sweep()
+{
+    std::vector<RDBlock> blocks;
+    const rd_address* segments = nullptr;
+    size_t c = m_document->getSegments(&segments);
+
+    for(size_t i = 0; i < c; i++)
+    {
+        RDSegment segment;
+        if(!m_document->addressToSegment(segments[i], &segment) || !HAS_FLAG(&segment, SegmentFlags_Code)) continue;
+
+        const BlockContainer* segmentblocks = m_document->getBlocks(segment.address);
+        if(!segmentblocks) continue;
+
+        for(auto it = segmentblocks->begin(); it != segmentblocks->end(); it++)
+        {
+            if(IS_TYPE(std::addressof(*it), BlockType_Unknown)) blocks.push_back(*it);
+        }
+    }
+
+    m_sweepboundaries.clear();
+    m_sweeptargets.clear();
+    m_sweepgaps.clear();
+
+    for(const RDBlock& block : blocks)
+    {
+        RDBufferView view;
+        if(!m_document->getBlockView(block.address, &view)) continue;
+
+        Assembler* assembler = this->context()->getAssembler(block.address);
+        if(!assembler) continue;
+
+        this->status("Sweeping @ " + Utils::hex(block.address));
+        rd_address address = block.address;
+        this->sweepBreak(); // Runs don't cross blocks
+
+        while(!BufferView::empty(&view))
+        {
+            size_t size = this->sweepView(assembler, address, &view);
+
+            if(!size) // Undecodable: skip one byte
+            {
+                this->sweepBreak();
+                size = 1;
+            }
+
+            BufferView::move(&view, size);
+            address += size;
+        }
+    }
+
+    // Candidates come from what recursive descent left unexplored, they stay tentative until decoded (see next())
+    // Only call targets that land on a decoded instruction are kept
+    std::sort(m_sweeptargets.begin(), m_sweeptargets.end());
+    m_sweeptargets.erase(std::unique(m_sweeptargets.begin(), m_sweeptargets.end()), m_sweeptargets.end());
+
+    size_t oldpending = m_pending.size();
+
+    for(rd_address address : m_sweeptargets)
+    {
+        if(!m_sweepboundaries.count(address)) continue;
+        m_tentative.insert(address);
+        this->schedule(address);
+    }
+
+    size_t targets = m_pending.size() - oldpending;
+
+    // Unreferenced code: gap starts (block start or after a jump/return) that decode linearly into a jump or a return
+    for(rd_address address : m_sweepgaps)
+    {
+        if(std::binary_search(m_sweeptargets.begin(), m_sweeptargets.end(), address)) continue;
+        m_tentative.insert(address);
+        this->schedule(address);
+    }
+
+    spdlog::info("Algorithm::sweep(): {} candidate(s), {} call target(s) and {} gap(s) scheduled",
+                 m_sweeptargets.size() + m_sweepgaps.size(), targets, m_pending.size() - oldpending - targets);
+
+    m_sweepboundaries.clear();
+    m_sweeptargets.clear();
+    m_sweepgaps.clear();
+}
+
+size_t Algorithm::sweepView(Assembler* assembler, rd_address address, const RDBufferView* view)
+{
+    WeakScope weak(this->context());
+    size_t size = 0;
+
+    if(assembler->canEmulateBatch())
+    {
+        m_batch.reset(address, view);
+        assembler->emulateBatch(&m_batch);
+
+        for(size_t i = 0; i < m_batch.size(); i++)
+        {
+            const EmulateResult* result = m_batch.at(i);
+            if(!this->sweepResult(result)) break;
+            size += result->size();
+        }
+
+        return size;
+    }
+
+    EmulateResult* result = this->pushResult(address, view);
+    assembler->emulate(result);
+    if(this->sweepResult(result)) size = result->size();
+    this->popResult();
+    return size;
+}
+
+bool Algorithm::sweepResult(const EmulateResult* result)
+{
+    if(!result->size() || result->invalid() || (result->size() > result->view()->size)) return false;
+
+    m_sweepboundaries.insert(result->address());
+    if(m_sweeprunstart == RD_NVAL) m_sweeprunstart = result->address();
+    m_sweeprunlength++;
+
+    bool stop = false;
+
+    for(const auto& [forktype, res] : result->results())
+    {
+        switch(forktype)
+        {
+            case EmulateResult::Call: m_sweeptargets.push_back(res.address); break;
+
+            case EmulateResult::Return:
+            case EmulateResult::Branch:
+            case EmulateResult::BranchTable:
+            case EmulateResult::BranchIndirect:
+            case EmulateResult::BranchUnresolved: stop = true; break;
+
+            default: break;
+        }
+    }
+
+    if(stop) // Flow ends here, the next instruction starts a new gap
+    {
+        if(m_sweeprunlength >= SWEEP_MIN_RUN) m_sweepgaps.push_back(m_sweeprunstart);
+        this->sweepBreak();
+    }
+
+    return true;
+}
+
+void Algorithm::sweepBreak()
+{
+    m_sweeprunstart = RD_NVAL;
+    m_sweeprunlength = 0;
+}
+
 void Algorithm::next()
 {
     if(m_pending.empty()) return;
 
     rd_address address = m_pending.front();
     m_pending.pop_front();
+
+    if(m_tentative.erase(address) && !this->isUnexplored(address)) // Decoded by an earlier candidate, or data
+    {
+        spdlog::debug("Algorithm::next(): Sweep candidate {:x} dropped", address);
+        return;
+    }
+
     this->nextAddress(address);
 }
 
@@ -70,7 +234,7 @@ rd_address Algorithm::processDelaySlots(rd_address address, size_t ds)
         auto nextaddress = this->decode(address);
         if(!nextaddress) break;
 
-        if(i > 1) m_net->linkNext(address, *nextaddress);
+        if(i > 1) m_document->net()->linkNext(address, *nextaddress);
         address = *nextaddress;
     }
 
@@ -89,8 +253,7 @@ void Algorithm::processResult(EmulateResult* result)
             case EmulateResult::Ref: m_document->checkLocation(result->address(), res.address, res.size); break;
             case EmulateResult::RefData: m_document->checkData(result->address(), res.address, res.size); break;
             case EmulateResult::RefString: m_document->checkString(result->address(), res.address, res.size); break;
-            case EmulateResult::RefTypeName: m_document->checkTypeName(result->address(), res.address, res.name); break;
-            case EmulateResult::RefType: m_document->checkType(result->address(), res.address, res.type.get()); break;
+            case EmulateResult::RefType: m_document->checkType(result->address(), res.address, result->type(res)); break;
             case EmulateResult::Table: this->processTable(result->address(), res); break;
 
             case EmulateResult::Branch:
@@ -117,12 +280,12 @@ void Algorithm::processBranches(rd_type forktype, rd_address fromaddress, const
         case EmulateResult::Branch:
         case EmulateResult::BranchTrue:
             spdlog::info("Algorithm::processBranches(): TRUE @ {:x} (from {:x})", v.address, fromaddress);
-            m_net->linkBranch(fromaddress, v.address, forktype);
+            m_document->net()->linkBranch(fromaddress, v.address, forktype);
             break;
 
         case EmulateResult::BranchFalse:
             spdlog::info("Algorithm::processBranches(): FALSE @ {:x} (from {:x})", v.address, fromaddress);
-            m_net->linkBranch(fromaddress, v.address, forktype);
+            m_document->net()->linkBranch(fromaddress, v.address, forktype);
             this->enqueue(v.address);
             return; // Don't generate symbols
 
@@ -158,12 +321,12 @@ void Algorithm::processCalls(rd_type forktype, rd_address fromaddress, const Emu
             spdlog::info("Algorithm::processCalls(): CALL @ {:x} (from {:x})", v.address, fromaddress);
 
             if(HAS_FLAG(segment, SegmentFlags_Code)) {
-                m_net->linkCall(fromaddress, v.address, forktype);
+                m_document->net()->linkCall(fromaddress, v.address, forktype);
                 m_document->setFunction(v.address, std::string());
                 this->schedule(v.address);
             }
             else if(rd_address loc = m_document->checkLocation(fromaddress, v.address); loc != RD_NVAL)
-                m_net->linkCall(fromaddress, loc, EmulateResult::CallIndirect);
+                m_document->net()->linkCall(fromaddress, loc, EmulateResult::CallIndirect);
 
             break;
         }
@@ -179,7 +342,7 @@ void Algorithm::processBranchTable(rd_address fromaddress, const EmulateResult::
     size_t c = m_document->checkTable(fromaddress, v.address, v.size, [&](rd_address, rd_address address, size_t) {
         if(!m_document->addressToSegment(address, &segment) || !HAS_FLAG(&segment, SegmentFlags_Code)) return false;
 
-        m_net->linkBranch(fromaddress, address, EmulateResult::BranchIndirect);
+        m_document->net()->linkBranch(fromaddress, address, EmulateResult::BranchIndirect);
         m_document->setBranch(address);
         this->schedule(address);
         return true;
@@ -195,7 +358,7 @@ void Algorithm::processCallTable(rd_address fromaddress, const EmulateResult::Va
     size_t c = m_document->checkTable(fromaddress, v.address, v.size, [&](rd_address, rd_address address, size_t) {
         if(!m_document->addressToSegment(address, &segment) || !HAS_FLAG(&segment, SegmentFlags_Code)) return false;
 
-        m_net->linkCall(fromaddress, address, EmulateResult::CallIndirect);
+        m_document->net()->linkCall(fromaddress, address, EmulateResult::CallIndirect);
         m_document->setFunction(address, std::string());
         this->schedule(address);
         return true;
@@ -221,10 +384,23 @@ std::optional<rd_address> Algorithm::decode(rd_address address)
     RDBufferView view;
     if(!m_document->getView(address, RD_NVAL, &view)) return std::nullopt;
 
-    EmulateResult result(address, &view);
-    return this->decode(&view, &result);
+    EmulateResult* result = this->pushResult(address, &view);
+    auto nextaddress = this->decode(&view, result);
+    this->popResult();
+    return nextaddress;
+}
+
+EmulateResult* Algorithm::pushResult(rd_address address, const RDBufferView* view)
+{
+    if(m_resultdepth >= m_results.size()) m_results.emplace_back(this->context());
+
+    EmulateResult* result = std::addressof(m_results[m_resultdepth++]);
+    result->reset(address, view);
+    return result;
 }
 
+void Algorithm::popResult() { if(m_resultdepth) m_resultdepth--; }
+
 std::optional<rd_address> Algorithm::decode(RDBufferView* view, EmulateResult* result)
 {
     if(!this->isAddressValid(result->address())) return std::nullopt;
@@ -241,7 +417,11 @@ std::optional<rd_address> Algorithm::decode(RDBufferView* view, EmulateResult* r
     this->status("Decoding @ " + Utils::hex(result->address()));
     spdlog::trace("Algorithm::decode(): {:x} as '{}'", result->address(), assembler->id());
     assembler->emulate(result);
+    return this->decodeResult(assembler, view, result);
+}
 
+std::optional<rd_address> Algorithm::decodeResult(const Assembler* assembler, const RDBufferView* view, EmulateResult* result)
+{
     if(!result->size())
     {
         spdlog::trace("Algorithm::decode(): Invalid instruction @ {:x} (Size is empty)", result->address());
@@ -261,7 +441,7 @@ std::optional<rd_address> Algorithm::decode(RDBufferView* view, EmulateResult* r
 
     if(result->delaySlot())
     {
-        m_net->linkNext(result->address(), nextaddress);
+        m_document->net()->linkNext(result->address(), nextaddress);
         nextaddress = this->processDelaySlots(nextaddress, result->delaySlot());
     }
 
@@ -269,7 +449,7 @@ std::optional<rd_address> Algorithm::decode(RDBufferView* view, EmulateResult* r
 
     if(result->canFlow())
     {
-        m_net->linkNext(result->address(), nextaddress);
+        m_document->net()->linkNext(result->address(), nextaddress);
         return nextaddress;
     }
     else
@@ -278,6 +458,48 @@ std::optional<rd_address> Algorithm::decode(RDBufferView* view, EmulateResult* r
     return std::nullopt;
 }
 
+size_t Algorithm::decodeLinear(rd_address address, RDBufferView* view)
+{
+    Assembler* assembler = this->context()->getAssembler(address);
+
+    if(!assembler || !assembler->canEmulateBatch()) // Single instruction fallback
+    {
+        EmulateResult* result = this->pushResult(address, view);
+        this->decode(view, result);
+        size_t size = (result->size() <= view->size) ? result->size() : 0;
+        this->popResult();
+        return size;
+    }
+
+    if(!this->isAddressValid(address)) return 0;
+
+    this->status("Decoding @ " + Utils::hex(address));
+    spdlog::trace("Algorithm::decodeLinear(): {:x} as '{}'", address, assembler->id());
+
+    m_batch.reset(address, view);
+
+    {
+        WeakScope weak(this->context());
+        assembler->emulateBatch(&m_batch);
+    }
+
+    size_t size = 0;
+
+    for(size_t i = 0; i < m_batch.size(); i++)
+    {
+        EmulateResult* result = m_batch.at(i);
+        if(i && !this->isAddressValid(result->address())) break; // Resync from here
+
+        WeakScope weak(this->context());
+        this->decodeResult(assembler, result->view(), result);
+
+        if(!result->size() || (result->size() > result->view()->size)) break;
+        size += result->size();
+    }
+
+    return size;
+}
+
 bool Algorithm::isAddressValid(rd_address address) const
 {
     RDSegment segment;
@@ -337,3 +559,9 @@ bool Algorithm::isAddressValid(rd_address address) const
 
     return true;
 }
+
+bool Algorithm::isUnexplored(rd_address address) const
+{
+    RDBlock block;
+    return m_document->addressToBlock(address, &block) && IS_TYPE(&block, BlockType_Unknown);
+}
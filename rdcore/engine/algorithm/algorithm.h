@@ -1,13 +1,17 @@
 #pragma once
 
 #include <optional>
+#include <chrono>
+#include <deque>
+#include <unordered_set>
 #include "../../document/document_fwd.h"
 #include "../../plugin/assembler.h"
 #include "../../support/safe_ptr.h"
 #include "../../object.h"
 #include "emulateresult.h"
+#include "emulatebatch.h"
 
-class DocumentNet;
+#define SWEEP_MIN_RUN 4 // Instructions decoded back to back, up to a jump or a return, before a gap start is scheduled
 
 class Algorithm: public Object
 {
@@ -18,11 +22,21 @@ class Algorithm: public Object
         void schedule(rd_address address);
         void disassembleBlock(const RDBlock* block);
         void disassemble();
+        bool disassemble(std::chrono::milliseconds slice);
+        void sweep();
 
     private:
         std::optional<rd_address> decode(rd_address address);
+        EmulateResult* pushResult(rd_address address, const RDBufferView* view);
+        void popResult();
         std::optional<rd_address> decode(RDBufferView* view, EmulateResult* result);
+        std::optional<rd_address> decodeResult(const Assembler* assembler, const RDBufferView* view, EmulateResult* result);
+        size_t decodeLinear(rd_address address, RDBufferView* view);
+        size_t sweepView(Assembler* assembler, rd_address address, const RDBufferView* view);
+        bool sweepResult(const EmulateResult* result);
+        void sweepBreak();
         bool isAddressValid(rd_address address) const;
+        bool isUnexplored(rd_address address) const;
         void next();
         void nextAddress(rd_address address);
         void processResult(EmulateResult* result);
@@ -35,8 +49,15 @@ class Algorithm: public Object
 
     private:
         std::deque<rd_address> m_pending;
+        std::deque<EmulateResult> m_results; // One record per decode() nesting level (delay slots)
+        size_t m_resultdepth{0};
+        EmulateBatch m_batch;
+        std::unordered_set<rd_address> m_sweepboundaries;
+        std::unordered_set<rd_address> m_tentative; // Scheduled by the sweep, dropped if code or data got there first
+        std::vector<rd_address> m_sweeptargets, m_sweepgaps;
+        rd_address m_sweeprunstart{RD_NVAL};
+        size_t m_sweeprunlength{0};
         SafeDocument& m_document;
-        DocumentNet* m_net;
 };
 
 typedef safe_ptr<Algorithm> SafeAlgorithm;
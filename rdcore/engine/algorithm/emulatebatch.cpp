@@ -0,0 +1,35 @@
+#include "emulatebatch.h"
+#include "../../buffer/view.h"
+
+EmulateBatch::EmulateBatch(Context* ctx, size_t capacity): m_views(capacity), m_results(capacity, EmulateResult(ctx)), m_capacity(capacity) { } // Slots are reused between batches
+
+void EmulateBatch::reset(rd_address address, const RDBufferView* view)
+{
+    m_count = 0;
+    m_address = m_currentaddress = address;
+    m_view = m_current = *view;
+}
+
+const RDBufferView* EmulateBatch::view() const { return &m_view; }
+rd_address EmulateBatch::address() const { return m_address; }
+EmulateResult* EmulateBatch::at(size_t idx) { return (idx < m_count) ? std::addressof(m_results[idx]) : nullptr; }
+size_t EmulateBatch::size() const { return m_count; }
+
+EmulateResult* EmulateBatch::next()
+{
+    if(m_count) // Advance past the last decoded instruction, a linear run stops on undecodable bytes
+    {
+        const EmulateResult& last = m_results[m_count - 1];
+        if(!last.size() || (last.size() > m_current.size)) return nullptr;
+
+        BufferView::move(&m_current, last.size());
+        m_currentaddress += last.size();
+    }
+
+    if(BufferView::empty(&m_current) || (m_count >= m_capacity)) return nullptr;
+
+    m_views[m_count] = m_current;
+    EmulateResult* result = std::addressof(m_results[m_count]);
+    result->reset(m_currentaddress, std::addressof(m_views[m_count++]));
+    return result;
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <vector>
+#include <rdapi/buffer.h>
+#include "emulateresult.h"
+
+#define EMULATE_BATCH_SIZE 64
+
+class EmulateBatch
+{
+    public:
+        EmulateBatch(Context* ctx, size_t capacity = EMULATE_BATCH_SIZE);
+        void reset(rd_address address, const RDBufferView* view);
+        const RDBufferView* view() const;
+        rd_address address() const;
+        EmulateResult* at(size_t idx);
+        EmulateResult* next();
+        size_t size() const;
+
+    private:
+        std::vector<RDBufferView> m_views;
+        std::vector<EmulateResult> m_results;
+        RDBufferView m_view{ }, m_current{ };
+        rd_address m_address{0}, m_currentaddress{0};
+        size_t m_capacity, m_count{0};
+};
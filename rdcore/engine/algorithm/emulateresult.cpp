@@ -1,34 +1,74 @@
 #include "emulateresult.h"
+#include "../../database/database.h"
+#include "../../context.h"
+
+EmulateResult::EmulateResult(Context* ctx): m_context(ctx) { }
+
+void EmulateResult::reset(rd_address address, const RDBufferView* view)
+{
+    m_address = address;
+    m_view = view;
+    m_canflow = true;
+    m_invalid = false;
+    m_size = m_delayslot = m_count = 0;
+    m_overflow.clear();
+    m_types.clear();
+}
 
-EmulateResult::EmulateResult(rd_address address, const RDBufferView* view): m_address(address), m_view(view) { }
 bool EmulateResult::invalid() const { return m_invalid; }
 bool EmulateResult::canFlow() const { return m_canflow; }
-const EmulateResult::Results& EmulateResult::results() const { return m_results; }
+EmulateResult::Results EmulateResult::results() const { return { this->data(), this->data() + m_count }; }
+const SharedTypePtr& EmulateResult::type(const Value& v) const { return m_types.at(v.typeindex); }
 const RDBufferView* EmulateResult::view() const { return m_view; }
 rd_address EmulateResult::address() const { return m_address; }
 size_t EmulateResult::size() const { return m_size; }
 void EmulateResult::setSize(size_t size) { m_size = size; }
 size_t EmulateResult::delaySlot() const { return m_delayslot; }
 void EmulateResult::setDelaySlot(size_t ds) { m_delayslot = ds; }
-void EmulateResult::addReturn() { m_canflow = false; m_results.push_back({Return, {{0}, {RD_NVAL}, nullptr}}); }
-void EmulateResult::addBranchUnresolved() { m_canflow = false; m_results.push_back({BranchUnresolved, {{0}, {RD_NVAL}, nullptr}});  }
-void EmulateResult::addBranchIndirect() { m_canflow = false; m_results.push_back({BranchIndirect, {{0}, {RD_NVAL}, nullptr}}); }
-void EmulateResult::addBranch(rd_address address) { m_canflow = false; m_results.push_back({Branch, {{address} , {RD_NVAL}, nullptr}}); }
-void EmulateResult::addBranchTrue(rd_address address) { m_canflow = false; m_results.push_back({BranchTrue, {{address}, {RD_NVAL}, nullptr}}); }
-void EmulateResult::addBranchFalse(rd_address address) { m_canflow = false; m_results.push_back({BranchFalse, {{address}, {RD_NVAL}, nullptr}}); }
-void EmulateResult::addBranchTable(rd_address address, size_t size) { m_results.push_back({BranchTable, {{address}, {size}, nullptr}}); }
-void EmulateResult::addSysCall(u64 n) { m_results.push_back({SysCall, {{n}, {RD_NVAL}, nullptr}}); }
-void EmulateResult::addCall(rd_address address) { m_results.push_back({Call, {{address}, {RD_NVAL}, nullptr}}); }
-void EmulateResult::addCallIndirect() { m_results.push_back({CallIndirect, {{0}, {RD_NVAL}, nullptr}}); }
-void EmulateResult::addCallUnresolved() { m_results.push_back({CallUnresolved, {{0}, {RD_NVAL}, nullptr}}); }
-void EmulateResult::addCallTable(rd_address address, size_t size) { m_results.push_back({CallTable, {{address}, {size}, nullptr}}); }
-void EmulateResult::addReferenceSize(rd_address address, size_t size) { m_results.push_back({Ref, {{address}, {size}, nullptr}}); }
+void EmulateResult::addReturn() { m_canflow = false; this->push(Return, 0, RD_NVAL); }
+void EmulateResult::addBranchUnresolved() { m_canflow = false; this->push(BranchUnresolved, 0, RD_NVAL);  }
+void EmulateResult::addBranchIndirect() { m_canflow = false; this->push(BranchIndirect, 0, RD_NVAL); }
+void EmulateResult::addBranch(rd_address address) { m_canflow = false; this->push(Branch, address, RD_NVAL); }
+void EmulateResult::addBranchTrue(rd_address address) { m_canflow = false; this->push(BranchTrue, address, RD_NVAL); }
+void EmulateResult::addBranchFalse(rd_address address) { m_canflow = false; this->push(BranchFalse, address, RD_NVAL); }
+void EmulateResult::addBranchTable(rd_address address, size_t size) { this->push(BranchTable, address, size); }
+void EmulateResult::addSysCall(u64 n) { this->push(SysCall, n, RD_NVAL); }
+void EmulateResult::addCall(rd_address address) { this->push(Call, address, RD_NVAL); }
+void EmulateResult::addCallIndirect() { this->push(CallIndirect, 0, RD_NVAL); }
+void EmulateResult::addCallUnresolved() { this->push(CallUnresolved, 0, RD_NVAL); }
+void EmulateResult::addCallTable(rd_address address, size_t size) { this->push(CallTable, address, size); }
+void EmulateResult::addReferenceSize(rd_address address, size_t size) { this->push(Ref, address, size); }
 void EmulateResult::addData(rd_address address) { this->addDataSize(address, RD_NVAL); }
-void EmulateResult::addDataSize(rd_address address, size_t size) { m_results.push_back({RefData, {{address}, {size}, nullptr}}); }
+void EmulateResult::addDataSize(rd_address address, size_t size) { this->push(RefData, address, size); }
 void EmulateResult::addString(rd_address address) { this->addStringSize(address, RD_NVAL); }
-void EmulateResult::addStringSize(rd_address address, size_t size) { m_results.push_back({RefString, {{address}, {size}, nullptr}}); }
-void EmulateResult::addTable(rd_address address, size_t size) { m_results.push_back({Table, {{address}, {size}, nullptr}}); }
-void EmulateResult::addType(rd_address address, const Type* t) { m_results.push_back({RefType, {{address}, {RD_NVAL}, std::shared_ptr<Type>(t->clone())}}); }
-void EmulateResult::addTypeName(rd_address address, const char* name) { m_results.push_back({RefTypeName, {{address}, {reinterpret_cast<uintptr_t>(name)}, nullptr}}); }
+void EmulateResult::addStringSize(rd_address address, size_t size) { this->push(RefString, address, size); }
+void EmulateResult::addTable(rd_address address, size_t size) { this->push(Table, address, size); }
+void EmulateResult::addType(rd_address address, const Type* t) { this->pushType(address, SharedTypePtr(t->clone(m_context))); } // The only copy, the document keeps it
+void EmulateResult::addTypeName(rd_address address, const char* name) { if(m_context) this->pushType(address, m_context->database()->findType(name)); } // Interned, no copies
 void EmulateResult::addReference(rd_address address) { this->addReferenceSize(address, RD_NVAL); }
 void EmulateResult::addInvalid(size_t size) { m_invalid = true; m_size = size; }
+const EmulateResult::Result* EmulateResult::data() const { return (m_count > EMULATE_RESULT_INLINE_SIZE) ? m_overflow.data() : m_inline; }
+
+void EmulateResult::pushType(rd_address address, SharedTypePtr&& t)
+{
+    if(!t) return; // Unknown type name
+
+    m_types.push_back(std::move(t));
+    this->push(RefType, address, m_types.size() - 1);
+}
+
+void EmulateResult::push(rd_type type, uintptr_t v1, uintptr_t v2)
+{
+    Result r{type, { }};
+    r.second.v1 = v1;
+    r.second.v2 = v2;
+
+    if(m_count < EMULATE_RESULT_INLINE_SIZE) m_inline[m_count] = r;
+    else
+    {
+        if(m_count == EMULATE_RESULT_INLINE_SIZE) m_overflow.assign(m_inline, m_inline + EMULATE_RESULT_INLINE_SIZE); // Spill to the heap
+        m_overflow.push_back(r);
+    }
+
+    m_count++;
+}
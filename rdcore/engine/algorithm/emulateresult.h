@@ -1,13 +1,16 @@
 #pragma once
 
-#include <deque>
+#include <vector>
+#include <memory>
 #include <rdapi/types.h>
 #include "../../types/type.h"
-#include "../../object.h"
+
+#define EMULATE_RESULT_INLINE_SIZE 4
 
 struct RDBufferView;
+class Context;
 
-class EmulateResult: public Object
+class EmulateResult
 {
     public:
         enum {
@@ -15,7 +18,7 @@ class EmulateResult: public Object
             Invalid,
             Branch, BranchTrue, BranchFalse, BranchTable, BranchIndirect, BranchUnresolved,
             Call, CallTable, CallIndirect, CallUnresolved,
-            Return, SysCall, Ref, RefData, RefString, RefType, RefTypeName, Table,
+            Return, SysCall, Ref, RefData, RefString, RefType, Table,
         };
 
         struct Value {
@@ -28,20 +31,25 @@ class EmulateResult: public Object
             union {
                 uintptr_t v2;
                 size_t size;
-                const char* name;
+                size_t typeindex; // RefType, see type()
             };
-
-            std::shared_ptr<Type> type;
         };
 
-    private:
-        typedef std::deque<std::pair<rd_type, Value>> Results;
+        typedef std::pair<rd_type, Value> Result;
+
+        struct Results {
+            const Result *first, *last;
+            const Result* begin() const { return first; }
+            const Result* end() const { return last; }
+        };
 
     public:
-        EmulateResult(rd_address address, const RDBufferView* view);
+        EmulateResult(Context* ctx = nullptr);
+        void reset(rd_address address, const RDBufferView* view);
         bool invalid() const;
         bool canFlow() const;
-        const Results& results() const;
+        Results results() const;
+        const SharedTypePtr& type(const Value& v) const;
         const RDBufferView* view() const;
         rd_address address() const;
         size_t size() const;
@@ -74,10 +82,18 @@ class EmulateResult: public Object
         void addInvalid(size_t size);
 
     private:
+        const Result* data() const;
+        void push(rd_type type, uintptr_t v1, uintptr_t v2);
+        void pushType(rd_address address, SharedTypePtr&& t);
+
+    private:
+        Context* m_context;
         bool m_canflow{true}, m_invalid{false};
-        rd_address m_address;
-        size_t m_size{0}, m_delayslot{0};
-        const RDBufferView* m_view;
-        Results m_results;
+        rd_address m_address{RD_NVAL};
+        size_t m_size{0}, m_delayslot{0}, m_count{0};
+        const RDBufferView* m_view{nullptr};
+        Result m_inline[EMULATE_RESULT_INLINE_SIZE];
+        std::vector<Result> m_overflow; // Only used past the inline capacity, keeps its storage between resets
+        std::vector<SharedTypePtr> m_types; // Handles handed to the document as they are, cleared on reset
 };
 
@@ -5,23 +5,44 @@
 #include "../document/document.h"
 #include "../config.h"
 #include "../plugin/analyzer.h"
+#include "../database/analysiscache.h"
 #include "../builtin/analyzer/functionanalyzer.h"
-#include "../builtin/graph/functiongraph/functiongraph.h"
 #include "gibberish/gibberishdetector.h"
 #include "stringfinder.h"
+#include <algorithm>
+#include <exception>
 #include <vector>
 #include <ctime>
 
+namespace {
+
+struct ThreadJoiner
+{
+    std::vector<std::thread>& threads;
+
+    ~ThreadJoiner() { for(auto& t : threads) { if(t.joinable()) t.join(); } }
+};
+
+struct RunningGuard
+{
+    std::atomic_bool& running;
+
+    ~RunningGuard() { running = false; }
+};
+
+}
+
 const std::array<const char*, Engine::State_Last> Engine::STATUS_LIST = {
     "Stop", "Algorithm", "CFG", "Analyze", "Done"
 };
 
-Engine::Engine(Context* ctx): Object(ctx)
+Engine::Engine(Context* ctx): Object(ctx), m_analysiscache(new AnalysisCache(ctx))
 {
     GibberishDetector::initialize();
 
     const auto& selanalyzers = this->context()->selectedAnalyzers();
     m_analyzersdone.resize(selanalyzers.size());
+    m_analyzersrevs.resize(selanalyzers.size(), RD_NVAL);
 
     for(size_t i = 0; i < selanalyzers.size(); i++)
     {
@@ -44,44 +65,113 @@ Engine::Engine(Context* ctx): Object(ctx)
 }
 
 Engine::~Engine() { this->stop(); }
-size_t Engine::currentStep() const { return m_status.stepscurrent; }
-void Engine::reset() { m_status.stepscurrent = Engine::State_Stop; }
+size_t Engine::currentStep() const { return m_step; }
+void Engine::reset() { m_step = Engine::State_Stop; }
 
 void Engine::execute()
 {
-    while(m_status.stepscurrent < State_Done)
+    if(!this->claim())
+    {
+        spdlog::warn("Engine::execute(): Analysis in progress, request ignored");
+        return;
+    }
+
+    RunningGuard guard{m_running};
+    m_cancel = false;
+    this->run();
+}
+
+void Engine::executeAsync() { this->startWorker([&]() { this->run(); }); }
+
+void Engine::executeAsync(size_t step)
+{
+    this->startWorker([&, step]() {
+        if(step == m_step) return;
+        this->setStep(step);
+        this->run();
+    });
+}
+
+RDAnalysisStatus Engine::status() const
+{
+    static thread_local std::vector<size_t> analyzersdone; // Valid until the next call from the same thread
+
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    analyzersdone = m_snapshotdone;
+
+    RDAnalysisStatus s = m_snapshot;
+    s.analyzersdone = analyzersdone.data();
+    return s;
+}
+
+void Engine::run()
+{
+    while(m_step < State_Done)
     {
-        switch(m_status.stepscurrent)
+        if(!this->checkpoint())
+        {
+            spdlog::info("Engine::run(): Analysis cancelled");
+            this->notifyBusy(false);
+            return;
+        }
+
+        switch(m_step)
         {
             case Engine::State_Stop:
                 m_status.analysisstart = static_cast<u64>(time(nullptr));
+
+                if(m_restored) // Blocks, net and labels come from the cache: only function bounds are missing
+                {
+                    this->notifyBusy(true);
+                    this->cfgStep();
+                    this->setStep(State_Done);
+                    break;
+                }
+
                 this->nextStep();
                 break;
 
             case Engine::State_Algorithm: this->algorithmStep(); break;
             case Engine::State_CFG:       this->cfgStep();       break;
             case Engine::State_Analyze:   this->analyzeStep();   break;
-            default:                      rd_cfg->log("Unknown step: " + Utils::number(m_status.stepscurrent)); return;
+            default:                      this->log("Unknown step: " + Utils::number(m_step.load())); return;
         }
     }
 
     if(!this->algorithm()->hasNext())
     {
+        if(!m_restored && !m_cachesaved) // Only the first complete analysis, later runs include user changes
+        {
+            m_cachesaved = true;
+            m_analysiscache->save();
+        }
+
         this->notifyBusy(false);
         spdlog::info("Engine::execute(): Analysis completed");
-        rd_cfg->log("Analysis completed");
-        rd_cfg->status("Ready");
+        this->log("Analysis completed");
+        this->status("Ready");
     }
     else // More addresses pending: run Algorithm again
-        this->execute(Engine::State_Algorithm);
+    {
+        this->setStep(Engine::State_Algorithm);
+        this->run();
+    }
 }
 
 void Engine::execute(size_t step)
 {
-    if(step == m_status.stepscurrent) return;
+    if(!this->claim()) // Checked before the step changes under a running analysis
+    {
+        spdlog::warn("Engine::execute({}): Analysis in progress, request ignored", step);
+        return;
+    }
 
+    RunningGuard guard{m_running};
+    if(step == m_step) return;
+
+    m_cancel = false;
     this->setStep(step);
-    this->execute();
+    this->run();
 }
 
 bool Engine::cfg(rd_address address)
@@ -98,16 +188,86 @@ void Engine::setWeak(bool b)
     m_isweak = b;
 }
 
+bool Engine::restore() { return (m_restored = m_analysiscache->restore()); }
+
 void Engine::setStep(size_t step)
 {
-    m_status.stepscurrent = step;
+    m_step = step;
     this->notifyStatus();
 }
 
 bool Engine::isWeak() const { return m_isweak; }
-bool Engine::disassembling() const { return m_status.stepscurrent == State_Algorithm; }
-bool Engine::busy() const { return m_status.busy; }
-void Engine::stop() { if(m_status.busy) this->notifyBusy(false); }
+bool Engine::disassembling() const { return m_step == State_Algorithm; }
+bool Engine::busy() const { return m_busy; }
+bool Engine::paused() const { return m_paused; }
+
+void Engine::setPaused(bool b)
+{
+    {
+        std::scoped_lock<std::mutex> lock(m_mutex);
+        m_paused = b;
+    }
+
+    m_cv.notify_all();
+}
+
+void Engine::wait()
+{
+    if(this->isWorker()) return;
+
+    std::scoped_lock<std::mutex> lock(m_workermutex);
+    if(m_worker.joinable()) m_worker.join();
+}
+
+void Engine::stop()
+{
+    {
+        std::scoped_lock<std::mutex> lock(m_mutex);
+        m_cancel = true;
+    }
+
+    m_cv.notify_all();
+    if(this->isWorker()) return; // The worker notifies on its way out
+
+    this->wait();
+    if(m_busy) this->notifyBusy(false);
+}
+
+void Engine::startWorker(const std::function<void()>& cb)
+{
+    if(this->isWorker() || !this->claim()) return;
+
+    std::scoped_lock<std::mutex> lock(m_workermutex);
+    if(m_worker.joinable()) m_worker.join(); // Previous worker, already done
+
+    m_cancel = false;
+    const LogRoute* route = this->context()->logRoute();
+
+    m_worker = std::thread([&, cb, route]() {
+        m_workerid = std::this_thread::get_id();
+        Config::setThreadRoute(route); // Plugins log through the global functions
+        cb();
+        m_workerid = std::thread::id();
+        m_running = false;
+    });
+}
+
+bool Engine::claim()
+{
+    if(m_busy) return false;
+
+    bool expected = false; // Synchronous and asynchronous runs never overlap
+    return m_running.compare_exchange_strong(expected, true);
+}
+
+bool Engine::isWorker() const { return m_workerid == std::this_thread::get_id(); }
+
+bool Engine::checkpoint()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cv.wait(lock, [&]() { return !m_paused || m_cancel; });
+    return !m_cancel;
+}
 
 void Engine::algorithmStep()
 {
@@ -115,31 +275,47 @@ void Engine::algorithmStep()
 
     this->setWeak(true);
     this->notifyBusy(true);
-    this->algorithm()->disassemble();
+
+    while(this->algorithm()->disassemble(ENGINE_TIME_SLICE)) // Readers can take the document between slices
+    {
+        this->notifyStatus();
+        if(!this->checkpoint()) return;
+    }
+
     this->mergeCode();
 
+    // Recursive descent is done: sweep what it left unexplored, once
+    if(!this->algorithm()->hasNext() && !m_swept && this->context()->hasFlag(ContextFlags_LinearSweep))
+    {
+        m_swept = true;
+        this->sweepStep();
+    }
+
     if(this->algorithm()->hasNext()) this->setStep(State_Algorithm); // Repeat algorithm
     else this->nextStep();
 }
 
+void Engine::sweepStep()
+{
+    spdlog::info("Engine::sweepStep(): Linear sweep");
+    this->status("Sweeping code segments...");
+    this->algorithm()->sweep();
+}
+
 void Engine::analyzeStep()
 {
-    rd_cfg->status("Analyzing...");
+    this->status("Analyzing...");
     this->setWeak(false);
 
-    auto& doc = this->context()->document();
-    size_t oldfc = doc->getFunctions(nullptr);
-
     this->analyzeAll();
     this->mergeCode();
 
     if(!this->algorithm()->hasNext())
     {
-        // Functions count is changed, trigger analysis again
-        while(oldfc != doc->getFunctions(nullptr))
+        // Some inputs are changed, run the affected analyzers again
+        for(size_t i = 0; (i < ENGINE_MAX_ANALYZER_PASSES) && this->checkpoint(); i++)
         {
-            oldfc = doc->getFunctions(nullptr);
-            this->analyzeAll();
+            if(!this->analyzeAll()) break;
         }
 
         this->cfgStep(); // Run CFG again
@@ -155,53 +331,135 @@ void Engine::cfgStep()
     this->setWeak(false);
 
     spdlog::info("Engine::cfgStep(): Generating CFG");
-    rd_cfg->status("Generating CFG...");
-    this->context()->document()->invalidateGraphs();
+    this->status("Generating CFG...");
 
+    auto& doc = this->context()->document();
     const rd_address* functions = nullptr;
-    size_t c = this->context()->document()->getFunctions(&functions);
-    DocumentNet* net = this->context()->net();
+    size_t c = doc->getFunctions(&functions);
 
     spdlog::info("Engine::cfgStep(): Processing function bounds");
 
     for(size_t i = 0; i < c; i++)
     {
+        if(!this->checkpoint()) return;
         this->context()->statusAddress("Processing function bounds", functions[i]);
-        net->unlinkPrev(functions[i]);
+        doc->net()->unlinkPrev(functions[i]);
     }
 
     spdlog::info("Engine::cfgStep(): Computing basic blocks");
 
+    FunctionContainer::Values bounds; // Graphs are built on demand by Document::getGraph()
+    CallGraphIndex::Calls calls;
+
     for(size_t i = 0; i < c; i++)
     {
+        if(!this->checkpoint()) return; // Keep the previous bounds
+
         this->context()->statusAddress("Computing basic blocks", functions[i]);
-        this->generateCfg(functions[i]);
+        FunctionBounds fb;
+        std::vector<rd_address> fcalls;
+
+        if(FunctionBounds::build(doc, functions[i], &fb, &fcalls))
+        {
+            bounds.emplace(functions[i], std::move(fb));
+            calls.emplace(functions[i], std::move(fcalls));
+        }
+        else
+            this->context()->problem("Function bounds failed @ " + Utils::hex(functions[i]));
     }
 
+    doc->setFunctionBounds(std::move(bounds), std::move(calls));
     this->nextStep();
 }
 
 SafeAlgorithm& Engine::algorithm() { return this->context()->disassembler()->algorithm(); }
 
-void Engine::analyzeAll()
+bool Engine::analyzeAll()
 {
     const auto& analyzers = this->context()->selectedAnalyzers();
+    std::vector<size_t> group;
+    bool executed = false;
 
     for(size_t i = 0; i < analyzers.size(); i++)
     {
         const auto* a = analyzers.at(i);
-        if(HAS_FLAG(a->plugin(), AnalyzerFlags_RunOnce) && m_analyzersdone[i]) continue;
 
-        spdlog::info("Engine::analyzeAll(): '{}'", a->name());
+        bool conflicts = std::any_of(group.begin(), group.end(), [&](size_t idx) {
+            return analyzers.at(idx)->conflicts(a);
+        });
 
-        m_analyzersdone[i]++;
-        m_status.analyzerscurrent = i;
-        this->notifyStatus();
-        a->execute();
+        if(conflicts) // Previous analyzers may change its inputs, let them finish first
+        {
+            this->analyzeGroup(group);
+            group.clear();
+        }
+
+        if(!this->analyzerPending(i)) continue;
+        group.push_back(i);
+        executed = true;
     }
 
+    this->analyzeGroup(group);
     m_status.analyzerscurrent = RD_NVAL;
     this->notifyStatus();
+    return executed;
+}
+
+// Members of a group run concurrently: they declare disjoint resources and reach the document through SafeDocument only.
+// Analyzers that write Labels (Function, Signature, Strings) stay ordered with each other.
+void Engine::analyzeGroup(const std::vector<size_t>& group)
+{
+    if(group.empty()) return;
+
+    const auto& analyzers = this->context()->selectedAnalyzers();
+    std::vector<std::thread> workers;
+
+    for(size_t idx : group)
+    {
+        spdlog::info("Engine::analyzeGroup(): '{}'", analyzers.at(idx)->name());
+        m_analyzersdone[idx]++;
+    }
+
+    m_status.analyzerscurrent = group.front();
+    this->notifyStatus();
+
+    const LogRoute* route = this->context()->logRoute();
+    std::vector<std::exception_ptr> errors(group.size());
+
+    {
+        ThreadJoiner joiner{workers}; // Joins on every path, a joinable std::thread must not be destroyed
+
+        for(size_t i = 1; i < group.size(); i++)
+        {
+            const auto* a = analyzers.at(group[i]);
+
+            workers.emplace_back([a, route, &error = errors[i]]() {
+                Config::setThreadRoute(route);
+                try { a->execute(); }
+                catch(...) { error = std::current_exception(); } // Forwarded to the engine thread, it would terminate the process here
+            });
+        }
+
+        try { analyzers.at(group.front())->execute(); }
+        catch(...) { errors.front() = std::current_exception(); }
+    }
+
+    for(const auto& error : errors)
+    {
+        if(error) std::rethrow_exception(error); // Same as running them one after another
+    }
+
+    // Group members don't write each other's inputs, the snapshot excludes only their own changes
+    auto& doc = this->context()->document();
+    for(size_t idx : group) m_analyzersrevs[idx] = doc->revision(analyzers.at(idx)->reads());
+}
+
+bool Engine::analyzerPending(size_t idx) const
+{
+    const auto* a = this->context()->selectedAnalyzers().at(idx);
+    if(m_analyzersrevs[idx] == RD_NVAL) return true;
+    if(HAS_FLAG(a->plugin(), AnalyzerFlags_RunOnce)) return false;
+    return this->context()->document()->revision(a->reads()) != m_analyzersrevs[idx];
 }
 
 void Engine::mergeCode()
@@ -209,7 +467,7 @@ void Engine::mergeCode()
     if(this->context()->hasFlag(ContextFlags_NoCodeMerge))
         return;
 
-    rd_cfg->status("Merging Code...");
+    this->status("Merging Code...");
 
     const rd_address* segments = nullptr;
     size_t nsegments = this->context()->document()->getSegments(&segments);
@@ -296,17 +554,20 @@ void Engine::mergeCode()
 
 void Engine::generateCfg(rd_address address)
 {
-    auto g = std::make_unique<FunctionGraph>(this->context());
+    FunctionBounds fb;
+    std::vector<rd_address> calls;
 
-    if(g->build(address)) // Build & Apply CFG
-        this->context()->document()->setGraph(g.release());
+    if(FunctionBounds::build(this->context()->document(), address, &fb, &calls))
+        this->context()->document()->setFunctionBounds(address, std::move(fb), std::move(calls));
     else
-        this->context()->problem("Graph creation failed @ " + Utils::hex(address));
+        this->context()->problem("Function bounds failed @ " + Utils::hex(address));
 }
 
 void Engine::notifyStatus()
 {
     auto& doc = this->context()->document();
+    m_status.stepscurrent = m_step;
+    m_status.busy = m_busy;
 
     if(m_status.stepscurrent != m_lastnotifystep)
     {
@@ -324,12 +585,19 @@ void Engine::notifyStatus()
         m_lastnotifystep = m_status.stepscurrent;
     }
 
+    {
+        std::scoped_lock<std::mutex> lock(m_mutex);
+        m_snapshot = m_status;
+        m_snapshot.analyzersdone = nullptr; // Copied by status()
+        m_snapshotdone = m_analyzersdone;
+    }
+
     this->context()->notify<RDAnalysisStatusEventArgs>(RDEvents::Event_AnalysisStatusChanged, this, &m_status);
 }
 
 void Engine::notifyBusy(bool busy)
 {
-    m_status.busy = busy;
+    m_busy = busy;
     if(!busy) m_status.analysisend = static_cast<u64>(time(nullptr));
 
     this->context()->notify<RDEventArgs>(RDEvents::Event_BusyChanged, this);
@@ -338,6 +606,6 @@ void Engine::notifyBusy(bool busy)
 
 void Engine::nextStep()
 {
-    m_status.stepscurrent = std::min<size_t>(m_status.stepscurrent + 1, State_Done);
+    m_step = std::min<size_t>(m_step + 1, State_Done);
     this->notifyStatus();
 }
@@ -2,13 +2,23 @@
 
 #include <unordered_set>
 #include <unordered_map>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <thread>
+#include <mutex>
 #include <array>
+#include <memory>
 #include <vector>
 #include <rdapi/types.h>
 #include "algorithm/algorithm.h"
 #include "../support/safe_ptr.h"
 #include "../object.h"
 
+#define ENGINE_TIME_SLICE std::chrono::milliseconds(50)
+#define ENGINE_MAX_ANALYZER_PASSES 16
+
+class AnalysisCache;
 class Analyzer;
 class Context;
 
@@ -24,21 +34,39 @@ class Engine: public Object
         void reset();
         void execute();
         void execute(size_t step);
+        void executeAsync();
+        void executeAsync(size_t step);
+        RDAnalysisStatus status() const;
+        using Object::status;
         bool cfg(rd_address address);
         void setWeak(bool b);
         bool isWeak() const;
         bool disassembling() const;
         bool busy() const;
+        bool paused() const;
+        void setPaused(bool b);
+        bool restore();
+        void wait();
         void stop();
 
     private:
         void algorithmStep();
         void analyzeStep();
         void cfgStep();
+        void sweepStep();
+
+    private:
+        void run();
+        void startWorker(const std::function<void()>& cb);
+        bool claim();
+        bool isWorker() const;
+        bool checkpoint();
 
     private:
         SafeAlgorithm& algorithm();
-        void analyzeAll();
+        bool analyzeAll();
+        void analyzeGroup(const std::vector<size_t>& group);
+        bool analyzerPending(size_t idx) const;
         void mergeCode();
         void generateCfg(rd_address address);
         void notifyStatus();
@@ -47,11 +75,23 @@ class Engine: public Object
         void nextStep();
 
     private:
-        RDAnalysisStatus m_status{ };
+        RDAnalysisStatus m_status{ }, m_snapshot{ }; // m_status is owned by the worker, readers get a copy of m_snapshot
         std::vector<const char*> m_analyzersnames;
-        std::vector<size_t> m_analyzersdone;
+        std::vector<size_t> m_analyzersdone, m_snapshotdone;
+        std::vector<size_t> m_analyzersrevs; // Inputs revision seen by the last run
         size_t m_lastnotifystep{State_Last};
         bool m_isweak{false};
+        std::unique_ptr<AnalysisCache> m_analysiscache;
+        bool m_restored{false}, m_cachesaved{false}, m_swept{false};
+
+    private:
+        std::thread m_worker;
+        std::atomic<std::thread::id> m_workerid;
+        std::mutex m_workermutex; // Guards m_worker: joinable() and join() can't race
+        std::atomic_bool m_running{false}, m_cancel{false}, m_paused{false}, m_busy{false};
+        std::atomic_size_t m_step{State_Stop};
+        std::condition_variable m_cv;
+        mutable std::mutex m_mutex;
 
     private:
         std::unordered_set<size_t> m_stepsdone;
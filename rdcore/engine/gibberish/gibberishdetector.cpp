@@ -3,19 +3,21 @@
 #include <numeric>
 #include <cassert>
 #include <cmath>
+#include <mutex>
 
 const size_t GibberishDetector::DEFAULT_COUNTS_VALUE = 10;
+const u8 GibberishDetector::INVALID_CLASS = 0xFF;
 GibberishDetectorData::MatrixCounts GibberishDetector::m_counts;
-GibberishDetector::CharIndex GibberishDetector::m_charidx;
+GibberishDetector::CharClasses GibberishDetector::m_charclasses;
+GibberishDetector::LogProbs GibberishDetector::m_logprobs;
 
 bool GibberishDetector::train(const std::string& bigfile, const std::string& goodfile, const std::string& badfile)
 {
     GibberishDetector::initializeCounts();
-    GibberishDetector::initializeCharIndex();
+    GibberishDetector::initialize();
 
     bool res = GibberishDetector::lines(bigfile, [](const std::string& line) {
-        for(const auto& [a, b] : GibberishDetector::ngram(line))
-            m_counts[m_charidx[a]][m_charidx[b]] += 1;
+        GibberishDetector::transitions(line, [](u8 a, u8 b) { m_counts[a][b] += 1; });
     });
 
     if(!res) return false;
@@ -29,12 +31,13 @@ bool GibberishDetector::train(const std::string& bigfile, const std::string& goo
         });
     }
 
+    LogProbs logprobs = GibberishDetector::flatten(m_counts);
     std::deque<double> goodprobs, badprobs;
 
-    res = GibberishDetector::lines(goodfile, [&](const std::string& line) { goodprobs.push_back(GibberishDetector::avgTransitionProb(line, m_counts)); });
+    res = GibberishDetector::lines(goodfile, [&](const std::string& line) { goodprobs.push_back(GibberishDetector::avgTransitionProb(line, logprobs)); });
     if(!res) return false;
 
-    res = GibberishDetector::lines(badfile, [&](const std::string& line) { badprobs.push_back(GibberishDetector::avgTransitionProb(line, m_counts)); });
+    res = GibberishDetector::lines(badfile, [&](const std::string& line) { badprobs.push_back(GibberishDetector::avgTransitionProb(line, logprobs)); });
     if(!res) return false;
 
     assert(goodprobs.size() > badprobs.size());
@@ -64,62 +67,61 @@ bool GibberishDetector::train(const std::string& bigfile, const std::string& goo
     return true;
 }
 
-bool GibberishDetector::isGibberish(const std::string& s)
-{
-    return GibberishDetector::avgTransitionProb(s, GibberishDetectorData::TRAINED_COUNTS) <= GibberishDetectorData::TRAINED_THRESHOLD;
-}
+bool GibberishDetector::isGibberish(std::string_view text) { return GibberishDetector::score(text) <= GibberishDetectorData::TRAINED_THRESHOLD; }
 
-GibberishDetector::NGramList GibberishDetector::ngram(const std::string& s)
+void GibberishDetector::isGibberish(const std::string_view* texts, size_t count, bool* results)
 {
-    std::string ns = GibberishDetector::normalize(s);
-    NGramList nglist;
-
-    for(int i = 0; i < static_cast<int>(ns.size()) - 1; i++)
-        nglist.push_back({ ns[i], ns[i + 1] });
-
-    return nglist;
+    for(size_t i = 0; i < count; i++) // Tables stay hot for the whole batch
+        results[i] = GibberishDetector::avgTransitionProb(texts[i], m_logprobs) <= GibberishDetectorData::TRAINED_THRESHOLD;
 }
 
+double GibberishDetector::score(std::string_view text) { return GibberishDetector::avgTransitionProb(text, m_logprobs); }
+
 void GibberishDetector::initializeCounts()
 {
     m_counts = GibberishDetector::fillMatrix<GibberishDetectorData::MatrixCounts::value_type::value_type, m_counts.size()>(DEFAULT_COUNTS_VALUE);
 }
 
-std::string GibberishDetector::normalize(std::string s)
-{
-    for(auto it = s.begin(); it != s.end(); ) // Remove [^a-z ]+
-    {
-        if((*it == ' ') || ::isalpha(*it))
-        {
-            *it = ::tolower(*it);
-            it++;
-        }
-        else
-            it = s.erase(it);
-    }
-
-    return s;
-}
-
-double GibberishDetector::avgTransitionProb(const std::string& s, const GibberishDetectorData::MatrixCounts& counts)
+double GibberishDetector::avgTransitionProb(std::string_view s, const LogProbs& logprobs)
 {
     double logprob = 0;
     int transitionct = 0;
 
-    for(const auto& n : GibberishDetector::ngram(s))
-    {
-        logprob += counts[m_charidx[n.first]][m_charidx[n.second]];
+    GibberishDetector::transitions(s, [&](u8 a, u8 b) {
+        logprob += logprobs[a * GibberishDetectorData::ACCEPTED_CHARS_COUNT + b];
         transitionct += 1;
-    }
+    });
 
     return std::exp(logprob / (transitionct ? transitionct : 1));
 }
 
-void GibberishDetector::initialize() { GibberishDetector::initializeCharIndex(); }
+GibberishDetector::LogProbs GibberishDetector::flatten(const GibberishDetectorData::MatrixCounts& counts)
+{
+    LogProbs logprobs;
+    auto it = logprobs.begin();
+
+    for(const auto& row : counts)
+        it = std::copy(row.begin(), row.end(), it);
 
-void GibberishDetector::initializeCharIndex()
+    return logprobs;
+}
+
+void GibberishDetector::initialize()
 {
-    std::for_each(GibberishDetectorData::ACCEPTED_CHARS.begin(), GibberishDetectorData::ACCEPTED_CHARS.end(), [](char c) {
-        m_charidx.emplace(c, m_charidx.size());
-    });
+    static std::once_flag initialized; // Engines can be created concurrently
+    std::call_once(initialized, &GibberishDetector::initializeTables);
+}
+
+void GibberishDetector::initializeTables()
+{
+    m_charclasses.fill(INVALID_CLASS);
+
+    for(size_t i = 0; i < GibberishDetectorData::ACCEPTED_CHARS.size(); i++)
+    {
+        char c = GibberishDetectorData::ACCEPTED_CHARS[i];
+        m_charclasses[static_cast<u8>(c)] = static_cast<u8>(i);
+        if(::isalpha(c)) m_charclasses[static_cast<u8>(::toupper(c))] = static_cast<u8>(i);
+    }
+
+    m_logprobs = GibberishDetector::flatten(GibberishDetectorData::TRAINED_COUNTS);
 }
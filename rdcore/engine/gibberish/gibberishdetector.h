@@ -2,41 +2,44 @@
 
 #include <fstream>
 #include <algorithm>
-#include <unordered_map>
+#include <string_view>
 #include <string>
 #include <array>
-#include <list>
 #include <deque>
+#include <rdapi/types.h>
 #include "gibberishdetector_data.h"
 
 class GibberishDetector
 {
     private:
         static const size_t DEFAULT_COUNTS_VALUE;
+        static const u8 INVALID_CLASS;
 
     private:
-        typedef std::unordered_map<char, size_t> CharIndex;
-        typedef std::pair<char, char> NGram;
-        typedef std::list<NGram> NGramList;
+        typedef std::array<u8, 256> CharClasses; // Byte -> row/column of the matrix, INVALID_CLASS if stripped
+        typedef std::array<double, GibberishDetectorData::ACCEPTED_CHARS_COUNT * GibberishDetectorData::ACCEPTED_CHARS_COUNT> LogProbs;
 
     public:
         GibberishDetector() = delete;
         static bool train(const std::string& bigfile, const std::string& goodfile, const std::string& badfile);
-        static bool isGibberish(const std::string& text);
+        static bool isGibberish(std::string_view text);
+        static void isGibberish(const std::string_view* texts, size_t count, bool* results);
+        static double score(std::string_view text);
         static void initialize();
 
     private:
         template<typename T, size_t N> static GibberishDetectorData::Matrix2D<T, N> fillMatrix(const T& val);
         template<typename Function> static bool lines(const std::string& filename, const Function& cb);
-        static NGramList ngram(const std::string& s);
-        static std::string normalize(std::string s);
-        static double avgTransitionProb(const std::string& s, const GibberishDetectorData::MatrixCounts& counts);
-        static void initializeCharIndex();
+        template<typename Function> static void transitions(std::string_view s, const Function& cb);
+        static double avgTransitionProb(std::string_view s, const LogProbs& logprobs);
+        static LogProbs flatten(const GibberishDetectorData::MatrixCounts& counts);
+        static void initializeTables();
         static void initializeCounts();
 
     private:
         static GibberishDetectorData::MatrixCounts m_counts;
-        static CharIndex m_charidx;
+        static CharClasses m_charclasses;
+        static LogProbs m_logprobs;
 };
 
 template<typename T, size_t N>
@@ -57,3 +60,17 @@ bool GibberishDetector::lines(const std::string& filename, const Function& cb)
     while(std::getline(ifs, line)) cb(line);
     return true;
 }
+
+template<typename Function>
+void GibberishDetector::transitions(std::string_view s, const Function& cb)
+{
+    u8 prev = INVALID_CLASS;
+
+    for(char ch : s) // Same bigrams as lowering the string and stripping [^a-z ]+ first
+    {
+        u8 curr = m_charclasses[static_cast<u8>(ch)];
+        if(curr == INVALID_CLASS) continue;
+        if(prev != INVALID_CLASS) cb(prev, curr);
+        prev = curr;
+    }
+}
@@ -12,20 +12,30 @@
 
 #define ALPHA_THRESHOLD 0.5
 
-std::string StringFinder::m_tempstr;
+thread_local std::string StringFinder::m_tempstr;
 
-void StringFinder::find(Context* ctx, const RDBufferView& inview)
+void StringFinder::find(Context* ctx, const RDBufferView& inview, Candidates& candidates)
 {
     RDBufferView view = inview;
     bool hasnext = true;
 
     while(hasnext)
     {
-        hasnext = StringFinder::step(ctx, view);
+        hasnext = StringFinder::step(ctx, view, &candidates);
         std::this_thread::yield();
     }
 }
 
+void StringFinder::mark(Context* ctx, const Candidate& candidate, bool gibberish)
+{
+    if(!gibberish && StringFinder::checkAndMark(ctx, candidate.address, candidate.flags, candidate.totalsize)) return;
+
+    // Rejected: scan what find() skipped over, one verdict at a time like before
+    RDBufferView view;
+    if(!ctx->document()->getView(candidate.address + 1, candidate.totalsize - 1, &view)) return;
+    while(StringFinder::step(ctx, view, nullptr)) { }
+}
+
 bool StringFinder::toAscii(char inch, char* outch)
 {
     if(!StringFinder::isAscii(inch)) return false;
@@ -44,7 +54,7 @@ bool StringFinder::toAscii(char16_t inch, char* outch)
     return res;
 }
 
-bool StringFinder::step(Context* ctx, RDBufferView& view)
+bool StringFinder::step(Context* ctx, RDBufferView& view, Candidates* candidates)
 {
     if(BufferView::empty(&view)) return false;
     RDLocation loc = ctx->document()->addressof(view.data);
@@ -53,9 +63,16 @@ bool StringFinder::step(Context* ctx, RDBufferView& view)
     rd_cfg->status("Searching strings @ " + Utils::hex(loc.value));
 
     size_t totalsize = 0;
-    rd_flag flags = StringFinder::categorize(ctx, view, &totalsize);
+    bool pending = false;
+    rd_flag flags = StringFinder::categorize(ctx, view, &totalsize, candidates ? &pending : nullptr);
 
-    if(StringFinder::checkAndMark(ctx, loc.address, flags, totalsize))
+    if(pending) // Only the gibberish verdict is missing, the caller scores them in batches
+    {
+        candidates->items.push_back({loc.address, flags, totalsize, candidates->texts.size(), m_tempstr.size()});
+        candidates->texts += m_tempstr;
+        BufferView::move(&view, totalsize);
+    }
+    else if(StringFinder::checkAndMark(ctx, loc.address, flags, totalsize))
         BufferView::move(&view, totalsize);
     else
         BufferView::move(&view, 1);
@@ -63,7 +80,7 @@ bool StringFinder::step(Context* ctx, RDBufferView& view)
     return true;
 }
 
-rd_flag StringFinder::categorize(Context* ctx, const RDBufferView& view, size_t* totalsize)
+rd_flag StringFinder::categorize(Context* ctx, const RDBufferView& view, size_t* totalsize, bool* pending)
 {
     if(view.size < (sizeof(char) * 2)) return AddressFlags_None;
 
@@ -73,19 +90,24 @@ rd_flag StringFinder::categorize(Context* ctx, const RDBufferView& view, size_t*
 
     if(StringFinder::isAscii(c1) && !c2)
     {
-        ok = StringFinder::categorizeT<char16_t>(view, ctx->minString(), totalsize, [](char16_t ch, char* outch) {
+        if(pending) *pending = false;
+
+        ok = StringFinder::categorizeT<char16_t>(view, ctx->minString(), totalsize, pending, [](char16_t ch, char* outch) {
             return StringFinder::toAscii(ch, outch);
         });
 
         if(ok) return AddressFlags_WideString;
     }
 
-    ok = StringFinder::categorizeT<char>(view, ctx->minString(), totalsize, [](char ch, char* outch) {
+    if(pending) *pending = false;
+
+    ok = StringFinder::categorizeT<char>(view, ctx->minString(), totalsize, pending, [](char ch, char* outch) {
         if(!StringFinder::isAscii(ch)) return false;
         *outch = ch;
         return true;
     });
 
+    if(!ok && pending) *pending = false;
     return ok ? AddressFlags_AsciiString : AddressFlags_None;
 }
 
@@ -97,15 +119,15 @@ bool StringFinder::checkAndMark(Context* ctx, rd_address address, rd_flag flags,
     return false;
 }
 
-bool StringFinder::validateString(const std::string& str)
+bool StringFinder::validateString(const std::string& str, bool* pending)
 {
-    if(!StringFinder::checkHeuristic(str, true)) return false;
+    if(!StringFinder::checkHeuristic(str, true, pending)) return false;
 
     double alnumcount = static_cast<double>(std::count_if(str.begin(), str.end(), ::isalnum));
     return (alnumcount / static_cast<double>(str.size())) > ALPHA_THRESHOLD;
 }
 
-bool StringFinder::checkHeuristic(const std::string& s, bool gibberish)
+bool StringFinder::checkHeuristic(const std::string& s, bool gibberish, bool* pending)
 {
     if(s.empty()) return false;
 
@@ -137,7 +159,11 @@ bool StringFinder::checkHeuristic(const std::string& s, bool gibberish)
 
         case ' ': break;
         case '%': return StringFinder::checkFormats(s);
-        default:  return gibberish && !GibberishDetector::isGibberish(s);
+        default:
+            if(!gibberish) return false;
+            if(!pending) return !GibberishDetector::isGibberish(s);
+            *pending = true; // Deferred to the batch
+            return true;
     }
 
     return false;
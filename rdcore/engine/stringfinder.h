@@ -2,6 +2,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 #include <rdapi/types.h>
 #include "../buffer/view.h"
 
@@ -9,11 +10,16 @@ class Context;
 
 class StringFinder
 {
+    public:
+        struct Candidate { rd_address address; rd_flag flags; size_t totalsize, offset, length; }; // Text is Candidates::texts[offset, offset + length)
+        struct Candidates { std::vector<Candidate> items; std::string texts; };
+
     public:
         StringFinder() = delete;
-        static rd_flag categorize(Context* ctx, const RDBufferView& view, size_t* totalsize);
+        static rd_flag categorize(Context* ctx, const RDBufferView& view, size_t* totalsize, bool* pending = nullptr);
         static bool checkAndMark(Context* ctx, rd_address address, rd_flag flags, size_t totalsize);
-        static void find(Context* ctx, const RDBufferView& inview);
+        static void find(Context* ctx, const RDBufferView& inview, Candidates& candidates);
+        static void mark(Context* ctx, const Candidate& candidate, bool gibberish);
 
     public:
         template<typename T> static bool inline isAscii(T c) { return (c >= 0x09 && c <= 0x0D) || (c >= 0x20 && c <= 0x7E); }
@@ -21,18 +27,18 @@ class StringFinder
         static bool toAscii(char16_t inch, char* outch);
 
     private:
-        template<typename T, typename ToAsciiCallback> static bool categorizeT(RDBufferView view, size_t minstring, size_t* totalsize, const ToAsciiCallback& cb);
-        static bool step(Context* ctx, RDBufferView& view);
-        static bool validateString(const std::string& str);
-        static bool checkHeuristic(const std::string& s, bool gibberish);
+        template<typename T, typename ToAsciiCallback> static bool categorizeT(RDBufferView view, size_t minstring, size_t* totalsize, bool* pending, const ToAsciiCallback& cb);
+        static bool step(Context* ctx, RDBufferView& view, Candidates* candidates);
+        static bool validateString(const std::string& str, bool* pending);
+        static bool checkHeuristic(const std::string& s, bool gibberish, bool* pending);
         static bool checkFormats(const std::string& s);
 
     private:
-        static std::string m_tempstr;
+        static thread_local std::string m_tempstr;
 };
 
 template<typename T, typename ToAsciiCallback>
-bool StringFinder::categorizeT(RDBufferView view, size_t minstring, size_t* totalsize, const ToAsciiCallback& cb) {
+bool StringFinder::categorizeT(RDBufferView view, size_t minstring, size_t* totalsize, bool* pending, const ToAsciiCallback& cb) {
     m_tempstr.clear();
     char ch;
 
@@ -46,6 +52,6 @@ bool StringFinder::categorizeT(RDBufferView view, size_t minstring, size_t* tota
         if(!(*view.data)) *totalsize += sizeof(T); // Include null terminator too
     }
 
-    if(m_tempstr.size() >= minstring) return StringFinder::validateString(m_tempstr);
-    return StringFinder::checkHeuristic(m_tempstr, false);
+    if(m_tempstr.size() >= minstring) return StringFinder::validateString(m_tempstr, pending);
+    return StringFinder::checkHeuristic(m_tempstr, false, pending);
 }
@@ -1,9 +1,11 @@
 #include "graph.h"
+#include "graphanalysis.h"
 #include "../support/hash.h"
 #include <algorithm>
 #include <sstream>
 
 Graph::Graph(Context* ctx): Object(ctx) { }
+Graph::~Graph() = default;
 
 void Graph::clear()
 {
@@ -13,10 +15,11 @@ void Graph::clear()
     m_nodes.clear();
     m_nodeid = 0;
     m_root = {0};
+    this->invalidateAnalysis();
 }
 
 bool Graph::empty() const { return m_nodes.empty(); }
-RDGraphNode Graph::setRoot(RDGraphNode n) { m_root = n; return n; }
+RDGraphNode Graph::setRoot(RDGraphNode n) { m_root = n; this->invalidateAnalysis(); return n; }
 
 void Graph::removeEdge(const RDGraphEdge* edge)
 {
@@ -25,7 +28,10 @@ void Graph::removeEdge(const RDGraphEdge* edge)
                std::tie(e.source, e.target);
     });
 
-    if(it != m_edges.end()) m_edges.erase(it);
+    if(it == m_edges.end()) return;
+
+    m_edges.erase(it);
+    this->invalidateAnalysis();
 }
 
 void Graph::removeNode(RDGraphNode n)
@@ -35,12 +41,15 @@ void Graph::removeNode(RDGraphNode n)
 
     m_nodes.erase(it);
     this->removeEdges(n);
+    this->invalidateAnalysis();
 }
 
 void Graph::pushEdge(RDGraphNode source, RDGraphNode target)
 {
-    if(!this->containsEdge(source, target))
-        m_edges.push_back({ source, target });
+    if(this->containsEdge(source, target)) return;
+
+    m_edges.push_back({ source, target });
+    this->invalidateAnalysis();
 }
 
 bool Graph::containsEdge(RDGraphNode source, RDGraphNode target) const { return this->edge(source, target); }
@@ -93,6 +102,13 @@ size_t Graph::edges(const RDGraphEdge** edges) const { if(edges) *edges = m_edge
 RDGraphNode Graph::root() const { return m_root; }
 std::string Graph::nodeLabel(RDGraphNode n) const { return "#" + std::to_string(n); }
 
+const GraphAnalysis* Graph::analysis() const
+{
+    std::scoped_lock<std::mutex> lock(m_analysismutex);
+    if(!m_analysis) m_analysis = std::make_unique<GraphAnalysis>(this);
+    return m_analysis.get();
+}
+
 void Graph::removeOutgoingEdges(RDGraphNode n)
 {
     this->outgoing(n, nullptr);
@@ -109,7 +125,13 @@ void Graph::removeIncomingEdges(RDGraphNode n)
         this->removeEdge(&e);
 }
 
-RDGraphNode Graph::pushNode() { RDGraphNode n = ++m_nodeid; m_nodes.push_back(n); return n; }
+RDGraphNode Graph::pushNode()
+{
+    RDGraphNode n = ++m_nodeid;
+    m_nodes.push_back(n);
+    this->invalidateAnalysis();
+    return n;
+}
 
 std::string Graph::generateDOT() const
 {
@@ -151,3 +173,9 @@ void Graph::removeEdges(RDGraphNode n)
         else i++;
     }
 }
+
+void Graph::invalidateAnalysis()
+{
+    std::scoped_lock<std::mutex> lock(m_analysismutex);
+    m_analysis.reset();
+}
@@ -3,12 +3,17 @@
 #include <rdapi/graph/graph.h>
 #include <string>
 #include <vector>
+#include <memory>
+#include <mutex>
 #include "../object.h"
 
+class GraphAnalysis;
+
 class Graph: public Object
 {
     public:
         Graph(Context* ctx);
+        ~Graph();
         virtual void clear();
         RDGraphNode setRoot(RDGraphNode n);
         void removeEdge(const RDGraphEdge* e);
@@ -27,12 +32,14 @@ class Graph: public Object
         size_t nodes(const RDGraphNode** nodes) const;
         size_t edges(const RDGraphEdge** edges) const;
         RDGraphNode root() const;
+        const GraphAnalysis* analysis() const;
 
     protected:
         virtual std::string nodeLabel(RDGraphNode n) const;
         void removeOutgoingEdges(RDGraphNode n);
         void removeIncomingEdges(RDGraphNode n);
         void removeEdges(RDGraphNode n);
+        void invalidateAnalysis();
 
     protected:
         mutable std::vector<RDGraphEdge> m_incomings, m_outgoings;
@@ -40,4 +47,8 @@ class Graph: public Object
         std::vector<RDGraphNode> m_nodes;
         size_t m_nodeid{0};
         RDGraphNode m_root{0};
+
+    private:
+        mutable std::unique_ptr<GraphAnalysis> m_analysis;
+        mutable std::mutex m_analysismutex;
 };
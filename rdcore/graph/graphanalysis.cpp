@@ -0,0 +1,472 @@
+#include "graphanalysis.h"
+#include "graph.h"
+#include <algorithm>
+#include <numeric>
+#include <tuple>
+
+GraphAnalysis::GraphAnalysis(const Graph* graph)
+{
+    const RDGraphNode* nodes = nullptr;
+    size_t c = graph->nodes(&nodes);
+
+    m_nodes.assign(nodes, nodes + c);
+    m_index.reserve(c);
+    for(size_t i = 0; i < c; i++) m_index[nodes[i]] = i;
+
+    const RDGraphEdge* edges = nullptr;
+    size_t ec = graph->edges(&edges);
+
+    std::vector<std::pair<size_t, size_t>> forward, backward;
+    forward.reserve(ec);
+    backward.reserve(ec);
+
+    for(size_t i = 0; i < ec; i++)
+    {
+        size_t s = this->index(edges[i].source), t = this->index(edges[i].target);
+        if((s == RD_NVAL) || (t == RD_NVAL)) continue;
+
+        forward.emplace_back(s, t);
+        backward.emplace_back(t, s);
+    }
+
+    m_succ = GraphAnalysis::buildAdjacency(c, forward);
+    m_pred = GraphAnalysis::buildAdjacency(c, backward);
+    m_root = this->index(graph->root());
+}
+
+size_t GraphAnalysis::index(RDGraphNode n) const
+{
+    auto it = m_index.find(n);
+    return (it != m_index.end()) ? it->second : RD_NVAL;
+}
+
+size_t GraphAnalysis::dominators(const RDGraphNode** idoms) const
+{
+    const auto& tree = this->domTree();
+    if(idoms) *idoms = tree.nodes.data();
+    return tree.nodes.size();
+}
+
+size_t GraphAnalysis::postDominators(const RDGraphNode** ipdoms) const
+{
+    const auto& tree = this->postDomTree();
+    if(ipdoms) *ipdoms = tree.nodes.data();
+    return tree.nodes.size();
+}
+
+bool GraphAnalysis::dominator(RDGraphNode n, RDGraphNode* idom) const
+{
+    size_t i = this->index(n);
+    if(i == RD_NVAL) return false;
+
+    const auto& tree = this->domTree();
+    if(tree.nodes[i] == RD_NVAL) return false;
+
+    if(idom) *idom = tree.nodes[i];
+    return true;
+}
+
+bool GraphAnalysis::postDominator(RDGraphNode n, RDGraphNode* ipdom) const
+{
+    size_t i = this->index(n);
+    if(i == RD_NVAL) return false;
+
+    const auto& tree = this->postDomTree();
+    if(tree.nodes[i] == RD_NVAL) return false;
+
+    if(ipdom) *ipdom = tree.nodes[i];
+    return true;
+}
+
+bool GraphAnalysis::dominates(RDGraphNode a, RDGraphNode b) const { return GraphAnalysis::dominates(this->domTree(), this->index(a), this->index(b)); }
+bool GraphAnalysis::postDominates(RDGraphNode a, RDGraphNode b) const { return GraphAnalysis::dominates(this->postDomTree(), this->index(a), this->index(b)); }
+
+size_t GraphAnalysis::loops(const RDGraphNode** headers) const
+{
+    this->computeLoops();
+    if(headers) *headers = m_loopheaders.data();
+    return m_loopheaders.size();
+}
+
+size_t GraphAnalysis::loopBody(RDGraphNode header, const RDGraphNode** nodes) const
+{
+    this->computeLoops();
+
+    size_t i = this->index(header);
+    if((i == RD_NVAL) || (m_innerloop[i] == RD_NVAL)) return 0;
+
+    const Loop& l = m_loops[m_innerloop[i]];
+    if(l.header != i) return 0;
+
+    if(nodes) *nodes = l.body.data();
+    return l.body.size();
+}
+
+size_t GraphAnalysis::loopDepths(const size_t** depths) const
+{
+    this->computeLoops();
+    if(depths) *depths = m_loopdepths.data();
+    return m_loopdepths.size();
+}
+
+size_t GraphAnalysis::loopDepth(RDGraphNode n) const
+{
+    this->computeLoops();
+
+    size_t i = this->index(n);
+    return (i != RD_NVAL) ? m_loopdepths[i] : 0;
+}
+
+bool GraphAnalysis::loopHeader(RDGraphNode n, RDGraphNode* header) const
+{
+    this->computeLoops();
+
+    size_t i = this->index(n);
+    if((i == RD_NVAL) || (m_innerloop[i] == RD_NVAL)) return false;
+
+    if(header) *header = m_nodes[m_loops[m_innerloop[i]].header];
+    return true;
+}
+
+bool GraphAnalysis::loopParent(RDGraphNode header, RDGraphNode* parent) const
+{
+    this->computeLoops();
+
+    size_t i = this->index(header);
+    if((i == RD_NVAL) || (m_innerloop[i] == RD_NVAL)) return false;
+
+    const Loop& l = m_loops[m_innerloop[i]];
+    if((l.header != i) || (l.parent == RD_NVAL)) return false;
+
+    if(parent) *parent = m_nodes[m_loops[l.parent].header];
+    return true;
+}
+
+size_t GraphAnalysis::components(const size_t** sccs) const
+{
+    this->computeComponents();
+    if(sccs) *sccs = m_sccs.data();
+    return m_sccs.size();
+}
+
+size_t GraphAnalysis::componentsCount() const
+{
+    this->computeComponents();
+    return m_sccscount;
+}
+
+size_t GraphAnalysis::component(RDGraphNode n) const
+{
+    this->computeComponents();
+
+    size_t i = this->index(n);
+    return (i != RD_NVAL) ? m_sccs[i] : RD_NVAL;
+}
+
+const GraphAnalysis::DominatorTree& GraphAnalysis::domTree() const
+{
+    std::call_once(m_domonce, [&]() { this->buildDominatorTree(m_succ, m_pred, m_root, m_dom); });
+    return m_dom;
+}
+
+const GraphAnalysis::DominatorTree& GraphAnalysis::postDomTree() const
+{
+    std::call_once(m_pdomonce, [&]() {
+        // Walk the reversed graph from a virtual exit node linked to every node without successors
+        size_t c = m_nodes.size(), exit = c;
+        std::vector<std::pair<size_t, size_t>> forward, backward;
+        forward.reserve(m_succ.targets.size() + 1);
+        backward.reserve(m_succ.targets.size() + 1);
+
+        for(size_t s = 0; s < c; s++)
+        {
+            if(m_succ.offsets[s] == m_succ.offsets[s + 1])
+            {
+                forward.emplace_back(exit, s);
+                backward.emplace_back(s, exit);
+                continue;
+            }
+
+            for(size_t e = m_succ.offsets[s]; e < m_succ.offsets[s + 1]; e++)
+            {
+                forward.emplace_back(m_succ.targets[e], s);
+                backward.emplace_back(s, m_succ.targets[e]);
+            }
+        }
+
+        this->buildDominatorTree(GraphAnalysis::buildAdjacency(c + 1, forward),
+                                 GraphAnalysis::buildAdjacency(c + 1, backward), exit, m_pdom);
+    });
+
+    return m_pdom;
+}
+
+void GraphAnalysis::computeLoops() const
+{
+    std::call_once(m_loopsonce, [&]() {
+        const auto& dom = this->domTree();
+        size_t c = m_nodes.size();
+
+        std::vector<std::pair<size_t, size_t>> backedges; // Header -> Latch
+
+        for(size_t u = 0; u < c; u++)
+        {
+            for(size_t e = m_succ.offsets[u]; e < m_succ.offsets[u + 1]; e++)
+            {
+                size_t h = m_succ.targets[e];
+                if(GraphAnalysis::dominates(dom, h, u)) backedges.emplace_back(h, u);
+            }
+        }
+
+        std::sort(backedges.begin(), backedges.end(), [&](const auto& a, const auto& b) {
+            return std::tie(dom.pre[a.first], a.second) < std::tie(dom.pre[b.first], b.second);
+        });
+
+        std::vector<size_t> marks(c, RD_NVAL), worklist;
+
+        for(size_t i = 0; i < backedges.size(); i++)
+        {
+            auto [h, u] = backedges[i];
+
+            if(m_loops.empty() || (m_loops.back().header != h))
+            {
+                marks[h] = m_loops.size();
+                m_loops.push_back({ h, RD_NVAL, { m_nodes[h] } });
+            }
+
+            size_t li = m_loops.size() - 1;
+            if(marks[u] != li) { marks[u] = li; worklist.push_back(u); }
+
+            while(!worklist.empty())
+            {
+                size_t v = worklist.back();
+                worklist.pop_back();
+                m_loops[li].body.push_back(m_nodes[v]);
+
+                for(size_t e = m_pred.offsets[v]; e < m_pred.offsets[v + 1]; e++)
+                {
+                    size_t p = m_pred.targets[e];
+                    if((marks[p] == li) || (dom.pre[p] == RD_NVAL)) continue;
+
+                    marks[p] = li;
+                    worklist.push_back(p);
+                }
+            }
+        }
+
+        // Outer loops are visited first, inner ones overwrite them
+        std::vector<size_t> bysize(m_loops.size());
+        std::iota(bysize.begin(), bysize.end(), 0);
+        std::stable_sort(bysize.begin(), bysize.end(), [&](size_t a, size_t b) { return m_loops[a].body.size() > m_loops[b].body.size(); });
+
+        m_loopdepths.assign(c, 0);
+        m_innerloop.assign(c, RD_NVAL);
+
+        for(size_t li : bysize)
+        {
+            Loop& l = m_loops[li];
+            l.parent = m_innerloop[l.header];
+
+            for(RDGraphNode n : l.body)
+            {
+                size_t i = this->index(n);
+                m_loopdepths[i]++;
+                m_innerloop[i] = li;
+            }
+        }
+
+        m_loopheaders.reserve(m_loops.size());
+        for(const Loop& l : m_loops) m_loopheaders.push_back(m_nodes[l.header]);
+    });
+}
+
+void GraphAnalysis::computeComponents() const
+{
+    std::call_once(m_sccsonce, [&]() { // Iterative Tarjan, components are numbered in reverse topological order
+        size_t c = m_nodes.size(), counter = 0;
+        std::vector<size_t> idx(c, RD_NVAL), low(c, 0), stack;
+        std::vector<std::pair<size_t, size_t>> callstack;
+        std::vector<bool> onstack(c, false);
+        m_sccs.assign(c, RD_NVAL);
+
+        for(size_t s = 0; s < c; s++)
+        {
+            if(idx[s] != RD_NVAL) continue;
+
+            idx[s] = low[s] = counter++;
+            stack.push_back(s);
+            onstack[s] = true;
+            callstack.emplace_back(s, m_succ.offsets[s]);
+
+            while(!callstack.empty())
+            {
+                auto& [v, e] = callstack.back();
+
+                if(e < m_succ.offsets[v + 1])
+                {
+                    size_t w = m_succ.targets[e++];
+
+                    if(idx[w] == RD_NVAL)
+                    {
+                        idx[w] = low[w] = counter++;
+                        stack.push_back(w);
+                        onstack[w] = true;
+                        callstack.emplace_back(w, m_succ.offsets[w]);
+                    }
+                    else if(onstack[w])
+                        low[v] = std::min(low[v], idx[w]);
+
+                    continue;
+                }
+
+                size_t r = v;
+
+                if(low[r] == idx[r])
+                {
+                    size_t w;
+
+                    do
+                    {
+                        w = stack.back();
+                        stack.pop_back();
+                        onstack[w] = false;
+                        m_sccs[w] = m_sccscount;
+                    }
+                    while(w != r);
+
+                    m_sccscount++;
+                }
+
+                callstack.pop_back();
+                if(!callstack.empty()) low[callstack.back().first] = std::min(low[callstack.back().first], low[r]);
+            }
+        }
+    });
+}
+
+void GraphAnalysis::buildDominatorTree(const Adjacency& succ, const Adjacency& pred, size_t root, DominatorTree& tree) const
+{
+    size_t c = succ.offsets.size() - 1;
+    tree.idom.assign(c, RD_NVAL);
+    tree.pre.assign(c, RD_NVAL);
+    tree.post.assign(c, RD_NVAL);
+    tree.nodes.assign(m_nodes.size(), RD_NVAL);
+    if(root >= c) return;
+
+    // Postorder numbering of the reachable nodes
+    std::vector<size_t> postnum(c, RD_NVAL), order;
+    std::vector<std::pair<size_t, size_t>> stack;
+    std::vector<bool> visited(c, false);
+    order.reserve(c);
+
+    visited[root] = true;
+    stack.emplace_back(root, succ.offsets[root]);
+
+    while(!stack.empty())
+    {
+        auto& [v, e] = stack.back();
+
+        if(e < succ.offsets[v + 1])
+        {
+            size_t w = succ.targets[e++];
+            if(visited[w]) continue;
+
+            visited[w] = true;
+            stack.emplace_back(w, succ.offsets[w]);
+            continue;
+        }
+
+        postnum[v] = order.size();
+        order.push_back(v);
+        stack.pop_back();
+    }
+
+    // Cooper-Harvey-Kennedy: iterate in reverse postorder until the idoms settle
+    tree.idom[root] = root;
+
+    for(bool changed = true; changed; )
+    {
+        changed = false;
+
+        for(auto it = order.rbegin(); it != order.rend(); it++)
+        {
+            size_t v = *it, newidom = RD_NVAL;
+            if(v == root) continue;
+
+            for(size_t e = pred.offsets[v]; e < pred.offsets[v + 1]; e++)
+            {
+                size_t p = pred.targets[e];
+                if(tree.idom[p] == RD_NVAL) continue;
+
+                if(newidom == RD_NVAL)
+                {
+                    newidom = p;
+                    continue;
+                }
+
+                while(p != newidom)
+                {
+                    while(postnum[p] < postnum[newidom]) p = tree.idom[p];
+                    while(postnum[newidom] < postnum[p]) newidom = tree.idom[newidom];
+                }
+            }
+
+            if(tree.idom[v] == newidom) continue;
+            tree.idom[v] = newidom;
+            changed = true;
+        }
+    }
+
+    // Pre/Post intervals on the dominator tree make 'dominates' O(1)
+    std::vector<std::pair<size_t, size_t>> treeedges;
+    treeedges.reserve(order.size());
+
+    for(size_t v : order)
+    {
+        if(v != root) treeedges.emplace_back(tree.idom[v], v);
+        if((v < m_nodes.size()) && (tree.idom[v] < m_nodes.size()) && (v != root)) tree.nodes[v] = m_nodes[tree.idom[v]];
+    }
+
+    Adjacency children = GraphAnalysis::buildAdjacency(c, treeedges);
+    size_t clock = 0;
+
+    tree.pre[root] = clock++;
+    stack.emplace_back(root, children.offsets[root]);
+
+    while(!stack.empty())
+    {
+        auto& [v, e] = stack.back();
+
+        if(e < children.offsets[v + 1])
+        {
+            size_t w = children.targets[e++];
+            tree.pre[w] = clock++;
+            stack.emplace_back(w, children.offsets[w]);
+            continue;
+        }
+
+        tree.post[v] = clock++;
+        stack.pop_back();
+    }
+}
+
+bool GraphAnalysis::dominates(const DominatorTree& tree, size_t a, size_t b)
+{
+    if((a >= tree.pre.size()) || (b >= tree.pre.size())) return false;
+    if((tree.pre[a] == RD_NVAL) || (tree.pre[b] == RD_NVAL)) return false;
+    return (tree.pre[a] <= tree.pre[b]) && (tree.post[b] <= tree.post[a]);
+}
+
+GraphAnalysis::Adjacency GraphAnalysis::buildAdjacency(size_t count, const std::vector<std::pair<size_t, size_t>>& edges)
+{
+    Adjacency adj;
+    adj.offsets.assign(count + 1, 0);
+    adj.targets.resize(edges.size());
+
+    for(const auto& [s, t] : edges) adj.offsets[s + 1]++;
+    std::partial_sum(adj.offsets.begin(), adj.offsets.end(), adj.offsets.begin());
+
+    std::vector<size_t> fill(adj.offsets.begin(), adj.offsets.end() - 1);
+    for(const auto& [s, t] : edges) adj.targets[fill[s]++] = t;
+    return adj;
+}
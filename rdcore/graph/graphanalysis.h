@@ -0,0 +1,65 @@
+#pragma once
+
+#include <rdapi/graph/graph.h>
+#include <unordered_map>
+#include <vector>
+#include <mutex>
+
+class Graph;
+
+class GraphAnalysis // Dominators, loops and SCCs over a node indexed snapshot of a graph
+{
+    private:
+        struct Adjacency { std::vector<size_t> offsets, targets; };
+        struct DominatorTree { std::vector<size_t> idom, pre, post; std::vector<RDGraphNode> nodes; };
+        struct Loop { size_t header, parent; std::vector<RDGraphNode> body; };
+
+    public:
+        GraphAnalysis(const Graph* graph);
+        size_t index(RDGraphNode n) const;
+
+    public: // Dominators
+        size_t dominators(const RDGraphNode** idoms) const;
+        size_t postDominators(const RDGraphNode** ipdoms) const;
+        bool dominator(RDGraphNode n, RDGraphNode* idom) const;
+        bool postDominator(RDGraphNode n, RDGraphNode* ipdom) const;
+        bool dominates(RDGraphNode a, RDGraphNode b) const;
+        bool postDominates(RDGraphNode a, RDGraphNode b) const;
+
+    public: // Natural Loops
+        size_t loops(const RDGraphNode** headers) const;
+        size_t loopBody(RDGraphNode header, const RDGraphNode** nodes) const;
+        size_t loopDepths(const size_t** depths) const;
+        size_t loopDepth(RDGraphNode n) const;
+        bool loopHeader(RDGraphNode n, RDGraphNode* header) const;
+        bool loopParent(RDGraphNode header, RDGraphNode* parent) const;
+
+    public: // Strongly Connected Components
+        size_t components(const size_t** sccs) const;
+        size_t componentsCount() const;
+        size_t component(RDGraphNode n) const;
+
+    private:
+        const DominatorTree& domTree() const;
+        const DominatorTree& postDomTree() const;
+        void computeLoops() const;
+        void computeComponents() const;
+        void buildDominatorTree(const Adjacency& succ, const Adjacency& pred, size_t root, DominatorTree& tree) const;
+        static bool dominates(const DominatorTree& tree, size_t a, size_t b);
+        static Adjacency buildAdjacency(size_t count, const std::vector<std::pair<size_t, size_t>>& edges);
+
+    private:
+        std::vector<RDGraphNode> m_nodes;                // Index -> Node, same order as Graph::nodes()
+        std::unordered_map<RDGraphNode, size_t> m_index; // Node -> Index
+        Adjacency m_succ, m_pred;
+        size_t m_root{RD_NVAL};
+
+    private: // Computed on demand
+        mutable std::once_flag m_domonce, m_pdomonce, m_loopsonce, m_sccsonce;
+        mutable DominatorTree m_dom, m_pdom;
+        mutable std::vector<Loop> m_loops;
+        mutable std::vector<RDGraphNode> m_loopheaders;
+        mutable std::vector<size_t> m_loopdepths, m_innerloop;
+        mutable std::vector<size_t> m_sccs;
+        mutable size_t m_sccscount{0};
+};
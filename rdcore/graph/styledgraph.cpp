@@ -5,8 +5,7 @@ StyledGraph::StyledGraph(Context* ctx): DataGraph(ctx) { }
 
 void StyledGraph::clearLayout()
 {
-    m_nodeattributes.clear();
-    m_edgeattributes.clear();
+    m_layout.reset();
     m_areawidth = m_areaheight = 0;
 }
 
@@ -16,80 +15,104 @@ void StyledGraph::clear()
     this->clearLayout();
 }
 
-void StyledGraph::color(const RDGraphEdge* e, const std::string& c) { m_edgeattributes[*e].color = c; }
-void StyledGraph::label(const RDGraphEdge* e, const std::string& l) { m_edgeattributes[*e].label = l; }
+void StyledGraph::color(const RDGraphEdge* e, const std::string& c) { this->layout()->edgeattributes[*e].color = c; }
+void StyledGraph::label(const RDGraphEdge* e, const std::string& l) { this->layout()->edgeattributes[*e].label = l; }
 
 void StyledGraph::routes(const RDGraphEdge* e, const RDGraphPoint* p, size_t n)
 {
-    m_edgeattributes[*e].routes.resize(n);
-    std::copy_n(p, n, m_edgeattributes[*e].routes.data());
+    auto& routes = this->layout()->edgeattributes[*e].routes;
+    routes.resize(n);
+    std::copy_n(p, n, routes.data());
 }
 
 void StyledGraph::arrow(const RDGraphEdge* e, const RDGraphPoint* p, size_t n)
 {
-    m_edgeattributes[*e].arrow.resize(n);
-    std::copy_n(p, n, m_edgeattributes[*e].arrow.data());
+    auto& arrow = this->layout()->edgeattributes[*e].arrow;
+    arrow.resize(n);
+    std::copy_n(p, n, arrow.data());
 }
 
 void StyledGraph::areaWidth(int w) { m_areawidth = w; }
 void StyledGraph::areaHeight(int h) { m_areaheight = h; }
-void StyledGraph::x(RDGraphNode n, int px) { m_nodeattributes[n].x = px; }
-void StyledGraph::y(RDGraphNode n, int py) { m_nodeattributes[n].y = py; }
-void StyledGraph::width(RDGraphNode n, int w) { m_nodeattributes[n].width = w; }
-void StyledGraph::height(RDGraphNode n, int h) { m_nodeattributes[n].height = h; }
+void StyledGraph::x(RDGraphNode n, int px) { this->layout()->nodeattributes[n].x = px; }
+void StyledGraph::y(RDGraphNode n, int py) { this->layout()->nodeattributes[n].y = py; }
+void StyledGraph::width(RDGraphNode n, int w) { this->layout()->nodeattributes[n].width = w; }
+void StyledGraph::height(RDGraphNode n, int h) { this->layout()->nodeattributes[n].height = h; }
 int StyledGraph::areaWidth() const { return m_areawidth; }
 int StyledGraph::areaHeight() const { return m_areaheight; }
 
 const char* StyledGraph::color(const RDGraphEdge* e) const
 {
-    auto it = m_edgeattributes.find(*e);
-    return (it != m_edgeattributes.end()) ? it->second.color.c_str() : nullptr;
+    const EdgeAttributes* ea = this->edgeAttributes(e);
+    return ea ? ea->color.c_str() : nullptr;
 }
 
 const char* StyledGraph::label(const RDGraphEdge* e) const
 {
-    auto it = m_edgeattributes.find(*e);
-    return (it != m_edgeattributes.end()) ? it->second.label.c_str() : nullptr;
+    const EdgeAttributes* ea = this->edgeAttributes(e);
+    return ea ? ea->label.c_str() : nullptr;
 }
 
 size_t StyledGraph::routes(const RDGraphEdge* e, const RDGraphPoint** path) const
 {
-    auto it = m_edgeattributes.find(*e);
-    if(it == m_edgeattributes.end()) return 0;
+    const EdgeAttributes* ea = this->edgeAttributes(e);
+    if(!ea) return 0;
 
-    if(path) *path = it->second.routes.data();
-    return it->second.routes.size();
+    if(path) *path = ea->routes.data();
+    return ea->routes.size();
 }
 
 size_t StyledGraph::arrow(const RDGraphEdge* e, const RDGraphPoint** path) const
 {
-    auto it = m_edgeattributes.find(*e);
-    if(it == m_edgeattributes.end()) return 0;
+    const EdgeAttributes* ea = this->edgeAttributes(e);
+    if(!ea) return 0;
 
-    if(path) *path = it->second.arrow.data();
-    return it->second.arrow.size();
+    if(path) *path = ea->arrow.data();
+    return ea->arrow.size();
 }
 
 int StyledGraph::x(RDGraphNode n) const
 {
-    auto it = m_nodeattributes.find(n);
-    return (it != m_nodeattributes.end()) ? it->second.x : 0;
+    const NodeAttributes* na = this->nodeAttributes(n);
+    return na ? na->x : 0;
 }
 
 int StyledGraph::y(RDGraphNode n) const
 {
-    auto it = m_nodeattributes.find(n);
-    return (it != m_nodeattributes.end()) ? it->second.y : 0;
+    const NodeAttributes* na = this->nodeAttributes(n);
+    return na ? na->y : 0;
 }
 
 int StyledGraph::width(RDGraphNode n) const
 {
-    auto it = m_nodeattributes.find(n);
-    return (it != m_nodeattributes.end()) ? it->second.width : 0;
+    const NodeAttributes* na = this->nodeAttributes(n);
+    return na ? na->width : 0;
 }
 
 int StyledGraph::height(RDGraphNode n) const
 {
-    auto it = m_nodeattributes.find(n);
-    return (it != m_nodeattributes.end()) ? it->second.height : 0;
+    const NodeAttributes* na = this->nodeAttributes(n);
+    return na ? na->height : 0;
+}
+
+StyledGraph::Layout* StyledGraph::layout()
+{
+    if(!m_layout) m_layout = std::make_unique<Layout>();
+    return m_layout.get();
+}
+
+const StyledGraph::NodeAttributes* StyledGraph::nodeAttributes(RDGraphNode n) const
+{
+    if(!m_layout) return nullptr;
+
+    auto it = m_layout->nodeattributes.find(n);
+    return (it != m_layout->nodeattributes.end()) ? std::addressof(it->second) : nullptr;
+}
+
+const StyledGraph::EdgeAttributes* StyledGraph::edgeAttributes(const RDGraphEdge* e) const
+{
+    if(!m_layout) return nullptr;
+
+    auto it = m_layout->edgeattributes.find(*e);
+    return (it != m_layout->edgeattributes.end()) ? std::addressof(it->second) : nullptr;
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <unordered_map>
+#include <memory>
 #include <vector>
 #include <string>
 #include "datagraph.h"
@@ -17,6 +18,11 @@ class StyledGraph: public DataGraph
             GraphPoints routes, arrow;
         };
 
+        struct Layout {
+            std::unordered_map<RDGraphNode, NodeAttributes> nodeattributes;
+            std::unordered_map<RDGraphEdge, EdgeAttributes> edgeattributes;
+        };
+
     public:
         StyledGraph(Context* ctx);
         void clearLayout();
@@ -47,7 +53,11 @@ class StyledGraph: public DataGraph
         int height(RDGraphNode n) const;
 
     private:
-        std::unordered_map<RDGraphNode, NodeAttributes> m_nodeattributes;
-        std::unordered_map<RDGraphEdge, EdgeAttributes> m_edgeattributes;
+        Layout* layout();
+        const NodeAttributes* nodeAttributes(RDGraphNode n) const;
+        const EdgeAttributes* edgeAttributes(const RDGraphEdge* e) const;
+
+    private:
+        std::unique_ptr<Layout> m_layout; // Allocated when the graph is laid out
         int m_areawidth{0}, m_areaheight{0};
 };
@@ -8,4 +8,14 @@ bool Analyzer::isEnabled() const
     return false;
 }
 
+bool Analyzer::isThreadSafe() const { return HAS_FLAG(m_entry, AnalyzerFlags_ThreadSafe); }
+
+bool Analyzer::conflicts(const Analyzer* analyzer) const
+{
+    if(!this->isThreadSafe() || !analyzer->isThreadSafe()) return true;
+    return (this->writes() & (analyzer->reads() | analyzer->writes())) || (this->reads() & analyzer->writes());
+}
+
+rd_flag Analyzer::reads() const { return m_entry->reads ? m_entry->reads : static_cast<rd_flag>(AnalyzerResources_All); }
+rd_flag Analyzer::writes() const { return m_entry->writes ? m_entry->writes : static_cast<rd_flag>(AnalyzerResources_All); }
 void Analyzer::execute() const { if(m_entry->execute) m_entry->execute(CPTR(RDContext, this->context())); }
@@ -8,5 +8,9 @@ class Analyzer: public Entry<RDEntryAnalyzer>
     public:
         Analyzer(const RDEntryAnalyzer* entry, Context* ctx);
         bool isEnabled() const;
+        bool isThreadSafe() const;
+        bool conflicts(const Analyzer* analyzer) const;
+        rd_flag reads() const;
+        rd_flag writes() const;
         void execute() const;
 };
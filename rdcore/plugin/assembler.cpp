@@ -19,6 +19,8 @@ bool Assembler::encode(RDEncodedInstruction* encoded) const
 }
 
 void Assembler::emulate(EmulateResult* result) const { if(m_entry->emulate) m_entry->emulate(CPTR(RDContext, this->context()), CPTR(RDEmulateResult, result)); }
+void Assembler::emulateBatch(EmulateBatch* batch) const { if(m_entry->emulatebatch) m_entry->emulatebatch(CPTR(RDContext, this->context()), CPTR(RDEmulateBatch, batch)); }
+bool Assembler::canEmulateBatch() const { return m_entry->emulatebatch; }
 
 bool Assembler::renderInstruction(const RDRendererParams* rp)
 {
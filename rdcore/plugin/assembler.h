@@ -10,6 +10,7 @@
 
 class Disassembler;
 class EmulateResult;
+class EmulateBatch;
 class ILFunction;
 
 class Assembler: public Entry<RDEntryAssembler>
@@ -22,6 +23,8 @@ class Assembler: public Entry<RDEntryAssembler>
         bool renderSegment(const RDRendererParams* rp);
         bool encode(RDEncodedInstruction* encoded) const;
         void emulate(EmulateResult* result) const;
+        void emulateBatch(EmulateBatch* batch) const;
+        bool canEmulateBatch() const;
         size_t addressWidth() const;
         size_t bits() const;
 };
@@ -5,32 +5,52 @@
 #include <filesystem>
 #include <cstring>
 
-PluginManager::PluginManager(Context* ctx): Object(ctx)
+PluginManager::PluginManager(Context* ctx, const PluginManager* runtime): Object(ctx)
 {
     for(size_t i = 0; i < EntryCategory_Last; i++) m_entries[i] = { }; // Initialize all categories
-    for(const auto& pluginpath : rd_cfg->pluginPaths()) this->loadAll(pluginpath);
+
+    if(runtime) this->inherit(runtime); // Plugin paths are walked once, by the runtime
+    else for(const auto& pluginpath : rd_cfg->pluginPaths()) this->discoverAll(pluginpath);
+
     this->loadBuiltins();
+    if(!runtime) rd_manifest->save();
 }
 
-const PluginManager::EntryList& PluginManager::loaders() const { return m_entries.at(EntryCategory_Loader); }
-const PluginManager::EntryList& PluginManager::assemblers() const { return m_entries.at(EntryCategory_Assembler); }
-const PluginManager::EntryList& PluginManager::analyzers() const { return m_entries.at(EntryCategory_Analyzer); }
+// Loaders and analyzers run callbacks (test, isenabled) when they are enumerated: load what is still pending
+const PluginManager::EntryList& PluginManager::loaders() { this->loadCategory(EntryCategory_Loader); return m_entries.at(EntryCategory_Loader); }
+const PluginManager::EntryList& PluginManager::analyzers() { this->loadCategory(EntryCategory_Analyzer); return m_entries.at(EntryCategory_Analyzer); }
+
+const PluginManager::EntryList& PluginManager::assemblers()
+{
+    m_assemblerlist = m_entries.at(EntryCategory_Assembler);
+
+    for(const auto& [id, a] : m_manifestassemblers) // Not loaded yet, getAssembler() and selectAssembler() load them
+    {
+        if(!m_missing.count(id) && !this->findAssembler(id))
+            m_assemblerlist.push_back(reinterpret_cast<const RDEntry*>(&a.entry));
+    }
+
+    return m_assemblerlist;
+}
 
 const RDEntryAssembler* PluginManager::getAssembler(const std::string& id)
 {
     auto* entry = this->findAssembler(id);
+    if(entry || m_missing.count(id)) return entry;
 
-    if(!entry)
+    if(auto it = m_filepaths.find(id); it != m_filepaths.end())
     {
-        if(auto it = m_filepaths.find(id); it != m_filepaths.end())
-        {
-            this->load(it->second);
-            entry = this->findAssembler(id);
-        }
+        fs::path filepath = it->second;
+        m_loaded.erase(filepath); // Allow reloading unloaded modules
+        this->load(filepath);     // Refreshes its manifest entry too
+        entry = this->findAssembler(id);
+
+        if(!entry && (m_filepaths[id] == filepath)) m_filepaths.erase(id); // The module doesn't provide it anymore
     }
 
     if(!entry)
     {
+        m_missing.insert(id); // Don't load it again on every lookup
         spdlog::error("PluginManager::getAssembler('{}'): Not Found", id);
         rd_log("Cannot load assembler " + Utils::quoted(id));
     }
@@ -40,12 +60,45 @@ const RDEntryAssembler* PluginManager::getAssembler(const std::string& id)
 
 const RDEntryAssembler* PluginManager::findAssembler(const std::string& id) const { return this->findEntry<RDEntryAssembler>(EntryCategory_Assembler, id); }
 const RDEntryLoader* PluginManager::selectLoader(const std::string& id) { return reinterpret_cast<const RDEntryLoader*>(this->selectEntry(EntryCategory_Loader, id)); }
-const RDEntryAssembler* PluginManager::selectAssembler(const std::string& id) { return reinterpret_cast<const RDEntryAssembler*>(this->selectEntry(EntryCategory_Assembler, id)); }
+const RDEntryAssembler* PluginManager::selectAssembler(const std::string& id) { this->getAssembler(id); return reinterpret_cast<const RDEntryAssembler*>(this->selectEntry(EntryCategory_Assembler, id)); }
 
-bool PluginManager::executeCommand(const std::string& cmd, const RDArguments* a) const
+bool PluginManager::hasEntry(size_t c, const std::string& id) const
+{
+    if(m_filepaths.count(id)) // Known from the manifest, maybe not loaded
+    {
+        auto it = m_pending.find(c);
+        if((it != m_pending.end()) && it->second.count(m_filepaths.at(id))) return true;
+    }
+
+    auto cit = m_entries.find(c);
+    if(cit == m_entries.end()) return false;
+    return std::any_of(cit->second.begin(), cit->second.end(), [&](const RDEntry* e) { return e->id == id; });
+}
+
+std::string PluginManager::fingerprint(const RDEntry* entry) const
+{
+    std::string s = std::string(entry->id) + "@" + std::to_string(entry->apilevel);
+
+    auto it = m_filepaths.find(entry->id);
+    if(it == m_filepaths.end()) return s + ":builtin:" + LIBREDASM_VERSION; // Built-ins change with the library
+
+    std::error_code ec; // A rebuilt module changes size or timestamp
+    auto size = fs::file_size(it->second, ec);
+    auto mtime = fs::last_write_time(it->second, ec).time_since_epoch().count();
+    return s + ":" + std::to_string(size) + ":" + std::to_string(mtime);
+}
+
+bool PluginManager::executeCommand(const std::string& cmd, const RDArguments* a)
 {
     auto it = m_commands.find(cmd);
 
+    if((it == m_commands.end()) && this->hasEntry(EntryCategory_Command, cmd))
+    {
+        this->load(m_filepaths.at(cmd));
+        this->checkCommands();
+        it = m_commands.find(cmd);
+    }
+
     if(it == m_commands.end())
     {
         this->log("Cannot find command " + Utils::quoted(cmd));
@@ -77,7 +130,7 @@ void PluginManager::checkCommands()
     }
 }
 
-void PluginManager::loadAll(const fs::path& pluginpath)
+void PluginManager::discoverAll(const fs::path& pluginpath)
 {
     std::filesystem::directory_entry e(pluginpath);
     if(!e.is_directory()) return;
@@ -85,10 +138,87 @@ void PluginManager::loadAll(const fs::path& pluginpath)
     for(const auto& entry : std::filesystem::recursive_directory_iterator(e, std::filesystem::directory_options::follow_directory_symlink))
     {
         if(entry.is_directory() || entry.path().extension() != SHARED_OBJECT_EXT) continue;
-        this->load(entry.path());
+        this->discover(entry.path());
     }
 }
 
+void PluginManager::discover(const fs::path& filepath)
+{
+    PluginManifest::Entries entries;
+
+    if(!rd_manifest->lookup(filepath, &entries)) // Unknown or changed: load it and remember what it provides
+    {
+        this->load(filepath);
+        return;
+    }
+
+    this->discover(filepath, entries);
+}
+
+void PluginManager::discover(const fs::path& filepath, const PluginManifest::Entries& entries)
+{
+    for(const auto& e : entries)
+    {
+        if(m_filepaths.count(e.id))
+        {
+            spdlog::warn("PluginManager::discover('{}'): Duplicate entry '{}'", filepath.string(), e.id);
+            continue;
+        }
+
+        m_filepaths[e.id] = filepath;
+        m_pending[e.category].insert(filepath);
+        if(e.category != EntryCategory_Assembler) continue;
+
+        auto& a = m_manifestassemblers[e.id];
+        a.id = e.id;
+        a.name = e.name;
+        a.entry = { };
+        a.entry.apilevel = RDAPI_LEVEL;
+        a.entry.apibits = sizeof(size_t);
+        a.entry.id = a.id.c_str();
+        a.entry.name = a.name.c_str();
+        a.entry.bits = e.bits;
+    }
+}
+
+void PluginManager::inherit(const PluginManager* runtime)
+{
+    // Modules known to the runtime are listed as if they came from the manifest, they load on demand here too
+    std::map<fs::path, PluginManifest::Entries> modules;
+
+    for(const auto& [c, entries] : runtime->m_entries)
+    {
+        for(const RDEntry* e : entries)
+        {
+            auto it = runtime->m_filepaths.find(e->id);
+            if(it == runtime->m_filepaths.end()) continue; // Built-in
+
+            u32 bits = (c == EntryCategory_Assembler) ? reinterpret_cast<const RDEntryAssembler*>(e)->bits : 0;
+            modules[it->second].push_back({c, e->id, e->name ? e->name : std::string(), bits});
+        }
+    }
+
+    std::set<fs::path> pending; // Never loaded by the runtime
+    for(const auto& [c, filepaths] : runtime->m_pending) pending.insert(filepaths.begin(), filepaths.end());
+
+    for(const auto& filepath : pending) { if(!modules.count(filepath)) this->discover(filepath); }
+    for(const auto& [filepath, entries] : modules) this->discover(filepath, entries);
+}
+
+void PluginManager::loadAll()
+{
+    for(size_t c = 0; c < EntryCategory_Last; c++) this->loadCategory(c);
+}
+
+void PluginManager::loadCategory(size_t c)
+{
+    auto it = m_pending.find(c);
+    if(it == m_pending.end()) return;
+
+    auto filepaths = it->second; // load() updates m_pending
+    for(const auto& filepath : filepaths) this->load(filepath);
+}
+
 void PluginManager::unload(const RDEntry* entry)
 {
     spdlog::debug("PluginManager::unload({:p}): Removing module '{}'", reinterpret_cast<const void*>(entry), entry->id);
@@ -125,16 +255,34 @@ void PluginManager::loadBuiltins()
 
 void PluginManager::load(const fs::path& filepath)
 {
+    if(m_loaded.count(filepath)) return;
+    m_loaded.insert(filepath);
+    for(auto& [c, filepaths] : m_pending) filepaths.erase(filepath);
+
     auto pm = std::make_shared<PluginModule>(this->context(), filepath);
+    PluginManifest::Entries manifestentries;
+
+    if(pm->loaded())
+    {
+        for(const auto& [category, entry] : pm->entries())
+        {
+            u32 bits = (category == EntryCategory_Assembler) ? reinterpret_cast<const RDEntryAssembler*>(entry)->bits : 0;
+            manifestentries.push_back({category, entry->id, entry->name ? entry->name : std::string(), bits});
+        }
+    }
+
+    rd_manifest->update(filepath, manifestentries); // Invalid modules are remembered too
     if(!pm->loaded()) return;
 
     auto entries = this->load(pm);
 
     for(const auto& entryid : entries)
     {
-        if(m_filepaths.count(entryid))
+        auto it = m_filepaths.find(entryid);
+
+        if((it != m_filepaths.end()) && (it->second != filepath))
         {
-            spdlog::warn("PluginManager::load('{}'): Duplicate entry '{}'", entryid);
+            spdlog::warn("PluginManager::load('{}'): Duplicate entry '{}'", filepath.string(), entryid);
             continue;
         }
 
@@ -158,6 +306,7 @@ std::vector<std::string> PluginManager::load(const PluginModulePtr& pm)
         spdlog::debug("PluginManager::load(): Loading '{}' as '{}, category #{}", entry->name, entry->id, category);
         m_entries[category].push_back(entry);
         m_modules[entry->id] = pm;
+        m_missing.erase(entry->id);
         entries.push_back(entry->id);
     }
 
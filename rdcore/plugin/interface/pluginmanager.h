@@ -1,33 +1,46 @@
 #pragma once
 
 #include <rdapi/plugin/entry.h>
+#include <rdapi/plugin/assembler/assembler.h>
 #include <unordered_map>
+#include <unordered_set>
+#include <map>
+#include <set>
 #include <string>
 #include "pluginmodule.h"
+#include "pluginmanifest.h"
 #include "../../object.h"
 
 class PluginManager: public Object
 {
     private:
         typedef std::vector<const RDEntry*> EntryList;
+        struct ManifestAssembler { RDEntryAssembler entry; std::string id, name; }; // Header and bits only, see assemblers()
 
     public:
-        PluginManager(Context* ctx);
-        const EntryList& loaders() const;
-        const EntryList& assemblers() const;
-        const EntryList& analyzers() const;
+        PluginManager(Context* ctx, const PluginManager* runtime = nullptr);
+        const EntryList& loaders();
+        const EntryList& assemblers();
+        const EntryList& analyzers();
         const RDEntryAssembler* getAssembler(const std::string& id);
         const RDEntryAssembler* findAssembler(const std::string& id) const;
         const RDEntryAssembler* selectAssembler(const std::string& id);
         const RDEntryLoader* selectLoader(const std::string& id);
-        bool executeCommand(const std::string& cmd, const RDArguments* a) const;
+        bool hasEntry(size_t c, const std::string& id) const;
+        std::string fingerprint(const RDEntry* entry) const;
+        bool executeCommand(const std::string& cmd, const RDArguments* a);
         void unload(const RDEntry* entry);
         void checkCommands();
+        void loadAll();
 
     private:
         template<typename T> const T* findEntry(size_t c, const std::string& id) const;
         const RDEntry* selectEntry(size_t c, const std::string& id);
-        void loadAll(const fs::path& pluginpath);
+        void discoverAll(const fs::path& pluginpath);
+        void discover(const fs::path& filepath);
+        void discover(const fs::path& filepath, const PluginManifest::Entries& entries);
+        void inherit(const PluginManager* runtime);
+        void loadCategory(size_t c);
         void load(const fs::path& filepath);
         std::vector<std::string> load(const PluginModulePtr& pm);
         bool checkArguments(const RDEntryCommand* command, const RDArguments* a) const;
@@ -38,6 +51,11 @@ class PluginManager: public Object
         std::unordered_map<std::string, PluginModulePtr> m_modules;        // pluginid -> PluginModule
         std::unordered_map<std::string, const RDEntryCommand*> m_commands;
         std::unordered_map<std::string, fs::path> m_filepaths;             // pluginid -> filepath
+        std::unordered_map<size_t, std::set<fs::path>> m_pending;          // category -> discovered, not loaded yet
+        std::map<std::string, ManifestAssembler> m_manifestassemblers;     // pluginid -> listed from the manifest, never freed
+        std::unordered_set<std::string> m_missing;                         // Assemblers that failed to load, reported once
+        EntryList m_assemblerlist;
+        std::set<fs::path> m_loaded;
 };
 
 template<typename T>
@@ -0,0 +1,138 @@
+#include "pluginmanifest.h"
+#include "../../config.h"
+#include <rdapi/level.h>
+#include <tao/pegtl.hpp>
+#include <tao/json.hpp>
+#include <algorithm>
+#include <fstream>
+#include <random>
+
+PluginManifest* PluginManifest::instance() { static PluginManifest manifest; return &manifest; }
+
+bool PluginManifest::lookup(const fs::path& filepath, Entries* entries)
+{
+    s64 mtime;
+    uintmax_t size;
+    if(!PluginManifest::stat(filepath, &mtime, &size)) return false;
+
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    if(!m_loaded) this->load();
+
+    auto it = m_modules.find(filepath.string());
+    if((it == m_modules.end()) || (it->second.mtime != mtime) || (it->second.size != size)) return false;
+
+    *entries = it->second.entries;
+    return true;
+}
+
+void PluginManifest::update(const fs::path& filepath, const Entries& entries)
+{
+    Module m{0, 0, entries};
+    if(!PluginManifest::stat(filepath, &m.mtime, &m.size)) return;
+
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    if(!m_loaded) this->load();
+
+    auto it = m_modules.find(filepath.string());
+
+    if((it != m_modules.end()) && (it->second.mtime == m.mtime) && (it->second.size == m.size) &&
+       std::equal(m.entries.begin(), m.entries.end(), it->second.entries.begin(), it->second.entries.end(),
+                  [](const Entry& e1, const Entry& e2) { return (e1.category == e2.category) && (e1.id == e2.id) && (e1.name == e2.name) && (e1.bits == e2.bits); }))
+        return; // Nothing changed
+
+    m_modules[filepath.string()] = std::move(m);
+    m_dirty = true;
+}
+
+void PluginManifest::save()
+{
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    if(!m_dirty) return;
+
+    tao::json::value modules = tao::json::empty_object;
+
+    for(const auto& [filepath, m] : m_modules)
+    {
+        tao::json::value entries = tao::json::empty_array;
+
+        for(const auto& e : m.entries)
+        {
+            tao::json::value entry = { { "category", e.category }, { "id", e.id }, { "name", e.name }, { "bits", e.bits } };
+            entries.push_back(std::move(entry));
+        }
+
+        modules[filepath] = {
+            { "mtime", m.mtime },
+            { "size", m.size },
+            { "entries", entries }
+        };
+    }
+
+    tao::json::value root = {
+        { "apilevel", RDAPI_LEVEL },
+        { "version", PLUGIN_MANIFEST_VERSION },
+        { "modules", modules }
+    };
+
+    // Write and rename, concurrent processes never see a partial manifest
+    fs::path manifestpath = this->manifestPath(), tmppath = manifestpath;
+    tmppath += "." + std::to_string(std::random_device{ }()) + ".tmp";
+
+    {
+        std::ofstream ofs(tmppath, std::ios::trunc);
+        if(!ofs.is_open()) return;
+        ofs << tao::json::to_string(root);
+        if(!ofs.good()) return;
+    }
+
+    std::error_code ec;
+    fs::rename(tmppath, manifestpath, ec);
+    if(ec) fs::remove(tmppath, ec);
+    else m_dirty = false;
+}
+
+bool PluginManifest::stat(const fs::path& filepath, s64* mtime, uintmax_t* size)
+{
+    std::error_code ec;
+    auto t = fs::last_write_time(filepath, ec);
+    if(ec) return false;
+
+    *size = fs::file_size(filepath, ec);
+    if(ec) return false;
+
+    *mtime = static_cast<s64>(t.time_since_epoch().count());
+    return true;
+}
+
+fs::path PluginManifest::manifestPath() const { return fs::path(rd_cfg->tempPath()) / PLUGIN_MANIFEST_FILE; }
+
+void PluginManifest::load()
+{
+    m_loaded = true;
+
+    std::error_code ec;
+    fs::path manifestpath = this->manifestPath();
+    if(!fs::is_regular_file(manifestpath, ec)) return;
+
+    try {
+        tao::json::value root = tao::json::from_file(manifestpath);
+        if(root.at("apilevel").as<u64>() != RDAPI_LEVEL) return; // Stale manifest, rebuild it
+
+        const auto* version = root.find("version");
+        if(!version || (version->as<u64>() != PLUGIN_MANIFEST_VERSION)) return; // Older format, without metadata
+
+        for(const auto& [filepath, m] : root.at("modules").get_object())
+        {
+            Module module{m.at("mtime").as<s64>(), m.at("size").as<u64>(), { }};
+
+            for(const auto& e : m.at("entries").get_array())
+                module.entries.push_back({e.at("category").as<u64>(), e.at("id").get_string(), e.at("name").get_string(), e.at("bits").as<u32>()});
+
+            m_modules[filepath] = std::move(module);
+        }
+    }
+    catch(std::exception& e) { // Corrupted manifest: plugins will be scanned again
+        m_modules.clear();
+        rd_cfg->log("Invalid plugin manifest: " + std::string(e.what()));
+    }
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <unordered_map>
+#include <rdapi/types.h>
+#include <filesystem>
+#include <vector>
+#include <string>
+#include <mutex>
+
+#define PLUGIN_MANIFEST_FILE    "redasm_plugins.json"
+#define PLUGIN_MANIFEST_VERSION 2
+
+namespace fs = std::filesystem;
+
+class PluginManifest
+{
+    public:
+        struct Entry { size_t category; std::string id, name; u32 bits; }; // Enough to list an entry without loading it, 'bits' is for assemblers only
+        typedef std::vector<Entry> Entries;
+
+    private:
+        struct Module {
+            s64 mtime;
+            uintmax_t size;
+            Entries entries;
+        };
+
+    public:
+        PluginManifest() = default;
+        static PluginManifest* instance();
+        bool lookup(const fs::path& filepath, Entries* entries);
+        void update(const fs::path& filepath, const Entries& entries);
+        void save();
+
+    private:
+        static bool stat(const fs::path& filepath, s64* mtime, uintmax_t* size);
+        fs::path manifestPath() const;
+        void load();
+
+    private:
+        std::unordered_map<std::string, Module> m_modules; // filepath -> Module
+        std::mutex m_mutex;
+        bool m_loaded{false}, m_dirty{false};
+};
+
+#define rd_manifest PluginManifest::instance()
@@ -10,6 +10,7 @@
 #define RDPLUGIN_PLUGIN_FREE_NAME "rdplugin_free"
 
 PluginModule::ModuleHandles PluginModule::m_sharedhandles;
+std::mutex PluginModule::m_handlesmutex;
 
 PluginModule::PluginModule(Context* ctx): Object(ctx) { }
 
@@ -35,7 +36,11 @@ PluginModule::PluginModule(Context* ctx, const fs::path &filepath): Object(ctx),
         return;
     }
 
-    m_sharedhandles[m_handle]++; // Increase shared reference count
+    {
+        std::scoped_lock<std::mutex> lock(m_handlesmutex);
+        m_sharedhandles[m_handle]++; // Increase shared reference count
+    }
+
     m_init = this->getFuncT<Callback_PluginInit>(RDPLUGIN_PLUGIN_INIT_NAME);
     m_free = this->getFuncT<Callback_PluginFree>(RDPLUGIN_PLUGIN_FREE_NAME);
 
@@ -115,6 +120,8 @@ void PluginModule::unload()
     if(!m_handle) return;
     if(m_free) m_free(CPTR(RDContext, this->context()));
 
+    std::scoped_lock<std::mutex> lock(m_handlesmutex);
+
     if(!(--m_sharedhandles[m_handle])) // Decrease shared reference count, keep library loaded if needed
     {
 #ifdef _WIN32
@@ -6,6 +6,7 @@
 #include <rdapi/plugin/command.h>
 #include <rdapi/plugin/entry.h>
 #include <cstring>
+#include <mutex>
 #include "../../support/utils.h"
 #include "../../config.h"
 #include "../../object.h"
@@ -49,6 +50,7 @@ class PluginModule: public Object
 
     private:
         static ModuleHandles m_sharedhandles;
+        static std::mutex m_handlesmutex; // Contexts can live in different threads
         std::vector<EntryItem> m_entries;
         hmodule m_handle{ };
         fs::path m_filepath;
@@ -64,6 +66,12 @@ bool PluginModule::registerEntry(size_t c, EntryType* e) {
         return false;
     }
 
+    if(e->apilevel != RDAPI_LEVEL) { // Entry structs may have a different layout
+        spdlog::warn("PluginModule::registerEntry({}, {:p}): '{}' requires API level {}, expected {}", c, reinterpret_cast<const void*>(e), e->id, e->apilevel, RDAPI_LEVEL);
+        this->log("Incompatible API level for " + Utils::quoted(e->id));
+        return false;
+    }
+
     auto cit = std::find_if(m_entries.begin(), m_entries.end(), [&](const auto& item) {
         return (item.first == c) && !std::strcmp(item.second->id, e->id);
     });
@@ -1,4 +1,5 @@
 #include "expression.h"
+#include <algorithm>
 
 ILExpression* ILExpression::clone(const ILExpression* e)
 {
@@ -68,6 +69,18 @@ ILExpression* ILExpressionTree::exprINT(ILExpression* e) const { return this->ex
 
 ILExpression* ILExpressionTree::check(ILExpression* e) const { return e ? e : this->exprUNKNOWN(); }
 
+ILExpression* ILExpressionTree::copy(const ILExpression* e) const
+{
+    if(!e) return nullptr;
+
+    auto* ne = this->expr(e->type, e->size);
+    ne->value = e->value;
+    ne->n1 = this->copy(e->n1);
+    ne->n2 = this->copy(e->n2);
+    ne->n3 = this->copy(e->n3);
+    return ne;
+}
+
 ILExpression* ILExpressionTree::exprIF(ILExpression* cond, ILExpression* t, ILExpression* f) const
 {
     auto* expr = this->expr(RDIL_If, 0);
@@ -116,11 +129,18 @@ ILExpression* ILExpressionTree::exprU(rd_type rdil, size_t size, ILExpression* e
 
 ILExpression* ILExpressionTree::expr(rd_type rdil, size_t size) const
 {
-    auto& expr = m_pool.emplace_front(new ILExpression());
+    if(m_pool.empty() || (m_poolused == m_poolchunk))
+    {
+        m_poolchunk = m_pool.empty() ? IL_POOL_CHUNK : std::min<size_t>(m_poolchunk * 2, IL_POOL_CHUNK_MAX);
+        m_pool.push_back(std::make_unique<ILExpression[]>(m_poolchunk));
+        m_poolused = 0;
+    }
+
+    auto* expr = &m_pool.back()[m_poolused++];
     expr->type = rdil;
     expr->size = size;
     expr->value = 0;
-    return expr.get();
+    return expr;
 }
 
 ILExpression* ILExpressionTree::expr(rd_type rdil) const { return this->expr(rdil, 0); }
@@ -3,9 +3,12 @@
 #include <rdapi/rdil.h>
 #include <unordered_set>
 #include <memory>
-#include <list>
+#include <vector>
 #include "../object.h"
 
+#define IL_POOL_CHUNK     8
+#define IL_POOL_CHUNK_MAX 256
+
 class ILExpression;
 typedef std::unique_ptr<ILExpression> ILExpressionPtr;
 
@@ -69,6 +72,7 @@ class ILExpressionTree: public Object
         ILExpression* exprGT(ILExpression* l, ILExpression* r) const;
         ILExpression* exprGE(ILExpression* l, ILExpression* r) const;
         ILExpression* exprINT(ILExpression* e) const;
+        ILExpression* copy(const ILExpression* e) const;
 
     protected:
         ILExpression* check(ILExpression* e) const;
@@ -83,5 +87,6 @@ class ILExpressionTree: public Object
         ILExpression* expr(rd_type rdil) const;
 
     private:
-        mutable std::list<ILExpressionPtr> m_pool;
+        mutable std::vector<std::unique_ptr<ILExpression[]>> m_pool; // Chunks grow geometrically
+        mutable size_t m_poolchunk{0}, m_poolused{0};
 };
@@ -0,0 +1,109 @@
+#include "ilcache.h"
+#include "ilfunction.h"
+#include "../document/model/blockcontainer.h"
+#include "../document/document.h"
+#include "../plugin/assembler.h"
+#include "../support/utils.h"
+#include "../support/hash.h"
+#include "../context.h"
+
+ILCache::ILCache(Context* ctx): Object(ctx) { }
+
+ILCache::ILFunctionPtr ILCache::function(rd_address address)
+{
+    const auto& doc = this->context()->document(); // Read only, callers may hold the shared lock
+
+    RDLocation loc = doc->getFunctionStart(address);
+    if(!loc.valid) return nullptr;
+
+    size_t rev = doc->revision(AnalyzerResources_Code);
+
+    {
+        std::scoped_lock<std::mutex> lock(m_mutex);
+        Entry* e = m_entries.find(loc.address);
+        if(e && (e->revision == rev)) return e->il;
+    }
+
+    // Code changed somewhere: rehash this function, lifting is needed only if its bytes or layout changed
+    size_t key = 0;
+    if(!this->functionKey(loc.address, &key)) return nullptr;
+
+    {
+        std::scoped_lock<std::mutex> lock(m_mutex);
+        Entry* e = m_entries.find(loc.address);
+
+        if(e && (e->key == key))
+        {
+            e->revision = rev;
+            return e->il;
+        }
+    }
+
+    // Lifting takes the document lock: never hold m_mutex meanwhile, callers may own the document already
+    auto il = std::make_shared<ILFunction>(this->context());
+    if(!ILFunction::generate(loc.address, il.get())) return nullptr;
+
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    Entry* e = m_entries.find(loc.address);
+    if(e && (e->key == key)) return e->il; // Another thread has lifted it meanwhile
+
+    m_entries.insert(loc.address, { rev, key, il });
+    return il;
+}
+
+ILCache::ILFunctionPtr ILCache::peek(rd_address address)
+{
+    const auto& doc = this->context()->document();
+
+    RDLocation loc = doc->getFunctionStart(address);
+    if(!loc.valid) return nullptr;
+
+    size_t rev = doc->revision(AnalyzerResources_Code);
+
+    {
+        std::scoped_lock<std::mutex> lock(m_mutex);
+        Entry* e = m_entries.find(loc.address);
+        if(!e) return nullptr;
+        if(e->revision == rev) return e->il;
+    }
+
+    // The code revision moves on every analysis round: the entry is still good if this function is unchanged
+    size_t key = 0;
+    if(!this->functionKey(loc.address, &key)) return nullptr;
+
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    Entry* e = m_entries.find(loc.address);
+    if(!e || (e->key != key)) return nullptr;
+
+    e->revision = rev;
+    return e->il;
+}
+
+bool ILCache::functionKey(rd_address address, size_t* key) const
+{
+    const auto* assembler = this->context()->getAssembler(address);
+    if(!assembler) return false;
+
+    const auto& doc = this->context()->document();
+
+    FunctionBounds fb;
+    if(!doc->getFunctionBounds(address, &fb).valid) return false;
+
+    size_t k = std::hash<std::string>()(assembler->id());
+
+    for(const auto& [startaddress, endaddress] : fb.blocks)
+    {
+        RDBlock endb;
+        if(!doc->addressToBlock(endaddress, &endb)) return false;
+
+        RDBufferView view;
+        if(!doc->getView(startaddress, (endb.address + BlockContainer::size(&endb)) - startaddress, &view)) return false;
+
+        Utils::hashCombine(k, startaddress);
+        Utils::hashCombine(k, endaddress);
+        Utils::hashCombine(k, Hash::crc32c(view.data, view.size));
+    }
+
+    *key = k;
+    return true;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <rdapi/types.h>
+#include "../containers/lrucontainer.h"
+#include "../object.h"
+
+#define IL_CACHE_SIZE 0x400
+
+class ILFunction;
+
+class ILCache: public Object // Lifted RDIL of whole functions, shared by analyzers, renderers and the API
+{
+    public:
+        typedef std::shared_ptr<const ILFunction> ILFunctionPtr;
+
+    private:
+        struct Entry {
+            size_t revision;
+            size_t key;      // Code bytes and block layout
+            ILFunctionPtr il;
+        };
+
+    public:
+        ILCache(Context* ctx);
+        ILFunctionPtr function(rd_address address);
+        ILFunctionPtr peek(rd_address address); // Cached entries whose function is unchanged, never lifts nor inserts
+
+    private:
+        bool functionKey(rd_address address, size_t* key) const;
+
+    private:
+        LRUContainer<rd_address, Entry> m_entries{IL_CACHE_SIZE};
+        std::mutex m_mutex;
+};
@@ -20,6 +20,7 @@ void ILFunction::insert(size_t idx, ILExpression* e)
     e = this->check(e);
     m_addresses[e] = m_currentaddress;
     m_expressions.emplace(m_expressions.begin() + idx, e);
+    this->shiftRanges(idx, m_currentaddress);
 }
 
 const ILExpression* ILFunction::expression(size_t idx) const
@@ -28,6 +29,33 @@ const ILExpression* ILFunction::expression(size_t idx) const
     return m_expressions.at(idx);
 }
 
+const ILExpression* ILFunction::expressionAt(rd_address address) const
+{
+    size_t idx = 0;
+    return this->range(address, &idx, nullptr) ? m_expressions[idx] : nullptr;
+}
+
+bool ILFunction::range(rd_address address, size_t* index, size_t* count) const
+{
+    auto it = m_ranges.find(address);
+    if(it == m_ranges.end()) return false;
+
+    if(index) *index = it->second.first;
+    if(count) *count = it->second.second;
+    return true;
+}
+
+void ILFunction::copyFrom(const ILFunction* il)
+{
+    for(const ILExpression* e : *il)
+    {
+        rd_address address = RD_NVAL;
+        il->getAddress(e, &address);
+        this->setCurrentAddress(address);
+        this->append(this->copy(e));
+    }
+}
+
 bool ILFunction::empty() const { return m_expressions.empty(); }
 size_t ILFunction::size() const { return m_expressions.size(); }
 
@@ -46,7 +74,7 @@ bool ILFunction::generate(rd_address address, ILFunction* il)
         return false;
     }
 
-    auto& document = il->context()->document();
+    const auto& document = il->context()->document();
 
     for(rd_address currentaddress : path)
     {
@@ -61,7 +89,8 @@ bool ILFunction::generate(rd_address address, ILFunction* il)
 ILExpression* ILFunction::generateOne(Context* ctx, rd_address address)
 {
     RDBufferView view;
-    if(!ctx->document()->getBlockView(address, &view)) return nullptr;
+    const SafeDocument& doc = ctx->document();
+    if(!doc->getBlockView(address, &view)) return nullptr;
 
     ILFunction il(ctx);
     ctx->assembler()->lift(address, &view, &il);
@@ -73,6 +102,11 @@ void ILFunction::append(ILExpression* e)
     e = this->check(e);
     m_addresses[e] = m_currentaddress;
     m_expressions.push_back(e);
+
+    auto it = m_ranges.find(m_currentaddress); // Lifters emit contiguous runs per address
+
+    if(it == m_ranges.end()) m_ranges[m_currentaddress] = { m_expressions.size() - 1, 1 };
+    else if(it->second.first + it->second.second == m_expressions.size() - 1) it->second.second++;
 }
 
 void ILFunction::setCurrentAddress(rd_address address) { m_currentaddress = address; }
@@ -93,7 +127,8 @@ const ILExpression* ILFunction::last() const { return !m_expressions.empty() ? m
 
 void ILFunction::generateBasicBlock(rd_address address, ILFunction* il, std::set<rd_address>& path)
 {
-    const auto* net = il->context()->net();
+    s_lock_document lock(il->context()->document()); // Held for the whole walk
+    const auto* net = lock->net();
     auto* node = net->findNode(address);
 
     while(node)
@@ -104,6 +139,40 @@ void ILFunction::generateBasicBlock(rd_address address, ILFunction* il, std::set
     }
 }
 
+void ILFunction::shiftRanges(size_t idx, rd_address address)
+{
+    bool merged = false;
+
+    for(auto& [a, r] : m_ranges) // Only the first run of each address is indexed
+    {
+        auto& [start, count] = r;
+        if(start >= idx) { start++; continue; }
+        if((start + count) <= idx) continue;
+
+        if(a == address) { count++; merged = true; } // Inserted inside its own run
+        else count = idx - start;                    // Run split, its tail is not the first run anymore
+    }
+
+    if(merged) return;
+
+    auto it = m_ranges.find(address);
+
+    if(it == m_ranges.end())
+    {
+        m_ranges[address] = { idx, 1 };
+        return;
+    }
+
+    auto& [start, count] = it->second;
+
+    if(idx < start) // New first run, it joins the old one if adjacent
+    {
+        count = (start == (idx + 1)) ? (count + 1) : 1;
+        start = idx;
+    }
+    else if(idx == (start + count)) count++;
+}
+
 ILFunction::ExpressionList::iterator ILFunction::begin() { return m_expressions.begin(); }
 ILFunction::ExpressionList::iterator ILFunction::end() { return m_expressions.end(); }
 ILFunction::ExpressionList::const_iterator ILFunction::begin() const { return m_expressions.begin(); }
@@ -111,25 +180,17 @@ ILFunction::ExpressionList::const_iterator ILFunction::end() const { return m_ex
 
 bool ILFunction::generatePath(rd_address address, ILFunction* il, std::set<rd_address>& path)
 {
-    auto* g = il->context()->document()->getGraph(address);
+    FunctionBounds fb;
+    const SafeDocument& doc = il->context()->document();
 
-    if(!g)
+    if(!doc->getFunctionBounds(address, &fb).valid)
     {
         ILFunction::generateBasicBlock(address, il, path); // It's not a function: try to generate a basic block
         return !path.empty();
     }
 
-    const RDGraphNode* nodes = nullptr;
-    size_t c = g->nodes(&nodes);
-
-    for(size_t i = 0; i < c; i++)
-    {
-        const auto* data = g->data(nodes[i]);
-        if(!data || !data->p_data) return false;
-
-        const auto* fbb = reinterpret_cast<FunctionBasicBlock*>(data->p_data);
-        ILFunction::generateBasicBlock(fbb->startaddress, il, path);
-    }
+    for(const auto& [startaddress, endaddress] : fb.blocks)
+        ILFunction::generateBasicBlock(startaddress, il, path);
 
     return true;
 }
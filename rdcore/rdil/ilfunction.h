@@ -2,8 +2,7 @@
 
 #include <rdapi/types.h>
 #include <unordered_map>
-#include <deque>
-#include <list>
+#include <vector>
 #include <set>
 #include "expression.h"
 #include "../object.h"
@@ -13,7 +12,7 @@ class Disassembler;
 class ILFunction: public ILExpressionTree
 {
     public:
-        typedef std::deque<ILExpression*> ExpressionList;
+        typedef std::vector<ILExpression*> ExpressionList;
 
     public:
         ILFunction(Context* ctx);
@@ -24,6 +23,9 @@ class ILFunction: public ILExpressionTree
         const ILExpression* first() const;
         const ILExpression* last() const;
         const ILExpression* expression(size_t idx) const;
+        const ILExpression* expressionAt(rd_address address) const;
+        bool range(rd_address address, size_t* index, size_t* count) const;
+        void copyFrom(const ILFunction* il);
         bool empty() const;
         size_t size() const;
 
@@ -34,6 +36,7 @@ class ILFunction: public ILExpressionTree
     private:
         static bool generatePath(rd_address address, ILFunction* il, std::set<rd_address>& path);
         static void generateBasicBlock(rd_address address, ILFunction* il, std::set<rd_address>& path);
+        void shiftRanges(size_t idx, rd_address address);
 
     public:
         ExpressionList::iterator begin();
@@ -43,6 +46,7 @@ class ILFunction: public ILExpressionTree
 
     private:
         std::unordered_map<const ILExpression*, rd_address> m_addresses;
+        std::unordered_map<rd_address, std::pair<size_t, size_t>> m_ranges; // Address -> [Index, Count]
         rd_address m_currentaddress{RD_NVAL};
         ExpressionList m_expressions;
 };
@@ -106,7 +106,7 @@ size_t RDIL::extract(const ILExpression* e, const RDILValue** values)
 {
     if(!e) return false;
 
-    static std::vector<RDILValue> v;
+    static thread_local std::vector<RDILValue> v;
     v = { };
 
     RDIL::extract(e, v);
@@ -118,7 +118,7 @@ size_t RDIL::extract(const ILFunction* f, const RDILValue** values)
 {
     if(!f) return false;
 
-    static std::vector<RDILValue> v;
+    static thread_local std::vector<RDILValue> v;
     v = { };
 
     for(const ILExpression* e : *f)
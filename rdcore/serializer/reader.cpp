@@ -1,4 +1,5 @@
 #include "reader.h"
+#include "../support/compression.h"
 #include <rdcore/support/endian.h>
 #include <rdcore/support/hash.h>
 #include <fstream>
@@ -29,6 +30,14 @@ bool SerializerReader::read(const std::string& filepath)
 
         fs.seekg(chdr.offset,std::fstream::beg);
         fs.read(reinterpret_cast<char*>(chdata.data()), chdr.length);
+        if(!fs) return this->setLastError("Truncated chunk " + type);
+
+        if(chdr.length > sizeof(u64)) // See SerializerWriter::needsCompression()
+        {
+            RawData decompressed;
+            if(!Compression::decompress(chdata, decompressed)) return this->setLastError("Cannot decompress chunk " + type);
+            chdata.swap(decompressed);
+        }
 
         if(Hash::crc32(chdata.data(), chdata.size()) != chdr.checksum)
             return this->setLastError("Invalid Checksum for chunk " + type);
@@ -17,7 +17,9 @@ bool SerializerWriter::push(const std::string& id, const RawData& chdata)
     {
         RawData compresseddata;
         compresseddata.reserve(chdata.size()); // Preallocate some space
-        Compression::compress(chdata, compresseddata);
+
+        if(chdata.size() > COMPRESSION_FRAME_SIZE) Compression::compressFrames(chdata, compresseddata);
+        else Compression::compress(chdata, compresseddata);
 
         chdr.length = Endian::tolittleendian32(compresseddata.size()),
         m_chunks.push_back({ chdr, compresseddata });
@@ -1,5 +1,14 @@
 #include "compression.h"
+#include "endian.h"
+#include <condition_variable>
+#include <algorithm>
+#include <cstring>
+#include <limits>
 #include <fstream>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <deque>
 
 #define CHUNK_SIZE 16384
 
@@ -7,8 +16,25 @@ bool Compression::decompress(const RawData& datain, RawData& dataout)
 {
     if(datain.empty()) return false;
 
+    if(Compression::isFramed(datain.data(), datain.size()))
+    {
+        FramesHeader header;
+        std::copy_n(datain.data(), sizeof(FramesHeader), reinterpret_cast<u8*>(&header));
+        if(!Compression::readHeader(header, datain.size())) return false;
+
+        size_t indexsize = sizeof(FramesHeader) + (header.count * sizeof(FrameEntry));
+        std::vector<FrameEntry> index;
+        if(!Compression::readIndex(header, datain.data() + sizeof(FramesHeader), datain.size() - indexsize, index)) return false;
+        dataout.resize(header.size);
+
+        return Compression::pipeline(index.size(), nullptr, [&](size_t i, RawData&) {
+            const FrameEntry& e = index[i];
+            return Compression::decompress(datain.data() + indexsize + e.offset, e.compressedsize, dataout.data() + (i * header.framesize), e.size);
+        });
+    }
+
     mz_stream zs;
-    Compression::prepare(&zs, datain, dataout);
+    Compression::prepare(&zs, datain.data(), datain.size(), dataout);
     if(mz_inflateInit(&zs) != MZ_OK) return false;
 
     bool res = Compression::process(&zs, dataout, ::mz_inflate, 0);
@@ -18,16 +44,66 @@ bool Compression::decompress(const RawData& datain, RawData& dataout)
 
 bool Compression::compressFile(const std::string& filepath, RawData& dataout)
 {
-    RawData data;
-    if(!Compression::readFile(filepath, data)) return false;
-    return Compression::compress(data, dataout);
+    std::ifstream stream(filepath, std::ios::in | std::ios::binary | std::ios::ate);
+    if(!stream.is_open()) return false;
+
+    size_t size = static_cast<size_t>(stream.tellg());
+    if(!size) return false;
+    stream.seekg(0, std::ios::beg);
+
+    // Frames are compressed while the next ones are read
+    std::vector<RawData> frames((size + COMPRESSION_FRAME_SIZE - 1) / COMPRESSION_FRAME_SIZE);
+
+    bool res = Compression::pipeline(frames.size(), [&](size_t i, RawData& data) {
+        data.resize(std::min<size_t>(COMPRESSION_FRAME_SIZE, size - (i * COMPRESSION_FRAME_SIZE)));
+        return static_cast<bool>(stream.read(reinterpret_cast<char*>(data.data()), data.size()));
+    },
+    [&](size_t i, RawData& data) { return Compression::compress(data.data(), data.size(), frames[i]); });
+
+    if(!res) return false;
+    Compression::writeFrames(frames, COMPRESSION_FRAME_SIZE, size, dataout);
+    return true;
 }
 
 bool Compression::decompressFile(const std::string& filepath, RawData& dataout)
 {
-    RawData data;
-    if(!Compression::readFile(filepath, data)) return false;
-    return Compression::decompress(data, dataout);
+    std::ifstream stream(filepath, std::ios::in | std::ios::binary | std::ios::ate);
+    if(!stream.is_open()) return false;
+
+    size_t filesize = static_cast<size_t>(stream.tellg());
+    stream.seekg(0, std::ios::beg);
+
+    FramesHeader header;
+
+    if(!stream.read(reinterpret_cast<char*>(&header), sizeof(FramesHeader)) || !Compression::isFramed(reinterpret_cast<const u8*>(&header), sizeof(FramesHeader)))
+    {
+        RawData data; // Plain zlib stream, needs the whole file
+        if(!Compression::readFile(filepath, data)) return false;
+        return Compression::decompress(data, dataout);
+    }
+
+    if(!Compression::readHeader(header, filesize)) return false;
+
+    RawData indexdata(header.count * sizeof(FrameEntry));
+    if(!stream.read(reinterpret_cast<char*>(indexdata.data()), indexdata.size())) return false;
+
+    std::vector<FrameEntry> index;
+    if(!Compression::readIndex(header, indexdata.data(), filesize - sizeof(FramesHeader) - indexdata.size(), index)) return false;
+    dataout.resize(header.size);
+
+    // Frames are decoded as soon as they are read
+    return Compression::pipeline(index.size(), [&](size_t i, RawData& data) {
+        data.resize(index[i].compressedsize);
+        return static_cast<bool>(stream.read(reinterpret_cast<char*>(data.data()), data.size()));
+    },
+    [&](size_t i, RawData& data) {
+        return Compression::decompress(data.data(), data.size(), dataout.data() + (i * header.framesize), index[i].size);
+    });
+}
+
+bool Compression::isFramed(const u8* data, size_t size)
+{
+    return data && (size >= sizeof(FramesHeader)) && !std::memcmp(data, COMPRESSION_FRAMES_MAGIC, sizeof(FramesHeader::magic));
 }
 
 bool Compression::readFile(const std::string& filepath, RawData& data)
@@ -43,12 +119,167 @@ bool Compression::readFile(const std::string& filepath, RawData& data)
     return true;
 }
 
+bool Compression::readHeader(FramesHeader& header, size_t datasize)
+{
+    header.framesize = Endian::fromlittleendian32(header.framesize);
+    header.size = Endian::fromlittleendian64(header.size);
+    header.count = Endian::fromlittleendian64(header.count);
+
+    if(!header.framesize || !header.size) return false;
+    if(header.count != (((header.size - 1) / header.framesize) + 1)) return false;
+
+    // Don't trust sizes before allocating: the index must fit and the frames can't inflate past the deflate limit
+    if(header.count > ((datasize - sizeof(FramesHeader)) / sizeof(FrameEntry))) return false;
+    u64 payloadsize = datasize - sizeof(FramesHeader) - (header.count * sizeof(FrameEntry));
+    return header.size <= (payloadsize * COMPRESSION_MAX_RATIO);
+}
+
+bool Compression::readIndex(const FramesHeader& header, const u8* data, size_t payloadsize, std::vector<FrameEntry>& index)
+{
+    index.resize(header.count);
+    std::copy_n(data, index.size() * sizeof(FrameEntry), reinterpret_cast<u8*>(index.data()));
+    u64 offset = 0, total = 0;
+
+    for(FrameEntry& e : index) // Frames are contiguous and all but the last one are full
+    {
+        e.offset = Endian::fromlittleendian64(e.offset);
+        e.compressedsize = Endian::fromlittleendian32(e.compressedsize);
+        e.size = Endian::fromlittleendian32(e.size);
+
+        if((e.offset != offset) || (e.size > header.framesize)) return false;
+        if((&e != &index.back()) && (e.size != header.framesize)) return false;
+        if(e.size > (static_cast<u64>(e.compressedsize) * COMPRESSION_MAX_RATIO)) return false;
+
+        offset += e.compressedsize;
+        total += e.size;
+    }
+
+    return (offset <= payloadsize) && (total == header.size);
+}
+
+void Compression::writeFrames(const std::vector<RawData>& frames, size_t framesize, size_t size, RawData& dataout)
+{
+    FramesHeader header;
+    std::copy_n(COMPRESSION_FRAMES_MAGIC, sizeof(header.magic), header.magic);
+    header.framesize = Endian::tolittleendian32(static_cast<u32>(framesize));
+    header.size = Endian::tolittleendian64(size);
+    header.count = Endian::tolittleendian64(frames.size());
+
+    size_t datasize = 0;
+    for(const RawData& f : frames) datasize += f.size();
+
+    dataout.resize(sizeof(FramesHeader) + (frames.size() * sizeof(FrameEntry)) + datasize);
+    std::copy_n(reinterpret_cast<const u8*>(&header), sizeof(FramesHeader), dataout.data());
+
+    auto* entries = reinterpret_cast<FrameEntry*>(dataout.data() + sizeof(FramesHeader));
+    u8* p = dataout.data() + sizeof(FramesHeader) + (frames.size() * sizeof(FrameEntry));
+    u64 offset = 0;
+
+    for(size_t i = 0; i < frames.size(); i++)
+    {
+        FrameEntry e;
+        e.offset = Endian::tolittleendian64(offset);
+        e.compressedsize = Endian::tolittleendian32(static_cast<u32>(frames[i].size()));
+        e.size = Endian::tolittleendian32(static_cast<u32>(std::min(framesize, size - (i * framesize))));
+        std::copy_n(reinterpret_cast<const u8*>(&e), sizeof(FrameEntry), reinterpret_cast<u8*>(entries + i));
+
+        p = std::copy(frames[i].begin(), frames[i].end(), p);
+        offset += frames[i].size();
+    }
+}
+
+bool Compression::pipeline(size_t count, const FrameCallback& produce, const FrameCallback& consume)
+{
+    size_t nworkers = std::max<size_t>(1, std::min<size_t>(count, std::thread::hardware_concurrency()));
+    std::deque<std::pair<size_t, RawData>> queue;
+    std::condition_variable cv;
+    std::mutex mutex;
+    std::atomic_bool failed{false};
+    bool done = false;
+
+    auto fail = [&]() {
+        {
+            std::scoped_lock<std::mutex> lock(mutex);
+            failed = true;
+        }
+
+        cv.notify_all();
+    };
+
+    std::vector<std::thread> workers;
+
+    for(size_t w = 0; w < nworkers; w++)
+    {
+        workers.emplace_back([&]() {
+            while(!failed)
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                cv.wait(lock, [&]() { return !queue.empty() || done; });
+                if(queue.empty()) break;
+
+                auto job = std::move(queue.front());
+                queue.pop_front();
+                lock.unlock();
+                cv.notify_all(); // Wake the producer, if it's waiting for room
+
+                if(!consume(job.first, job.second)) fail();
+            }
+        });
+    }
+
+    for(size_t i = 0; (i < count) && !failed; i++)
+    {
+        RawData data;
+
+        if(produce && !produce(i, data))
+        {
+            fail();
+            break;
+        }
+
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [&]() { return (queue.size() < (nworkers * 2)) || failed; }); // Bound the frames in memory
+        queue.emplace_back(i, std::move(data));
+        lock.unlock();
+        cv.notify_all();
+    }
+
+    {
+        std::scoped_lock<std::mutex> lock(mutex);
+        done = true;
+    }
+
+    cv.notify_all();
+    for(auto& w : workers) w.join();
+    return !failed;
+}
+
 bool Compression::compress(const RawData& datain, RawData& dataout)
 {
     if(datain.empty()) return false;
+    return Compression::compress(datain.data(), datain.size(), dataout);
+}
 
+bool Compression::compressFrames(const RawData& datain, RawData& dataout, size_t framesize)
+{
+    if(datain.empty() || !framesize || (framesize > std::numeric_limits<u32>::max())) return false;
+
+    std::vector<RawData> frames((datain.size() + framesize - 1) / framesize);
+
+    bool res = Compression::pipeline(frames.size(), nullptr, [&](size_t i, RawData&) {
+        size_t offset = i * framesize;
+        return Compression::compress(datain.data() + offset, std::min(framesize, datain.size() - offset), frames[i]);
+    });
+
+    if(!res) return false;
+    Compression::writeFrames(frames, framesize, datain.size(), dataout);
+    return true;
+}
+
+bool Compression::compress(const u8* datain, size_t size, RawData& dataout)
+{
     mz_stream zs;
-    Compression::prepare(&zs, datain, dataout);
+    Compression::prepare(&zs, datain, size, dataout);
     if(mz_deflateInit(&zs, MZ_BEST_COMPRESSION) != MZ_OK) return false;
 
     bool res = Compression::process(&zs, dataout, ::mz_deflate, MZ_FINISH);
@@ -56,6 +287,12 @@ bool Compression::compress(const RawData& datain, RawData& dataout)
     return res;
 }
 
+bool Compression::decompress(const u8* datain, size_t size, u8* dataout, size_t outsize)
+{
+    mz_ulong len = static_cast<mz_ulong>(outsize);
+    return (mz_uncompress(dataout, &len, datain, static_cast<mz_ulong>(size)) == MZ_OK) && (len == outsize);
+}
+
 bool Compression::process(mz_stream* zs, RawData& dataout, const Compression::ZLibFunction& func, int funcarg)
 {
     int res = 0;
@@ -76,14 +313,14 @@ bool Compression::process(mz_stream* zs, RawData& dataout, const Compression::ZL
     return res == MZ_STREAM_END;
 }
 
-void Compression::prepare(mz_stream* zs, const RawData& datain, RawData& dataout)
+void Compression::prepare(mz_stream* zs, const u8* datain, size_t size, RawData& dataout)
 {
     dataout.resize(CHUNK_SIZE);
 
     zs->zalloc = nullptr;
     zs->zfree = nullptr;
     zs->opaque = nullptr;
-    zs->next_in = const_cast<unsigned char*>(datain.data());
-    zs->avail_in = static_cast<unsigned int>(datain.size());
+    zs->next_in = const_cast<unsigned char*>(datain);
+    zs->avail_in = static_cast<unsigned int>(size);
     zs->total_out = 0;
 }
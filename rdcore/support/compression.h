@@ -2,26 +2,53 @@
 
 #include <string>
 #include <vector>
+#include <functional>
 #include <rdapi/types.h>
 #include "../libs/miniz/miniz.h"
 #include "../object.h"
 
+#define COMPRESSION_FRAMES_MAGIC "RDZF"
+#define COMPRESSION_FRAME_SIZE   (1 << 20)
+#define COMPRESSION_MAX_RATIO    1032 // Deflate can't expand a byte of input past this
+
 class Compression
 {
     private:
         typedef int (*ZLibFunction)(mz_stream*, int);
+        typedef std::function<bool(size_t, RawData&)> FrameCallback;
+
+        #pragma pack(push, 1)
+        struct FramesHeader {
+            char magic[4];
+            u32 framesize;
+            u64 size, count; // Decompressed size, number of frames
+        };
+
+        struct FrameEntry {
+            u64 offset; // From the end of the index
+            u32 compressedsize, size;
+        };
+        #pragma pack(pop)
 
     public:
         Compression() = delete;
         static bool compress(const RawData& datain, RawData& dataout);
+        static bool compressFrames(const RawData& datain, RawData& dataout, size_t framesize = COMPRESSION_FRAME_SIZE);
         static bool decompress(const RawData& datain, RawData& dataout);
         static bool compressFile(const std::string& filepath, RawData& dataout);
         static bool decompressFile(const std::string& filepath, RawData& dataout);
+        static bool isFramed(const u8* data, size_t size);
 
     private:
         static bool readFile(const std::string& filepath, RawData& data);
+        static bool readHeader(FramesHeader& header, size_t datasize);
+        static bool readIndex(const FramesHeader& header, const u8* data, size_t payloadsize, std::vector<FrameEntry>& index);
+        static void writeFrames(const std::vector<RawData>& frames, size_t framesize, size_t size, RawData& dataout);
+        static bool pipeline(size_t count, const FrameCallback& produce, const FrameCallback& consume);
 
     private:
+        static bool compress(const u8* datain, size_t size, RawData& dataout);
+        static bool decompress(const u8* datain, size_t size, u8* dataout, size_t outsize);
         static bool process(mz_stream* zs, RawData& dataout, const ZLibFunction& func, int funcarg);
-        static void prepare(mz_stream* zs, const RawData& datain, RawData& dataout);
+        static void prepare(mz_stream* zs, const u8* datain, size_t size, RawData& dataout);
 };
@@ -10,7 +10,7 @@
 
 const char* Demangler::demangled(const std::string& s, bool simplified)
 {
-    static std::string result;
+    static thread_local std::string result;
     result = s;
 
     if(Demangler::isMSVC(s, &result)) result = Demangler::demangleMSVC(result, simplified);
@@ -1,25 +1,164 @@
 #include "hash.h"
+#include "endian.h"
 #include "../libs/miniz/miniz.h"
+#include <array>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+    #define HASH_X64 1
+    #include <nmmintrin.h>
+
+    #if _MSC_VER
+        #include <intrin.h>
+        #define HASH_TARGET_SSE42
+    #else
+        #define HASH_TARGET_SSE42 __attribute__((target("sse4.2")))
+    #endif
+#endif
+
+typedef std::array<std::array<u32, 256>, 8> SlicingTable;
+
+// Reflected CRC32 tables for slicing-by-8: T[k][b] is the CRC of byte 'b' followed by 'k' zero bytes
+static constexpr SlicingTable makeSlicingTable(u32 poly)
+{
+    SlicingTable t{ };
+
+    for(u32 i = 0; i < 256; i++)
+    {
+        u32 crc = i;
+        for(int j = 0; j < 8; j++) crc = (crc & 1) ? (crc >> 1) ^ poly : (crc >> 1);
+        t[0][i] = crc;
+    }
+
+    for(u32 i = 0; i < 256; i++)
+    {
+        for(size_t k = 1; k < t.size(); k++)
+            t[k][i] = (t[k - 1][i] >> 8) ^ t[0][t[k - 1][i] & 0xFF];
+    }
+
+    return t;
+}
+
+static constexpr std::array<u16, 256> makeCrc16Table()
+{
+    std::array<u16, 256> t{ };
+
+    for(u32 i = 0; i < 256; i++)
+    {
+        u16 crc = static_cast<u16>(i << 8);
+        for(int j = 0; j < 8; j++) crc = (crc & 0x8000) ? static_cast<u16>((crc << 1) ^ 0x1021) : static_cast<u16>(crc << 1);
+        t[i] = crc;
+    }
+
+    return t;
+}
+
+static constexpr SlicingTable CRC32_TABLE = makeSlicingTable(0xEDB88320);  // IEEE, same as zlib/miniz
+static constexpr SlicingTable CRC32C_TABLE = makeSlicingTable(0x82F63B78); // Castagnoli
+static constexpr std::array<u16, 256> CRC16_TABLE = makeCrc16Table();      // CCITT
+
+static constexpr std::array<u32, 64> SHA256_K = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+static constexpr u32 ror32(u32 v, u32 amt) { return (v >> amt) | (v << (32 - amt)); }
+
+static void sha256Block(std::array<u32, 8>& state, const u8* block)
+{
+    std::array<u32, 64> w;
+
+    for(size_t i = 0; i < 16; i++)
+        w[i] = (static_cast<u32>(block[i * 4]) << 24) | (static_cast<u32>(block[i * 4 + 1]) << 16) | (static_cast<u32>(block[i * 4 + 2]) << 8) | block[i * 4 + 3];
+
+    for(size_t i = 16; i < w.size(); i++)
+    {
+        u32 s0 = ror32(w[i - 15], 7) ^ ror32(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        u32 s1 = ror32(w[i - 2], 17) ^ ror32(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    auto [a, b, c, d, e, f, g, h] = state;
+
+    for(size_t i = 0; i < w.size(); i++)
+    {
+        u32 t1 = h + (ror32(e, 6) ^ ror32(e, 11) ^ ror32(e, 25)) + ((e & f) ^ (~e & g)) + SHA256_K[i] + w[i];
+        u32 t2 = (ror32(a, 2) ^ ror32(a, 13) ^ ror32(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+        h = g; g = f; f = e; e = d + t1;
+        d = c; c = b; b = a; a = t1 + t2;
+    }
+
+    state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+    state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+}
+
+static u32 crc32Slicing(const SlicingTable& t, u32 crc, const u8* data, size_t size)
+{
+    for( ; size >= 8; data += 8, size -= 8)
+    {
+        u32 lo, hi;
+        std::memcpy(&lo, data, sizeof(u32));
+        std::memcpy(&hi, data + sizeof(u32), sizeof(u32));
+
+        lo = Endian::fromlittleendian32(lo) ^ crc;
+        hi = Endian::fromlittleendian32(hi);
+
+        crc = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^ t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24] ^
+              t[3][hi & 0xFF] ^ t[2][(hi >> 8) & 0xFF] ^ t[1][(hi >> 16) & 0xFF] ^ t[0][hi >> 24];
+    }
+
+    while(size--) crc = (crc >> 8) ^ t[0][(crc ^ *data++) & 0xFF];
+    return crc;
+}
 
 u32 Hash::adler32(const u8* data, size_t size) { return mz_adler32(MZ_ADLER32_INIT, data, size); }
 
 u16 Hash::crc16(const u8* data, size_t size)
 {
-    u8 x;
     u16 crc = 0xFFFF;
+    while(size--) crc = static_cast<u16>(crc << 8) ^ CRC16_TABLE[(crc >> 8) ^ *data++];
+    return crc;
+}
 
-    while(size--)
+u32 Hash::crc32(const u8* data, size_t size) { return ~crc32Slicing(CRC32_TABLE, ~0u, data, size); }
+
+u32 Hash::crc32c(const u8* data, size_t size)
+{
+    static const bool HW_CRC32 = Hash::hasCrc32Instructions();
+    return ~(HW_CRC32 ? Hash::crc32c_hw(~0u, data, size) : Hash::crc32c_sw(~0u, data, size));
+}
+
+Hash::SHA256Digest Hash::sha256(const u8* data, size_t size)
+{
+    std::array<u32, 8> state = { 0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19 };
+    u64 bits = static_cast<u64>(size) * 8;
+
+    for( ; size >= 64; data += 64, size -= 64) sha256Block(state, data);
+
+    std::array<u8, 128> tail{ }; // Remaining bytes, 0x80 and the big endian bit length: one or two blocks
+    if(size) std::memcpy(tail.data(), data, size);
+    tail[size] = 0x80;
+
+    size_t tailsize = (size < 56) ? 64 : 128;
+    for(size_t i = 0; i < 8; i++) tail[tailsize - 1 - i] = static_cast<u8>(bits >> (i * 8));
+    for(size_t i = 0; i < tailsize; i += 64) sha256Block(state, tail.data() + i);
+
+    SHA256Digest digest;
+
+    for(size_t i = 0; i < state.size(); i++)
     {
-        x = crc >> 8 ^ *data++;
-        x ^= x >> 4;
-        crc = (crc << 8) ^ static_cast<u16>(x << 12) ^ static_cast<u16>(x << 5) ^ static_cast<u16>(x);
+        for(size_t j = 0; j < 4; j++) digest[i * 4 + j] = static_cast<u8>(state[i] >> (24 - j * 8));
     }
 
-    return crc;
+    return digest;
 }
 
-u32 Hash::crc32(const u8* data, size_t size) { return mz_crc32(MZ_CRC32_INIT, data, size); }
-
 u16 Hash::crc16(const u8* data, size_t datasize, rd_offset offset, size_t size)
 {
     if(size == RD_NVAL) size = datasize;
@@ -34,3 +173,44 @@ u32 Hash::crc32(const u8* data, size_t datasize, rd_offset offset, size_t size)
     if((offset + size) > datasize) return 0;
     return Hash::crc32(data + offset, size);
 }
+
+u32 Hash::crc32c(const u8* data, size_t datasize, rd_offset offset, size_t size)
+{
+    if(size == RD_NVAL) size = datasize;
+    if((offset + size) > datasize) return 0;
+    return Hash::crc32c(data + offset, size);
+}
+
+u32 Hash::crc32c_sw(u32 crc, const u8* data, size_t size) { return crc32Slicing(CRC32C_TABLE, crc, data, size); }
+
+#if HASH_X64
+HASH_TARGET_SSE42 u32 Hash::crc32c_hw(u32 crc, const u8* data, size_t size)
+{
+    u64 crc64 = crc;
+
+    for( ; size >= sizeof(u64); data += sizeof(u64), size -= sizeof(u64))
+    {
+        u64 v;
+        std::memcpy(&v, data, sizeof(u64));
+        crc64 = _mm_crc32_u64(crc64, v);
+    }
+
+    crc = static_cast<u32>(crc64);
+    while(size--) crc = _mm_crc32_u8(crc, *data++);
+    return crc;
+}
+
+bool Hash::hasCrc32Instructions()
+{
+    #if _MSC_VER
+    int info[4] = { };
+    __cpuid(info, 1);
+    return info[2] & (1 << 20);
+    #else
+    return __builtin_cpu_supports("sse4.2");
+    #endif
+}
+#else
+u32 Hash::crc32c_hw(u32 crc, const u8* data, size_t size) { return Hash::crc32c_sw(crc, data, size); }
+bool Hash::hasCrc32Instructions() { return false; }
+#endif
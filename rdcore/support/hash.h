@@ -1,17 +1,28 @@
 #pragma once
 
 #include <rdapi/types.h>
+#include <array>
 
 class Hash
 {
+    public:
+        typedef std::array<u8, 32> SHA256Digest;
+
     public:
         Hash() = delete;
         static u32 adler32(const u8* data, size_t size);
         static u16 crc16(const u8* data, size_t size);
         static u32 crc32(const u8* data, size_t size);
+        static u32 crc32c(const u8* data, size_t size);
+        static SHA256Digest sha256(const u8* data, size_t size);
 
     public:
         static u16 crc16(const u8* data, size_t datasize, rd_offset offset, size_t size);
         static u32 crc32(const u8* data, size_t datasize, rd_offset offset, size_t size);
-};
+        static u32 crc32c(const u8* data, size_t datasize, rd_offset offset, size_t size);
 
+    private:
+        static u32 crc32c_sw(u32 crc, const u8* data, size_t size);
+        static u32 crc32c_hw(u32 crc, const u8* data, size_t size);
+        static bool hasCrc32Instructions();
+};
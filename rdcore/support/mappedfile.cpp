@@ -0,0 +1,65 @@
+#include "mappedfile.h"
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+MappedFile::~MappedFile() { this->close(); }
+bool MappedFile::isOpen() const { return m_data != nullptr; }
+const u8* MappedFile::data() const { return m_data; }
+size_t MappedFile::size() const { return m_size; }
+
+bool MappedFile::open(const fs::path& filepath)
+{
+    this->close();
+
+#ifdef _WIN32
+    HANDLE hfile = CreateFileW(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if(hfile == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER size;
+    if(!GetFileSizeEx(hfile, &size) || !size.QuadPart) { CloseHandle(hfile); return false; }
+
+    m_handle = CreateFileMappingW(hfile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(hfile); // The mapping keeps the file open
+    if(!m_handle) return false;
+
+    m_data = static_cast<const u8*>(MapViewOfFile(m_handle, FILE_MAP_READ, 0, 0, 0));
+    if(!m_data) { this->close(); return false; }
+    m_size = static_cast<size_t>(size.QuadPart);
+#else
+    int fd = ::open(filepath.c_str(), O_RDONLY);
+    if(fd == -1) return false;
+
+    struct stat st;
+    if((::fstat(fd, &st) == -1) || !st.st_size) { ::close(fd); return false; }
+
+    void* p = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // The mapping keeps the file open
+    if(p == MAP_FAILED) return false;
+
+    m_data = static_cast<const u8*>(p);
+    m_size = static_cast<size_t>(st.st_size);
+#endif
+
+    return true;
+}
+
+void MappedFile::close()
+{
+#ifdef _WIN32
+    if(m_data) UnmapViewOfFile(m_data);
+    if(m_handle) CloseHandle(m_handle);
+    m_handle = nullptr;
+#else
+    if(m_data) ::munmap(const_cast<u8*>(m_data), m_size);
+#endif
+
+    m_data = nullptr;
+    m_size = 0;
+}
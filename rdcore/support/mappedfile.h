@@ -0,0 +1,25 @@
+#pragma once
+
+#include <filesystem>
+#include <rdapi/types.h>
+
+namespace fs = std::filesystem;
+
+class MappedFile
+{
+    public:
+        MappedFile() = default;
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        ~MappedFile();
+        bool open(const fs::path& filepath);
+        void close();
+        bool isOpen() const;
+        const u8* data() const;
+        size_t size() const;
+
+    private:
+        void* m_handle{nullptr}; // Win32 file mapping
+        const u8* m_data{nullptr};
+        size_t m_size{0};
+};
@@ -0,0 +1,127 @@
+#pragma once
+
+/*
+ * std::shared_mutex that tolerates the re-entrant locking done through safe_ptr.
+ * Each thread tracks its own recursion, so the underlying mutex is taken once per thread:
+ * - The exclusive owner can lock again, both exclusively and shared.
+ * - Nested shared locks never touch the underlying mutex (no deadlock behind a waiting writer).
+ * - Locking exclusively while holding only a shared lock throws: there is no atomic upgrade,
+ *   and releasing the shared lock would let a writer change what the reader is looking at.
+ *   Shared locks are never held across plugin callbacks, the C API checks shared_only() and refuses
+ *   the write instead, an exception must not unwind through plugin frames.
+ * - New readers wait while a writer is queued, so analysis is not starved by renderers.
+ */
+
+#include <condition_variable>
+#include <shared_mutex>
+#include <system_error>
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+class recursive_shared_mutex
+{
+    private:
+        struct State { const recursive_shared_mutex* mutex; size_t shared, exclusive; };
+
+    public:
+        recursive_shared_mutex() = default;
+        recursive_shared_mutex(const recursive_shared_mutex&) = delete;
+        recursive_shared_mutex& operator=(const recursive_shared_mutex&) = delete;
+
+        void lock()
+        {
+            State& s = this->state();
+
+            if(!s.exclusive)
+            {
+                if(s.shared) throw std::system_error(std::make_error_code(std::errc::resource_deadlock_would_occur), "Shared to exclusive upgrade");
+
+                {
+                    std::scoped_lock<std::mutex> lock(m_writersmutex);
+                    m_writers++;
+                }
+
+                m_mutex.lock();
+                bool last;
+
+                {
+                    std::scoped_lock<std::mutex> lock(m_writersmutex);
+                    last = !--m_writers;
+                }
+
+                if(last) m_writerscv.notify_all(); // Let the queued readers in
+            }
+
+            s.exclusive++;
+        }
+
+        void unlock()
+        {
+            State& s = this->state();
+            if(--s.exclusive) return;
+
+            m_mutex.unlock();
+            if(s.shared) m_mutex.lock_shared(); // Downgrade
+            else this->release();
+        }
+
+        void lock_shared()
+        {
+            State& s = this->state();
+            if(!s.shared && !s.exclusive)
+            {
+                {
+                    std::unique_lock<std::mutex> lock(m_writersmutex);
+                    m_writerscv.wait(lock, [&]() { return !m_writers; });
+                }
+
+                m_mutex.lock_shared();
+            }
+
+            s.shared++;
+        }
+
+        void unlock_shared()
+        {
+            State& s = this->state();
+            if(--s.shared || s.exclusive) return;
+
+            m_mutex.unlock_shared();
+            this->release();
+        }
+
+        bool shared_only() const // The calling thread can read but not write
+        {
+            const auto& s = recursive_shared_mutex::states();
+            auto it = std::find_if(s.begin(), s.end(), [&](const State& st) { return st.mutex == this; });
+            return (it != s.end()) && it->shared && !it->exclusive;
+        }
+
+    private:
+        static std::vector<State>& states() { static thread_local std::vector<State> s; return s; }
+
+        State& state()
+        {
+            auto& s = recursive_shared_mutex::states();
+            auto it = std::find_if(s.begin(), s.end(), [&](const State& st) { return st.mutex == this; });
+            if(it != s.end()) return *it;
+            return s.emplace_back(State{this, 0, 0});
+        }
+
+        void release()
+        {
+            auto& s = recursive_shared_mutex::states();
+            auto it = std::find_if(s.begin(), s.end(), [&](const State& st) { return st.mutex == this; });
+            if(it == s.end()) return;
+
+            *it = s.back();
+            s.pop_back();
+        }
+
+    private:
+        std::shared_mutex m_mutex;
+        std::mutex m_writersmutex;
+        std::condition_variable m_writerscv;
+        size_t m_writers{0};
+};
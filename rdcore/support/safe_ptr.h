@@ -6,8 +6,10 @@
  * 3 - https://www.codeproject.com/Articles/1183446/Thread-safe-std-map-with-the-speed-of-lock-free-ma
  */
 
+#include <shared_mutex>
 #include <memory>
 #include <mutex>
+#include "recursive_shared_mutex.h"
 
 template<typename T, typename mutex_t = std::recursive_mutex, typename s_lock_t = std::scoped_lock<mutex_t>, typename x_lock_t = std::scoped_lock<mutex_t>>
 class safe_ptr
@@ -75,13 +77,16 @@ template<typename T> struct x_locked_safe_ptr {
 };
 
 template<typename T> struct s_locked_safe_ptr {
-    T& t;
+    const T& t;
     typename T::s_lock_type slock;
 
-    s_locked_safe_ptr(T& targ): t(targ), slock(*t.mget()) { }
-    typename T::object_type* operator->() const { return t.get(); }
+    s_locked_safe_ptr(const T& targ): t(targ), slock(*t.mget()) { }
+    const typename T::object_type* operator->() const { return t.get(); }
     const typename T::auto_nolock_obj operator*() const { return T::auto_nolock_obj(t.get(), *t.mget()); }
 };
 
+// Const access takes a shared lock, so readers don't serialize with each other
+template<typename T> using shared_safe_ptr = safe_ptr<T, recursive_shared_mutex, std::shared_lock<recursive_shared_mutex>, std::unique_lock<recursive_shared_mutex>>;
+
 template<typename T> x_locked_safe_ptr<T> x_lock_safe_ptr(T& t) { return x_locked_safe_ptr<T>(t); }
-template<typename T> s_locked_safe_ptr<T> s_lock_safe_ptr(T& t) { return s_locked_safe_ptr<T>(t); }
+template<typename T> s_locked_safe_ptr<T> s_lock_safe_ptr(const T& t) { return s_locked_safe_ptr<T>(t); }
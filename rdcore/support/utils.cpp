@@ -10,8 +10,6 @@
 #include "../document/document.h"
 #include "../plugin/loader.h"
 
-#define WILDCARD_BYTE "??"
-
 const char Utils::HEX_DIGITS[513] = "000102030405060708090A0B0C0D0E0F"
                                     "101112131415161718191A1B1C1D1E1F"
                                     "202122232425262728292A2B2C2D2E2F"
@@ -61,30 +59,11 @@ rd_offset Utils::findIn(const u8* data, size_t datasize, const u8* finddata, siz
 {
     if(finddatasize > datasize) return RD_NVAL;
 
-    for(const u8* p = data; datasize; datasize--, p++)
-    {
-        if(datasize < finddatasize) return RD_NVAL;
-        if(!std::memcmp(p, finddata, finddatasize)) return p - data;
-    }
+    if(!finddatasize) return RD_NVAL;
 
-    return RD_NVAL;
-}
-
-rd_offset Utils::findPattern(const u8* data, size_t datasize, std::string pattern, size_t* patternlen)
-{
-    if(!data || !datasize) return RD_NVAL;
-
-    size_t len = 0;
-    if(!Utils::checkPattern(pattern, len) || (len > datasize)) return RD_NVAL;
-    if(patternlen) *patternlen = len;
-
-    for(size_t i = 0; datasize >= len; i++, data++, datasize--)
-    {
-        if(!datasize) break;
-        if(Utils::matchPattern(data, datasize, pattern)) return i;
-    }
-
-    return RD_NVAL;
+    const u8* end = data + datasize;
+    const u8* p = std::search(data, end, std::boyer_moore_horspool_searcher<const u8*>(finddata, finddata + finddatasize));
+    return (p != end) ? static_cast<rd_offset>(p - data) : RD_NVAL;
 }
 
 std::string Utils::thunk(const std::string& s, int level)
@@ -266,62 +245,3 @@ std::string Utils::escapeRegex(const std::string& s)
     static const std::regex SPECIAL_CHARS{R"([-[\]{}()*+?.,\^$|#\s])"};
     return std::regex_replace(s, SPECIAL_CHARS, R"(\$&)");
 }
-
-bool Utils::matchPattern(const u8* data, size_t datasize, const std::string& pattern)
-{
-    const u8* pcurr = data;
-
-    for(size_t i = 0; (i <= (pattern.size() - 2)); i += 2, pcurr++, datasize--)
-    {
-        if(!datasize) return false;
-
-        const std::string& hexb = pattern.substr(i, 2);
-        if(hexb == WILDCARD_BYTE) continue;
-
-        u8 b = 0;
-        if(!Utils::toByte(hexb, &b) || (b != *pcurr)) return false;
-    }
-
-    return true;
-}
-
-bool Utils::checkPattern(std::string& p, size_t& len)
-{
-    // Cache processed patterns
-    static std::unordered_map<std::string, std::pair<std::string, size_t>> PROCESSED;
-
-    auto it = PROCESSED.find(p);
-
-    if(it != PROCESSED.end())
-    {
-        p = it->second.first;
-        len = it->second.second;
-        return true;
-    }
-
-    std::string op = p; // Store unprocessed pattern
-    p.erase(std::remove_if(p.begin(), p.end(), ::isspace), p.end());
-    if(p.empty() || (p.size() % 2)) return false;
-
-    std::string_view v(p);
-    size_t wccount = 0;
-    len = 0;
-
-    for(size_t i = 0; i < v.size() - 2; i += 2, len++)
-    {
-        const auto& hexb = v.substr(i, 2);
-
-        if(hexb == WILDCARD_BYTE)
-        {
-            wccount++;
-            continue;
-        }
-
-        if(!std::isxdigit(hexb.front()) || !std::isxdigit(hexb.back()))
-            return false;
-    }
-
-   if(wccount >= p.size()) return false;
-   PROCESSED[op] = {p, len}; // Cache processed pattern
-   return true;
-}
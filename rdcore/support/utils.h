@@ -27,7 +27,6 @@ class Utils
         static int branchDirection(rd_address fromaddress, rd_address address);
         static inline u8* relpointer(void* ptr, size_t offset) { return reinterpret_cast<u8*>(reinterpret_cast<u8*>(ptr) + offset); }
         static rd_offset findIn(const u8* data, size_t datasize, const u8* finddata, size_t finddatasize);
-        static rd_offset findPattern(const u8* data, size_t datasize, std::string pattern, size_t* patternlen = nullptr);
         static std::string thunk(const std::string& s, int level = 1);
         static std::string hexStringEndian(const Context* ctx, const RDBufferView* view, size_t size = RD_NVAL);
         static std::string hexString(const RDBufferView* view, size_t size = RD_NVAL);
@@ -58,8 +57,6 @@ class Utils
         template<typename T> static std::string hexSigned(T t, size_t bits = 0, bool withprefix = false);
         static std::string& replaceAll(std::string& s, const std::string& from, const std::string& to);
         static std::string escapeRegex(const std::string& s);
-        static bool matchPattern(const u8* data, size_t datasize, const std::string& pattern);
-        static bool checkPattern(std::string& p, size_t& len);
 
     private:
         static const char HEX_DIGITS[513];
@@ -0,0 +1,68 @@
+#include "instructioncache.h"
+#include "../document/document.h"
+#include "../context.h"
+#include <algorithm>
+
+InstructionCache::InstructionCache(Context* ctx): Object(ctx) { }
+
+bool InstructionCache::get(rd_address address, u16 assembler, bool rdil, rd_flag flags, size_t mnemoniccol, Entry* entry) const
+{
+    Key key{assembler, flags, rdil};
+
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    auto* slot = m_entries.find(address);
+    if(!slot) return false;
+
+    auto it = std::find_if(slot->begin(), slot->end(), [&key](const auto& item) { return item.first == key; });
+    if(it == slot->end()) return false;
+
+    if(it->second.mnemoniccol != mnemoniccol) return false; // Padding changed, render it again
+    if(entry) *entry = it->second;
+    return true;
+}
+
+void InstructionCache::set(rd_address address, u16 assembler, bool rdil, rd_flag flags, Entry entry)
+{
+    Key key{assembler, flags, rdil};
+
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    auto* slot = m_entries.find(address);
+    if(!slot) slot = m_entries.insert(address, Slot());
+
+    auto it = std::find_if(slot->begin(), slot->end(), [&key](const auto& item) { return item.first == key; });
+    if(it != slot->end()) it->second = std::move(entry);
+    else slot->emplace_back(key, std::move(entry));
+}
+
+void InstructionCache::invalidate(rd_address address)
+{
+    {
+        std::scoped_lock<std::mutex> lock(m_mutex);
+        if(m_entries.empty()) return; // Nothing rendered yet, the analysis doesn't pay for it
+    }
+
+    std::vector<rd_address> addresses{address};
+
+    {
+        s_lock_document lock(this->context()->document()); // Instructions referencing it show its label
+        const RDReference* refs = nullptr;
+        size_t c = lock->net()->getReferences(address, &refs);
+        for(size_t i = 0; i < c; i++) addresses.push_back(refs[i].address);
+    }
+
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    for(rd_address a : addresses) m_entries.remove(a);
+}
+
+void InstructionCache::invalidate(rd_address startaddress, rd_address endaddress)
+{
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    if(m_entries.empty() || (startaddress >= endaddress)) return;
+
+    if((endaddress - startaddress) <= m_entries.size())
+    {
+        for(rd_address a = startaddress; a < endaddress; a++) m_entries.remove(a);
+    }
+    else
+        m_entries.removeIf([&](rd_address address, const Slot&) { return (address >= startaddress) && (address < endaddress); });
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <rdapi/types.h>
+#include "../containers/lrucontainer.h"
+#include "../object.h"
+#include "common.h"
+
+#define INSTRUCTION_CACHE_SIZE 0x4000
+
+class InstructionCache: public Object // Rendered instruction chunks, shared by all renderers of a context
+{
+    public:
+        struct Entry {
+            size_t mnemoniccol{0}, mnemoniclen{0}; // Padding in effect and longest mnemonic, see Renderer::renderMnemonic()
+            std::vector<SurfaceChunk> chunks;
+            std::vector<std::string> autocomments;
+        };
+
+    private:
+        struct Key { // An address can be rendered in several ways
+            u16 assembler; // Block info, the assembler index in AddressDatabase
+            rd_flag flags;
+            bool rdil;
+
+            bool operator ==(const Key& rhs) const { return (assembler == rhs.assembler) && (flags == rhs.flags) && (rdil == rhs.rdil); }
+        };
+
+        typedef std::vector<std::pair<Key, Entry>> Slot;
+
+    public:
+        InstructionCache(Context* ctx);
+        bool get(rd_address address, u16 assembler, bool rdil, rd_flag flags, size_t mnemoniccol, Entry* entry) const;
+        void set(rd_address address, u16 assembler, bool rdil, rd_flag flags, Entry entry);
+        void invalidate(rd_address address);
+        void invalidate(rd_address startaddress, rd_address endaddress);
+
+    private:
+        mutable LRUContainer<rd_address, Slot> m_entries{INSTRUCTION_CACHE_SIZE};
+        mutable std::mutex m_mutex;
+};
@@ -0,0 +1,327 @@
+#include "listingexporter.h"
+#include "renderer.h"
+#include "../document/document.h"
+#include "../support/utils.h"
+#include "../context.h"
+#include <condition_variable>
+#include <fstream>
+#include <atomic>
+#include <thread>
+#include <mutex>
+
+#define LISTING_FILE_BUFFER (1 << 20)
+
+ListingExporter::ListingExporter(Context* ctx, rd_type format, rd_flag flags): Object(ctx), m_format(format), m_flags(flags)
+{
+    if(m_format == ListingFormat_JsonLines) // Address is a separate field, text is the content only
+        m_flags |= RendererFlags_NoAddressColumn | RendererFlags_NoSegmentColumn | RendererFlags_NoIndent;
+}
+
+bool ListingExporter::exportFile(const std::string& filepath)
+{
+    std::vector<char> buffer(LISTING_FILE_BUFFER);
+    std::ofstream ofs;
+    ofs.rdbuf()->pubsetbuf(buffer.data(), buffer.size());
+    ofs.open(filepath, std::ios::out | std::ios::binary | std::ios::trunc);
+
+    if(!ofs.is_open())
+    {
+        this->log("Cannot write " + filepath);
+        return false;
+    }
+
+    return this->exportTo([&](const char* data, size_t size) {
+        return static_cast<bool>(ofs.write(data, static_cast<std::streamsize>(size)));
+    }) && static_cast<bool>(ofs.flush());
+}
+
+bool ListingExporter::exportTo(const Sink& sink)
+{
+    if(this->context()->busy()) // Blocks and functions are still changing
+    {
+        this->log("Cannot export the listing while the analysis is running");
+        return false;
+    }
+
+    std::vector<Unit> units;
+
+    {
+        s_lock_document lock(this->context()->document());
+        m_mnemonicendcol = this->context()->surfaceState().mnemonicendcol;
+        this->collectUnits(units);
+    }
+
+    if(units.empty()) return true;
+
+    size_t nworkers = std::max<size_t>(1, std::min<size_t>(units.size(), std::thread::hardware_concurrency()));
+    size_t maxinflight = nworkers * 4; // Rendered units waiting for the sink
+    std::atomic<size_t> next{0};
+    std::condition_variable cv;
+    std::mutex mutex;
+    size_t written = 0;
+    bool cancelled = false;
+
+    std::vector<std::thread> workers;
+
+    for(size_t w = 0; w < nworkers; w++)
+    {
+        workers.emplace_back([&]() {
+            for(size_t i = next++; i < units.size(); i = next++)
+            {
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    cv.wait(lock, [&]() { return (i < (written + maxinflight)) || cancelled; });
+                    if(cancelled) return;
+                }
+
+                this->render(units[i]);
+
+                {
+                    std::scoped_lock<std::mutex> lock(mutex);
+                    units[i].ready = true;
+                }
+
+                cv.notify_all();
+            }
+        });
+    }
+
+    bool res = true;
+
+    for(size_t i = 0; i < units.size(); i++) // Concatenate in order
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [&]() { return units[i].ready; });
+        lock.unlock();
+
+        std::string output = std::move(units[i].output);
+        if(!output.empty() && !sink(output.data(), output.size())) res = false;
+
+        lock.lock();
+        written = i + 1;
+        if(!res) cancelled = true;
+        lock.unlock();
+        cv.notify_all();
+
+        if(!res) break;
+    }
+
+    for(auto& w : workers) w.join();
+    return res;
+}
+
+void ListingExporter::collectUnits(std::vector<Unit>& units) const
+{
+    const SafeDocument& doc = this->context()->document(); // Const: exportTo() holds the shared lock
+    const auto* addressspace = doc->addressSpace();
+
+    for(size_t i = 0; i < addressspace->size(); i++)
+    {
+        RDSegment segment;
+        if(!addressspace->indexToSegment(i, &segment)) continue;
+
+        const auto* blocks = addressspace->getBlocks(segment.address);
+        if(!blocks || blocks->empty()) continue;
+
+        size_t n = 0;
+
+        for(auto it = blocks->begin(); it != blocks->end(); it++, n++)
+        {
+            if(n % LISTING_UNIT_BLOCKS) continue;
+            if(!units.empty() && (units.back().segment.address == segment.address)) units.back().end = it->address;
+            units.push_back({ segment, it->address, segment.endaddress, { } });
+        }
+    }
+}
+
+void ListingExporter::render(Unit& unit) const
+{
+    std::vector<Item> items;
+    bool segmentline = false, firstsegment = false;
+
+    {
+        s_lock_document lock(this->context()->document()); // Only while the blocks are copied: renderers call plugins, they must run unlocked
+        const auto& doc = this->context()->document();
+        const auto* blocks = doc->addressSpace()->getBlocks(unit.segment.address);
+        if(!blocks) return;
+
+        auto it = blocks->find(unit.start);
+        if(it == blocks->end()) return;
+
+        if((it->address == unit.segment.address) && !this->hasFlag(RendererFlags_NoSegmentLine))
+        {
+            segmentline = true;
+            firstsegment = !doc->addressSpace()->indexOfSegment(&unit.segment);
+        }
+
+        for( ; (it != blocks->end()) && (it->address < unit.end); it++)
+            items.push_back({ *it, doc->getFlags(it->address), doc->isBasicBlockTail(it->address) });
+    }
+
+    if(segmentline)
+    {
+        if(!firstsegment) this->renderEmpty(unit);
+        this->renderLine(unit, unit.segment.address, "segment", [](Renderer& r) { r.renderSegment(); });
+    }
+
+    for(const Item& item : items)
+    {
+        rd_address address = item.block.address;
+        rd_flag flags = item.flags;
+
+        switch(item.block.type)
+        {
+            case BlockType_Code: {
+                if(flags & AddressFlags_Function) {
+                    if(address != unit.segment.address) this->renderEmpty(unit);
+                    if(!this->hasFlag(RendererFlags_NoFunctionLine)) this->renderLine(unit, address, "function", [](Renderer& r) { r.renderFunction(); });
+                }
+                else if(flags & AddressFlags_Location) {
+                    this->renderEmpty(unit);
+                    this->renderLine(unit, address, "label", [](Renderer& r) { r.renderLocation(); });
+                }
+
+                this->renderLine(unit, address, "instruction", [](Renderer& r) { r.renderInstruction(); });
+
+                if(!this->hasFlag(RendererFlags_NoSeparatorsLine) && item.basicblocktail)
+                    this->renderLine(unit, address, nullptr, [](Renderer& r) { r.renderSeparator(); });
+
+                break;
+            }
+
+            case BlockType_String:
+            case BlockType_Data: {
+                if(flags & AddressFlags_Type) {
+                    this->renderEmpty(unit);
+                    this->renderLine(unit, address, "type", [](Renderer& r) { r.renderType(); });
+                }
+
+                if(flags & AddressFlags_TypeField) this->renderLine(unit, address, "field", [](Renderer& r) { r.renderTypeField(); });
+                else if(item.block.type == BlockType_String) this->renderLine(unit, address, "string", [](Renderer& r) { r.renderString(); });
+                else this->renderLine(unit, address, "data", [](Renderer& r) { r.renderData(); });
+
+                if(flags & AddressFlags_TypeEnd) this->renderEmpty(unit);
+                break;
+            }
+
+            case BlockType_Unknown: {
+                size_t size = BlockContainer::size(&item.block);
+                this->renderLine(unit, address, "unknown", [size](Renderer& r) { r.renderUnknown(size); });
+                break;
+            }
+
+            default: {
+                std::string s = "Block #" + std::to_string(item.block.type);
+                this->renderLine(unit, address, "line", [&s](Renderer& r) { r.renderLine(s); });
+                break;
+            }
+        }
+    }
+}
+
+void ListingExporter::renderLine(Unit& unit, rd_address address, const char* kind, const RenderCallback& cb) const
+{
+    if(!kind && (m_format == ListingFormat_JsonLines)) return; // Decorations only
+
+    SurfaceRow row(address);
+
+    {
+        Renderer r(this->context(), row, m_flags, m_mnemonicendcol);
+        cb(r);
+    }
+
+    if(m_format == ListingFormat_JsonLines)
+    {
+        unit.output += "{\"address\":\"";
+        unit.output += Utils::hex(address, 0, true);
+        unit.output += "\",\"kind\":\"";
+        unit.output += kind;
+        unit.output += "\",\"text\":\"";
+        ListingExporter::appendJson(unit.output, row.text);
+        unit.output += "\"}\n";
+    }
+    else
+    {
+        unit.output += row.text;
+        unit.output += '\n';
+    }
+}
+
+void ListingExporter::renderEmpty(Unit& unit) const
+{
+    if((m_format == ListingFormat_JsonLines) || this->hasFlag(RendererFlags_NoEmptyLine)) return;
+    if(!unit.output.empty() && (unit.output.size() < 2 || unit.output.compare(unit.output.size() - 2, 2, "\n\n"))) unit.output += '\n';
+}
+
+bool ListingExporter::hasFlag(rd_flag flag) const { return m_flags & flag; }
+
+void ListingExporter::appendJson(std::string& out, const std::string& s)
+{
+    static const char* HEX = "0123456789abcdef";
+
+    for(size_t i = 0; i < s.size(); )
+    {
+        u8 ch = static_cast<u8>(s[i]);
+
+        if(ch >= 0x80) // Binary strings are not UTF-8: keep valid sequences, escape the stray bytes
+        {
+            size_t n = ListingExporter::utf8Sequence(s, i);
+
+            if(n) out.append(s, i, n);
+            else {
+                out += "\\u00";
+                out += HEX[(ch >> 4) & 0xF];
+                out += HEX[ch & 0xF];
+                n = 1;
+            }
+
+            i += n;
+            continue;
+        }
+
+        switch(ch)
+        {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+
+            default:
+                if(ch < 0x20) {
+                    out += "\\u00";
+                    out += HEX[(ch >> 4) & 0xF];
+                    out += HEX[ch & 0xF];
+                }
+                else
+                    out += static_cast<char>(ch);
+                break;
+        }
+
+        i++;
+    }
+}
+
+size_t ListingExporter::utf8Sequence(const std::string& s, size_t idx)
+{
+    u8 ch = static_cast<u8>(s[idx]);
+    size_t n = 0;
+    u8 lo = 0x80, hi = 0xBF; // Second byte range, narrowed to reject overlongs and surrogates
+
+    if((ch >= 0xC2) && (ch <= 0xDF)) n = 2;
+    else if((ch >= 0xE0) && (ch <= 0xEF)) { n = 3; if(ch == 0xE0) lo = 0xA0; else if(ch == 0xED) hi = 0x9F; }
+    else if((ch >= 0xF0) && (ch <= 0xF4)) { n = 4; if(ch == 0xF0) lo = 0x90; else if(ch == 0xF4) hi = 0x8F; }
+    else return 0;
+
+    if((idx + n) > s.size()) return 0;
+
+    for(size_t i = 1; i < n; i++)
+    {
+        u8 c = static_cast<u8>(s[idx + i]);
+        if((c < lo) || (c > hi)) return 0;
+        lo = 0x80;
+        hi = 0xBF;
+    }
+
+    return n;
+}
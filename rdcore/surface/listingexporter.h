@@ -0,0 +1,50 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+#include <rdapi/renderer/listing.h>
+#include "../object.h"
+
+#define LISTING_UNIT_BLOCKS 4096 // Blocks rendered by a worker in one go
+
+class Renderer;
+
+class ListingExporter: public Object // Renders the whole listing as text, without building surface rows
+{
+    public:
+        typedef std::function<bool(const char*, size_t)> Sink;
+
+    private:
+        typedef std::function<void(Renderer&)> RenderCallback;
+
+        struct Unit {
+            RDSegment segment;
+            rd_address start, end; // [start, end)
+            std::string output;
+            bool ready{false};
+        };
+
+        struct Item { RDBlock block; rd_flag flags; bool basicblocktail; }; // Copied under the document lock
+
+    public:
+        ListingExporter(Context* ctx, rd_type format, rd_flag flags);
+        bool exportFile(const std::string& filepath);
+        bool exportTo(const Sink& sink);
+
+    private:
+        void collectUnits(std::vector<Unit>& units) const;
+        void render(Unit& unit) const;
+        void renderLine(Unit& unit, rd_address address, const char* kind, const RenderCallback& cb) const;
+        void renderEmpty(Unit& unit) const;
+        bool hasFlag(rd_flag flag) const;
+
+    private:
+        static void appendJson(std::string& out, const std::string& s);
+        static size_t utf8Sequence(const std::string& s, size_t idx); // Length of the valid UTF-8 sequence at idx, 0 if invalid
+
+    private:
+        rd_type m_format;
+        rd_flag m_flags;
+        size_t m_mnemonicendcol{0}; // Taken once per export, workers don't share the surface columns
+};
@@ -3,6 +3,7 @@
 #include "../document/document.h"
 #include "../plugin/assembler.h"
 #include "../rdil/ilfunction.h"
+#include "../rdil/ilcache.h"
 #include "../rdil/rdil.h"
 #include "../support/utils.h"
 #include "../context.h"
@@ -16,6 +17,7 @@
 #define UNKNOWN_STRING     "???"
 
 Renderer::Renderer(Context* ctx, SurfaceRow& sfrow, rd_flag flags): Object(ctx), m_surface(nullptr), m_sfrow(sfrow), m_flags(flags) { this->renderPrologue(); }
+Renderer::Renderer(Context* ctx, SurfaceRow& sfrow, rd_flag flags, size_t mnemonicendcol): Object(ctx), m_surface(nullptr), m_sfrow(sfrow), m_flags(flags), m_textonly(true), m_mnemonicendcol(mnemonicendcol) { this->renderPrologue(); }
 Renderer::Renderer(SurfaceRenderer* surface, SurfaceRow& sfrow, rd_flag flags): Object(surface->context()), m_surface(surface), m_sfrow(sfrow), m_flags(flags) { this->renderPrologue(); }
 
 Renderer::~Renderer()
@@ -43,8 +45,10 @@ void Renderer::renderAssemblerInstruction()
     RDRendererParams srp;
     this->compileParams(&srp);
 
-    auto* assembler = this->context()->getAssembler(srp.address);
-    if(!assembler || !assembler->renderInstruction(&srp)) this->chunk(UNKNOWN_STRING);
+    this->renderCached(false, [&]() {
+        auto* assembler = this->context()->getAssembler(srp.address);
+        if(!assembler || !assembler->renderInstruction(&srp)) this->chunk(UNKNOWN_STRING);
+    });
 }
 
 void Renderer::renderRDILInstruction()
@@ -52,33 +56,14 @@ void Renderer::renderRDILInstruction()
     RDRendererParams srp;
     this->compileParams(&srp);
 
-    ILFunction il(this->context());
-
-    auto* assembler = this->context()->getAssembler(srp.address);
-    if(assembler) assembler->lift(srp.address, &srp.view, &il);
-
-    for(size_t i = 0; i < il.size(); i++)
-    {
-        if(i) this->chunk("; "); // Attach more statements, if needed
-        RDIL::render(il.expression(i), this, this->address());
-    }
+    this->renderCached(true, [&]() { this->renderRDIL(&srp); });
 }
 
 void Renderer::renderRDILFormat()
 {
     RDRendererParams srp;
     this->compileParams(&srp);
-
-    ILFunction il(this->context());
-
-    auto* assembler = this->context()->getAssembler(srp.address);
-    if(assembler) assembler->lift(srp.address, &srp.view, &il);
-
-    for(size_t i = 0; i < il.size(); i++)
-    {
-        if(i) this->chunk("; "); // Attach more statements, if needed
-        RDIL::render(il.expression(i), this, this->address());
-    }
+    this->renderRDIL(&srp);
 }
 
 void Renderer::renderSigned(s64 value) { this->chunk(Utils::hex(value), Theme_Constant); }
@@ -105,10 +90,15 @@ void Renderer::renderMnemonic(const std::string& s, rd_type theme)
 
     this->chunk(s, theme);
 
-    auto& ss = this->context()->surfaceState();
-    ss.mnemonicendcol = std::max(ss.mnemonicendcol, s.size());
+    if(m_capture) m_capture->mnemoniclen = std::max(m_capture->mnemoniclen, s.size());
 
-    size_t diff = ss.mnemonicendcol - s.size();
+    if(!m_textonly)
+    {
+        auto& ss = this->context()->surfaceState();
+        ss.mnemonicendcol = std::max(ss.mnemonicendcol, s.size());
+    }
+
+    size_t diff = std::max(this->mnemonicEndCol(), s.size()) - s.size();
     if(diff) this->chunk(std::string(diff, ' '));
 }
 
@@ -305,7 +295,8 @@ void Renderer::renderType()
         return;
     }
 
-    this->chunk(type->name(), Theme_Label)
+    auto label = this->document()->getLabel(this->address()); // Types are shared, the name lives in the label
+    this->chunk(label ? *label : type->name(), Theme_Label)
          .chunk(" ")
          .chunk(type->typeName(), Theme_Type);
 }
@@ -379,6 +370,67 @@ void Renderer::renderComments()
     }
 }
 
+void Renderer::renderRDIL(const RDRendererParams* srp)
+{
+    size_t idx = 0, c = 0;
+    auto cachedil = this->context()->ilCache()->function(srp->address); // Shared with the whole function
+
+    if(cachedil && cachedil->range(srp->address, &idx, &c))
+    {
+        for(size_t i = 0; i < c; i++)
+        {
+            if(i) this->chunk("; "); // Attach more statements, if needed
+            RDIL::render(cachedil->expression(idx + i), this, this->address());
+        }
+
+        return;
+    }
+
+    ILFunction il(this->context());
+
+    auto* assembler = this->context()->getAssembler(srp->address);
+    if(assembler) assembler->lift(srp->address, &srp->view, &il);
+
+    for(size_t i = 0; i < il.size(); i++)
+    {
+        if(i) this->chunk("; "); // Attach more statements, if needed
+        RDIL::render(il.expression(i), this, this->address());
+    }
+}
+
+void Renderer::renderCached(bool rdil, const std::function<void()>& cb)
+{
+    auto* cache = this->context()->instructionCache();
+    InstructionCache::Entry entry;
+
+    RDBlock block;
+    u16 assembler = this->document()->addressToBlock(this->address(), &block) ? block.codeinfo : 0;
+
+    if(cache->get(this->address(), assembler, rdil, m_flags, this->mnemonicEndCol(), &entry))
+    {
+        for(const auto& c : entry.chunks) this->chunk(c.chunk, c.foreground, c.background);
+        m_autocomments.insert(m_autocomments.end(), entry.autocomments.begin(), entry.autocomments.end());
+
+        if(!m_textonly)
+        {
+            auto& ss = this->context()->surfaceState();
+            ss.mnemonicendcol = std::max(ss.mnemonicendcol, entry.mnemoniclen);
+        }
+
+        return;
+    }
+
+    entry.mnemoniccol = this->mnemonicEndCol();
+    size_t autoidx = m_autocomments.size();
+
+    m_capture = &entry;
+    cb();
+    m_capture = nullptr;
+
+    entry.autocomments.assign(m_autocomments.begin() + autoidx, m_autocomments.end());
+    cache->set(this->address(), assembler, rdil, m_flags, std::move(entry));
+}
+
 void Renderer::compileParams(RDRendererParams* srp)
 {
     *srp = { this->address(),
@@ -386,7 +438,7 @@ void Renderer::compileParams(RDRendererParams* srp)
              CPTR(const RDContext, this->context()),
              CPTR(RDRenderer, this) };
 
-    this->context()->document()->getView(this->address(), RD_NVAL, &srp->view);
+    this->document()->getView(this->address(), RD_NVAL, &srp->view);
 }
 
 void Renderer::renderValue(rd_address address, size_t size)
@@ -429,7 +481,8 @@ void Renderer::renderValue(rd_address address, size_t size)
 }
 
 bool Renderer::hasFlag(rd_flag f) const { return m_flags & f; }
-SafeDocument& Renderer::document() const { return this->context()->document(); }
+size_t Renderer::mnemonicEndCol() const { return m_textonly ? m_mnemonicendcol : this->context()->surfaceState().mnemonicendcol; }
+const SafeDocument& Renderer::document() const { return this->context()->document(); }
 
 Renderer& Renderer::chunk(const std::string& s, u8 fg, u8 bg)
 {
@@ -437,7 +490,8 @@ Renderer& Renderer::chunk(const std::string& s, u8 fg, u8 bg)
     if(bg == Theme_Default) bg = m_currentbg;
 
     m_sfrow.text += s;
-    m_sfrow.chunks.push_back({ bg, fg, s });
+    if(!m_textonly) m_sfrow.chunks.push_back({ bg, fg, s });
+    if(m_capture) m_capture->chunks.push_back({ bg, fg, s });
     return *this;
 }
 
@@ -472,8 +526,13 @@ std::string Renderer::getRDILInstruction(Context* ctx, rd_address address)
 
 std::string Renderer::getRDILFormat(Context* ctx, rd_address address)
 {
+    auto cachedil = ctx->ilCache()->function(address);
+    const ILExpression* e = cachedil ? cachedil->expressionAt(address) : nullptr;
+    if(e) return RDIL::getFormat(e);
+
     RDBufferView view;
-    if(!ctx->document()->getView(address, RD_NVAL, &view)) return std::string();
+    const SafeDocument& doc = ctx->document();
+    if(!doc->getView(address, RD_NVAL, &view)) return std::string();
 
     ILFunction il(ctx);
     auto* assembler = ctx->getAssembler(address);
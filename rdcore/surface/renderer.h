@@ -3,10 +3,12 @@
 #include <algorithm>
 #include <string>
 #include <deque>
+#include <functional>
 #include <rdapi/renderer/renderer.h>
 #include <rdapi/config.h>
 #include "../document/document_fwd.h"
 #include "../object.h"
+#include "instructioncache.h"
 #include "common.h"
 
 #define HEXDUMP_LENGTH 0x10
@@ -40,6 +42,7 @@ class Renderer: public Object
 
     public:
         Renderer(Context* ctx, SurfaceRow& sfrow, rd_flag flags);
+        Renderer(Context* ctx, SurfaceRow& sfrow, rd_flag flags, size_t mnemonicendcol); // Text only, against a caller owned column
         Renderer(SurfaceRenderer* surface, SurfaceRow& sfrow, rd_flag flags);
         ~Renderer();
 
@@ -75,12 +78,15 @@ class Renderer: public Object
         inline rd_address address() const { return m_sfrow.address; }
         std::string renderLabel(u8 theme = Theme_Label);
         bool hasFlag(rd_flag f) const;
+        size_t mnemonicEndCol() const;
         bool renderInstrIndent(const std::string& diffstr, bool ignoreflags = false);
         void compileParams(RDRendererParams* srp);
         void renderValue(rd_address address, size_t size);
         void renderLabelIndent();
         void renderPrologue();
         void renderComments();
+        void renderCached(bool rdil, const std::function<void()>& cb);
+        void renderRDIL(const RDRendererParams* srp);
 
     public:
         static std::string getInstruction(Context* ctx, rd_address address);
@@ -91,7 +97,7 @@ class Renderer: public Object
     private:
         Renderer& chunk(const std::string& s, u8 fg = Theme_Default, u8 bg = Theme_Default);
         Renderer& chunkalign(const std::string& s, u8 fg = Theme_Default, u8 bg = Theme_Default);
-        SafeDocument& document() const;
+        const SafeDocument& document() const;
 
     private:
         mutable std::string m_asminstruction, m_rdilinstruction;
@@ -99,6 +105,9 @@ class Renderer: public Object
         SurfaceRenderer* m_surface;
         SurfaceRow& m_sfrow;
         std::vector<std::string> m_autocomments;
+        InstructionCache::Entry* m_capture{nullptr};
         u8 m_currentfg{Theme_Default}, m_currentbg{Theme_Default};
         rd_flag m_flags;
+        bool m_textonly{false};      // Only SurfaceRow::text is filled, the shared columns are neither read nor updated
+        size_t m_mnemonicendcol{0}; // Text only
 };
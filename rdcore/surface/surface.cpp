@@ -16,7 +16,7 @@ Surface::Surface(Context* ctx, rd_flag flags, uintptr_t userdata): SurfaceRender
 
 Surface::~Surface()
 {
-    this->document()->unsubscribe(this);
+    this->context()->document()->unsubscribe(this);
 
     if(this->context()->activeSurface() == this)
         this->context()->setActiveSurface(nullptr);
@@ -17,11 +17,15 @@ void SurfacePath::update()
 {
     m_paths.clear();
     m_done.clear();
+    m_imported.clear();
 
-    const auto* net = this->context()->net();
-    const auto& doc = this->context()->document();
+    s_lock_document doc(this->context()->document()); // Held while walking the net
+    const auto* net = doc->net();
     const auto& rows = m_surface->rows();
 
+    int nrows = 0;
+    m_surface->getSize(&nrows, nullptr);
+
     for(int i = 0; i < m_surface->lastRow(); i++)
     {
         const auto& row = rows[i];
@@ -30,6 +34,7 @@ void SurfacePath::update()
         if(!node) continue;
 
         auto flags = doc->getFlags(row.address);
+        m_imported[row.address] = flags & AddressFlags_Imported;
         if(flags & AddressFlags_Imported) continue;
 
         if(flags & AddressFlags_Location)
@@ -37,8 +42,8 @@ void SurfacePath::update()
             for(const auto& from : node->from)
             {
                 if(from == row.address) continue;
-                if(doc->getFlags(from) & AddressFlags_Imported) continue;
-                this->insertPath(from, row.address);
+                if(this->isImported(from)) continue;
+                this->insertPath(net->findNode(from), from, row.address, nrows);
             }
         }
         else
@@ -46,49 +51,62 @@ void SurfacePath::update()
             for(const auto& branch : node->branchestrue)
             {
                 if(branch == row.address) continue;
-                if(doc->getFlags(branch) & AddressFlags_Imported) continue;
-                this->insertPath(row.address, branch);
+                if(this->isImported(branch)) continue;
+                this->insertPath(node, row.address, branch, nrows);
             }
         }
     }
 
-    std::sort(m_paths.begin(), m_paths.end(), [](const auto& p1, const auto& p2) -> bool {
-        return p1.fromrow < p2.fromrow;
-    });
+    m_imported.clear();
+    this->sortPaths();
 }
 
-void SurfacePath::insertPath(rd_address fromaddress, rd_address toaddress)
+void SurfacePath::insertPath(const DocumentNetNode* fromnode, rd_address fromaddress, rd_address toaddress, int nrows)
 {
-    const auto* net = this->context()->net();
-    const auto* node = net->findNode(fromaddress);
-    if(!node) return;
-
-    int fromrow = m_surface->lastIndexOf(fromaddress), torow = this->calculateToRow(fromaddress, toaddress);
+    if(!fromnode) return;
+    if(!m_done.emplace(fromaddress, toaddress).second) return;
 
-    auto pair = std::make_pair(fromaddress, toaddress);
-    auto it = m_done.insert(pair);
-    if(!it.second) return;
+    int fromrow = m_surface->lastIndexOf(fromaddress), torow = this->calculateToRow(fromaddress, toaddress, nrows);
 
     if(fromaddress > toaddress) // Loop
     {
-        if(node->branchesfalse.size()) m_paths.push_back({ fromrow, torow, Theme_GraphEdgeLoopCond });
+        if(fromnode->branchesfalse.size()) m_paths.push_back({ fromrow, torow, Theme_GraphEdgeLoopCond });
         else m_paths.push_back({ fromrow, torow, Theme_GraphEdgeLoop });
     }
     else
     {
-        if(node->branchesfalse.size()) m_paths.push_back({ fromrow, torow, Theme_Success });
+        if(fromnode->branchesfalse.size()) m_paths.push_back({ fromrow, torow, Theme_Success });
         else m_paths.push_back({ fromrow, torow, Theme_GraphEdge });
     }
 }
 
-int SurfacePath::calculateToRow(rd_address fromaddress, rd_address toaddress) const
+int SurfacePath::calculateToRow(rd_address fromaddress, rd_address toaddress, int nrows) const
 {
     int torow = m_surface->lastIndexOf(toaddress);
     if(torow != -1) return torow;
 
-    int rows = 0;
-    m_surface->getSize(&rows, nullptr);
-
     if(toaddress < fromaddress) return -1;
-    else return rows + 1;
+    else return nrows + 1;
+}
+
+bool SurfacePath::isImported(rd_address address)
+{
+    auto [it, inserted] = m_imported.try_emplace(address, false);
+    const SafeDocument& doc = this->context()->document(); // Const: update() holds the shared lock
+    if(inserted) it->second = doc->getFlags(address) & AddressFlags_Imported;
+    return it->second;
+}
+
+void SurfacePath::sortPaths()
+{
+    if(m_paths.size() < 2) return;
+
+    // Counting sort by source row, unresolved sources (-1) go first
+    std::vector<size_t> offsets(m_surface->rows().size() + 2, 0);
+    for(const auto& p : m_paths) offsets[p.fromrow + 2]++;
+    for(size_t i = 1; i < offsets.size(); i++) offsets[i] += offsets[i - 1];
+
+    std::vector<RDPathItem> sorted(m_paths.size());
+    for(const auto& p : m_paths) sorted[offsets[p.fromrow + 1]++] = p;
+    m_paths.swap(sorted);
 }
@@ -1,26 +1,36 @@
 #pragma once
 
 #include <rdapi/renderer/surface.h>
+#include <unordered_set>
+#include <unordered_map>
 #include <vector>
-#include <set>
 #include "../object.h"
 
+struct DocumentNetNode;
+
 class Surface;
 
 class SurfacePath : public Object
 {
+    private:
+        struct EdgeHash {
+            size_t operator()(const std::pair<rd_address, rd_address>& e) const { return std::hash<rd_address>()(e.first) ^ (std::hash<rd_address>()(e.second) * 0x9E3779B97F4A7C15ull); }
+        };
+
     public:
         SurfacePath(Surface* sf);
         size_t getPath(const RDPathItem** path) const;
         void update();
 
     private:
-        void insertPath(rd_address fromaddress, rd_address toaddress);
-        int calculateToRow(rd_address fromaddress, rd_address toaddress) const;
+        void insertPath(const DocumentNetNode* fromnode, rd_address fromaddress, rd_address toaddress, int nrows);
+        int calculateToRow(rd_address fromaddress, rd_address toaddress, int nrows) const;
+        bool isImported(rd_address address);
+        void sortPaths();
 
     private:
-        std::set<std::pair<rd_address, rd_address>> m_done;
+        std::unordered_set<std::pair<rd_address, rd_address>, EdgeHash> m_done;
+        std::unordered_map<rd_address, bool> m_imported; // Valid during update() only
         std::vector<RDPathItem> m_paths;
         Surface* m_surface;
 };
-
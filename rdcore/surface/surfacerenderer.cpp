@@ -7,7 +7,7 @@
 #define BLANK_CELL { Theme_Default, Theme_Default, ' ' }
 
 SurfaceRenderer::SurfaceRenderer(Context* ctx, rd_flag flags): Object(ctx), m_flags(flags) { }
-SafeDocument& SurfaceRenderer::document() const { return this->context()->document(); }
+const SafeDocument& SurfaceRenderer::document() const { return this->context()->document(); }
 rd_address SurfaceRenderer::firstAddress() const { return m_rows.empty() ? m_range.first : m_rows.front().address; }
 rd_address SurfaceRenderer::lastAddress() const { return m_rows.empty() ? m_range.second : m_rows.back().address; }
 const SurfaceRenderer::Rows& SurfaceRenderer::rows() const { return m_rows; }
@@ -31,24 +31,14 @@ int SurfaceRenderer::row(int row, const RDSurfaceCell** cells) const
 
 int SurfaceRenderer::indexOf(rd_address address) const
 {
-    for(size_t i = 0; i < m_rows.size(); i++)
-    {
-        if((m_rows[i].address == address) && !m_rows[i].isvirtual)
-            return i;
-    }
-
-    return -1;
+    auto it = m_rowindex.find(address);
+    return (it != m_rowindex.end()) ? it->second.first : -1;
 }
 
 int SurfaceRenderer::lastIndexOf(rd_address address) const
 {
-    for(size_t i = m_rows.size(); i-- > 0; )
-    {
-        if((m_rows[i].address == address) && !m_rows[i].isvirtual)
-            return i;
-    }
-
-    return -1;
+    auto it = m_rowindex.find(address);
+    return (it != m_rowindex.end()) ? it->second.second : -1;
 }
 
 void SurfaceRenderer::setLastColumn(int col) { m_lastcolumn = std::max<int>(this->lastColumn(), col); }
@@ -158,10 +148,14 @@ void SurfaceRenderer::updateSegments(const CanUpdateCallback& canupdate)
     }
 }
 
-SurfaceRow& SurfaceRenderer::insertRow(rd_address address)
+SurfaceRow& SurfaceRenderer::insertRow(rd_address address, bool isvirtual)
 {
-    auto& row = m_rows.emplace_back();
-    row.address = address;
+    int idx = m_rows.size();
+    auto& row = m_rows.emplace_back(address, isvirtual);
+    if(isvirtual) return row;
+
+    auto it = m_rowindex.try_emplace(address, idx, idx).first;
+    it->second.second = idx;
     return row;
 }
 
@@ -184,6 +178,7 @@ void SurfaceRenderer::update(const CanUpdateCallback& canupdate)
     if(m_range.first == RD_NVAL) return;
 
     m_rows.clear();
+    m_rowindex.clear();
     m_lastcolumn = 0;
 
     this->updateSegments(canupdate);
@@ -226,7 +221,6 @@ RDSurfaceCell& SurfaceRenderer::cell(int row, int col) { return m_rows[row].cell
 Renderer SurfaceRenderer::createLine(rd_address address, bool isvirtual)
 {
     m_needsempty = true;
-    auto& row = this->insertRow(address);
-    row.isvirtual = isvirtual;
+    auto& row = this->insertRow(address, isvirtual);
     return Renderer(this, row, m_flags);
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <unordered_map>
 #include <functional>
 #include <vector>
 #include <deque>
@@ -32,7 +33,7 @@ class SurfaceRenderer: public Object
 
     public:
         SurfaceRenderer(Context* ctx, rd_flag flags);
-        SafeDocument& document() const;
+        const SafeDocument& document() const;
         rd_address firstAddress() const;
         rd_address lastAddress() const;
         const Rows& rows() const;
@@ -61,13 +62,16 @@ class SurfaceRenderer: public Object
         inline void createEmptyLine(rd_address address, bool ignorestate = false);
         inline void createSeparator(rd_address address);
         void update(const CanUpdateCallback& canupdate);
-        SurfaceRow& insertRow(rd_address address);
+        SurfaceRow& insertRow(rd_address address, bool isvirtual);
 
     protected:
         std::pair<rd_address, rd_address> m_range{RD_NVAL, RD_NVAL};
         int m_nrows{0}, m_ncols{0}, m_firstcol{0};
         Rows m_rows;
 
+    private:
+        std::unordered_map<rd_address, std::pair<int, int>> m_rowindex; // Address -> First and last non-virtual row
+
     private:
         mutable std::mutex m_mutex;
         mutable std::vector<RDSurfaceCell> m_reqrows;
@@ -47,3 +47,4 @@ class Type: public Object
 };
 
 typedef std::unique_ptr<Type> TypePtr;
+typedef std::shared_ptr<const Type> SharedTypePtr; // Immutable, shared between addresses
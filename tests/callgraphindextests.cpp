@@ -0,0 +1,119 @@
+#include <vector>
+#include "../rdcore/document/model/callgraphindex.h"
+#include "testrandom.h"
+#include "doctest.h"
+
+typedef std::vector<rd_address> Addresses;
+
+static Addresses callees(const CallGraphIndex& cgi, rd_address address)
+{
+    const rd_address* addresses = nullptr;
+    size_t c = cgi.callees(address, &addresses);
+    return c ? Addresses(addresses, addresses + c) : Addresses{ };
+}
+
+static Addresses callers(const CallGraphIndex& cgi, rd_address address)
+{
+    const rd_address* addresses = nullptr;
+    size_t c = cgi.callers(address, &addresses);
+    return c ? Addresses(addresses, addresses + c) : Addresses{ };
+}
+
+TEST_CASE("CallGraphIndex")
+{
+    CallGraphIndex cgi;
+    cgi.update(0x3000, { 0x1000, 0x2000, 0x1000 }); // Unsorted, with a duplicate
+    cgi.update(0x1000, { 0x2000 });
+
+    SUBCASE("Compact")
+    {
+        REQUIRE(cgi.edges() == 3);
+        REQUIRE(callees(cgi, 0x3000) == Addresses{ 0x1000, 0x2000 });
+        REQUIRE(callees(cgi, 0x1000) == Addresses{ 0x2000 });
+        REQUIRE(callees(cgi, 0x2000).empty()); // Only known as a callee
+        REQUIRE(callees(cgi, 0x4000).empty());
+
+        REQUIRE(callers(cgi, 0x1000) == Addresses{ 0x3000 });
+        REQUIRE(callers(cgi, 0x2000) == Addresses{ 0x1000, 0x3000 });
+        REQUIRE(callers(cgi, 0x3000).empty());
+    }
+
+    SUBCASE("Incremental edges")
+    {
+        REQUIRE(cgi.edges() == 3); // Compact once, then keep updating
+
+        cgi.update(0x0500, { 0x3000, 0x2000 });
+        REQUIRE(cgi.edges() == 5);
+        REQUIRE(callees(cgi, 0x0500) == Addresses{ 0x2000, 0x3000 });
+        REQUIRE(callers(cgi, 0x2000) == Addresses{ 0x0500, 0x1000, 0x3000 });
+        REQUIRE(callers(cgi, 0x3000) == Addresses{ 0x0500 });
+
+        cgi.update(0x3000, { 0x4000 }); // Re-analyzed: old edges are replaced
+        REQUIRE(cgi.edges() == 4);
+        REQUIRE(callees(cgi, 0x3000) == Addresses{ 0x4000 });
+        REQUIRE(callers(cgi, 0x1000).empty());
+        REQUIRE(callers(cgi, 0x2000) == Addresses{ 0x0500, 0x1000 });
+        REQUIRE(callers(cgi, 0x4000) == Addresses{ 0x3000 });
+
+        cgi.update(0x1000, { });
+        REQUIRE(cgi.edges() == 3);
+        REQUIRE(callees(cgi, 0x1000).empty());
+        REQUIRE(callers(cgi, 0x2000) == Addresses{ 0x0500 });
+    }
+
+    SUBCASE("Replace all")
+    {
+        REQUIRE(cgi.edges() == 3);
+
+        cgi.update(CallGraphIndex::Calls{ { 0x2000, { 0x4000, 0x1000, 0x4000 } } }); // 0x1000 and 0x3000 are gone
+        REQUIRE(cgi.edges() == 2);
+        REQUIRE(callees(cgi, 0x2000) == Addresses{ 0x1000, 0x4000 });
+        REQUIRE(callees(cgi, 0x3000).empty());
+        REQUIRE(callers(cgi, 0x2000).empty());
+        REQUIRE(callers(cgi, 0x1000) == Addresses{ 0x2000 });
+    }
+
+    SUBCASE("Clear")
+    {
+        cgi.clear();
+        REQUIRE(cgi.edges() == 0);
+        REQUIRE(callees(cgi, 0x3000).empty());
+
+        cgi.update(0x1000, { 0x1000 }); // Recursion
+        REQUIRE(callees(cgi, 0x1000) == Addresses{ 0x1000 });
+        REQUIRE(callers(cgi, 0x1000) == Addresses{ 0x1000 });
+    }
+}
+
+TEST_CASE("CallGraphIndex patched")
+{
+    // Rows are patched between queries, they must match a full rebuild
+    CallGraphIndex patched;
+    CallGraphIndex::Calls calls;
+    TestRandom random(0x6C078965);
+
+    for(size_t i = 0; i < (CALL_GRAPH_INDEX_HOLES_MIN * 4); i++) // Crosses a few compactions
+    {
+        rd_address function = 0x1000 + ((random.next() % 64) * 0x10);
+        Addresses functioncalls(random.next() % 8);
+        for(rd_address& callee : functioncalls) callee = 0x1000 + ((random.next() % 64) * 0x10);
+
+        patched.update(function, functioncalls);
+        calls[function] = functioncalls;
+
+        rd_address address = 0x1000 + ((random.next() % 64) * 0x10);
+        callers(patched, address); // Queried between updates
+
+        if(i % 64) continue;
+
+        CallGraphIndex rebuilt;
+        rebuilt.update(calls);
+        REQUIRE(patched.edges() == rebuilt.edges());
+
+        for(rd_address a = 0x1000; a < 0x1400; a += 0x10)
+        {
+            REQUIRE(callees(patched, a) == callees(rebuilt, a));
+            REQUIRE(callers(patched, a) == callers(rebuilt, a));
+        }
+    }
+}
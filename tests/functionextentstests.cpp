@@ -0,0 +1,113 @@
+#include <iterator>
+#include <vector>
+#include "../rdcore/document/model/functionextents.h"
+#include "testrandom.h"
+#include "doctest.h"
+
+static rd_address findFunction(const FunctionExtents& fe, rd_address address)
+{
+    rd_address function = RD_NVAL;
+    return fe.find(address, &function) ? function : RD_NVAL;
+}
+
+TEST_CASE("FunctionExtents")
+{
+    FunctionExtents fe;
+
+    fe.insert(0x1000, { { 0x1000, 0x100F }, { 0x1040, 0x104F } });
+    fe.insert(0x1020, { { 0x1020, 0x102F }, { 0x1040, 0x105F } }); // Shares 0x1040 with 0x1000
+
+    SUBCASE("Lookup")
+    {
+        REQUIRE(findFunction(fe, 0x0FFF) == RD_NVAL);
+        REQUIRE(findFunction(fe, 0x1000) == 0x1000);
+        REQUIRE(findFunction(fe, 0x100F) == 0x1000);
+        REQUIRE(findFunction(fe, 0x1010) == RD_NVAL); // Gap between blocks
+        REQUIRE(findFunction(fe, 0x1025) == 0x1020);
+        REQUIRE(findFunction(fe, 0x1060) == RD_NVAL);
+    }
+
+    SUBCASE("Overlaps")
+    {
+        REQUIRE(findFunction(fe, 0x1040) == 0x1020); // Nearest function wins
+        REQUIRE(findFunction(fe, 0x104F) == 0x1020);
+        REQUIRE(findFunction(fe, 0x1050) == 0x1020);
+
+        fe.insert(0x0800, { { 0x0800, 0x2000 } }); // Encloses everything, but it's farther
+        REQUIRE(findFunction(fe, 0x0900) == 0x0800);
+        REQUIRE(findFunction(fe, 0x1008) == 0x1000);
+        REQUIRE(findFunction(fe, 0x1010) == 0x0800);
+        REQUIRE(findFunction(fe, 0x1048) == 0x1020);
+        REQUIRE(findFunction(fe, 0x1060) == 0x0800);
+        REQUIRE(findFunction(fe, 0x2001) == RD_NVAL);
+    }
+
+    SUBCASE("Remove and reinsert")
+    {
+        fe.remove(0x1020);
+        REQUIRE(findFunction(fe, 0x1025) == RD_NVAL);
+        REQUIRE(findFunction(fe, 0x1048) == 0x1000); // Shared tail goes back to the other owner
+        REQUIRE(findFunction(fe, 0x1050) == RD_NVAL);
+
+        fe.insert(0x1020, { { 0x1020, 0x1030 } });
+        REQUIRE(findFunction(fe, 0x1030) == 0x1020);
+        REQUIRE(findFunction(fe, 0x1048) == 0x1000);
+
+        fe.remove(0x1000); // Removed and inserted before the next lookup
+        fe.insert(0x1000, { { 0x1000, 0x1003 } });
+        REQUIRE(findFunction(fe, 0x1003) == 0x1000);
+        REQUIRE(findFunction(fe, 0x1004) == RD_NVAL);
+        REQUIRE(findFunction(fe, 0x1048) == RD_NVAL);
+
+        fe.clear();
+        REQUIRE(findFunction(fe, 0x1000) == RD_NVAL);
+    }
+
+    SUBCASE("Batch")
+    {
+        const rd_address addresses[] = { 0x0FFF, 0x1000, 0x1010, 0x1028, 0x1044, 0x105F, 0x1060 };
+        const rd_address expected[] = { RD_NVAL, 0x1000, RD_NVAL, 0x1020, 0x1020, 0x1020, RD_NVAL };
+        rd_address functions[std::size(addresses)];
+
+        REQUIRE(fe.find(addresses, std::size(addresses), functions) == 4);
+
+        for(size_t i = 0; i < std::size(addresses); i++)
+            REQUIRE(functions[i] == expected[i]);
+    }
+}
+
+TEST_CASE("FunctionExtents incremental")
+{
+    // Lookups between inserts are answered on the side, they must match a full rebuild
+    FunctionExtents incremental;
+    std::vector<std::pair<rd_address, FunctionExtents::Ranges>> functions;
+    TestRandom random(0x2545F491);
+
+    for(size_t i = 0; i < (FUNCTION_EXTENTS_PENDING_MIN * 3); i++) // Crosses a few rebuilds
+    {
+        rd_address function = 0x1000 + (random.next() % 0x10000);
+        FunctionExtents::Ranges ranges{ { function, function + (random.next() % 0x40) } };
+        if(random.next() & 1) ranges.push_back({ function + 0x80, function + 0x80 + (random.next() % 0x200) }); // Tails overlap other functions
+
+        incremental.insert(function, ranges);
+        functions.emplace_back(function, ranges);
+
+        FunctionExtents rebuilt;
+        for(const auto& [f, r] : functions) rebuilt.insert(f, r);
+
+        for(size_t j = 0; j < 16; j++)
+        {
+            rd_address address = 0x1000 + (random.next() % 0x10300);
+            REQUIRE(findFunction(incremental, address) == findFunction(rebuilt, address));
+        }
+    }
+
+    rd_address removed = functions.back().first;
+    incremental.remove(removed); // Falls back to a rebuild
+
+    FunctionExtents rebuilt;
+    for(const auto& [f, r] : functions) if(f != removed) rebuilt.insert(f, r);
+
+    for(rd_address address = 0x1000; address < 0x11300; address += 0x10)
+        REQUIRE(findFunction(incremental, address) == findFunction(rebuilt, address));
+}
@@ -0,0 +1,135 @@
+#include <iterator>
+#include <set>
+#include "../rdcore/graph/graph.h"
+#include "../rdcore/graph/graphanalysis.h"
+#include "doctest.h"
+
+static std::set<RDGraphNode> toSet(const RDGraphNode* nodes, size_t c) { return { nodes, nodes + c }; }
+
+static RDGraphNode dominator(const GraphAnalysis* ga, RDGraphNode n)
+{
+    RDGraphNode idom = RD_NVAL;
+    return ga->dominator(n, &idom) ? idom : RD_NVAL;
+}
+
+static RDGraphNode postDominator(const GraphAnalysis* ga, RDGraphNode n)
+{
+    RDGraphNode ipdom = RD_NVAL;
+    return ga->postDominator(n, &ipdom) ? ipdom : RD_NVAL;
+}
+
+TEST_CASE("GraphAnalysis")
+{
+    // n0 -> n1 -> { n2, n3 } -> n4 -> n5, with n4 -> n1 (outer loop) and n2 <-> n6 (inner loop)
+    Graph g(nullptr);
+    RDGraphNode n[8];
+    for(RDGraphNode& node : n) node = g.pushNode();
+
+    g.setRoot(n[0]);
+    g.pushEdge(n[0], n[1]);
+    g.pushEdge(n[1], n[2]);
+    g.pushEdge(n[1], n[3]);
+    g.pushEdge(n[2], n[4]);
+    g.pushEdge(n[2], n[6]);
+    g.pushEdge(n[6], n[2]);
+    g.pushEdge(n[3], n[4]);
+    g.pushEdge(n[4], n[1]);
+    g.pushEdge(n[4], n[5]);
+    // n7 is unreachable
+
+    const GraphAnalysis* ga = g.analysis();
+
+    SUBCASE("Dominators")
+    {
+        REQUIRE(dominator(ga, n[0]) == RD_NVAL);
+        REQUIRE(dominator(ga, n[1]) == n[0]);
+        REQUIRE(dominator(ga, n[2]) == n[1]);
+        REQUIRE(dominator(ga, n[3]) == n[1]);
+        REQUIRE(dominator(ga, n[4]) == n[1]);
+        REQUIRE(dominator(ga, n[5]) == n[4]);
+        REQUIRE(dominator(ga, n[6]) == n[2]);
+        REQUIRE(dominator(ga, n[7]) == RD_NVAL);
+
+        REQUIRE(ga->dominates(n[0], n[5]));
+        REQUIRE(ga->dominates(n[1], n[1]));
+        REQUIRE(ga->dominates(n[2], n[6]));
+        REQUIRE_FALSE(ga->dominates(n[2], n[4]));
+        REQUIRE_FALSE(ga->dominates(n[3], n[4]));
+        REQUIRE_FALSE(ga->dominates(n[0], n[7]));
+    }
+
+    SUBCASE("Post Dominators")
+    {
+        REQUIRE(postDominator(ga, n[0]) == n[1]);
+        REQUIRE(postDominator(ga, n[1]) == n[4]);
+        REQUIRE(postDominator(ga, n[2]) == n[4]);
+        REQUIRE(postDominator(ga, n[3]) == n[4]);
+        REQUIRE(postDominator(ga, n[4]) == n[5]);
+        REQUIRE(postDominator(ga, n[6]) == n[2]);
+        REQUIRE(postDominator(ga, n[5]) == RD_NVAL); // Only the virtual exit is above it
+
+        REQUIRE(ga->postDominates(n[5], n[0]));
+        REQUIRE(ga->postDominates(n[4], n[2]));
+        REQUIRE_FALSE(ga->postDominates(n[2], n[1]));
+    }
+
+    SUBCASE("Loops")
+    {
+        const RDGraphNode* headers = nullptr;
+        REQUIRE(ga->loops(&headers) == 2);
+        REQUIRE(toSet(headers, 2) == std::set<RDGraphNode>{ n[1], n[2] });
+
+        const RDGraphNode* body = nullptr;
+        size_t c = ga->loopBody(n[1], &body);
+        REQUIRE(toSet(body, c) == std::set<RDGraphNode>{ n[1], n[2], n[3], n[4], n[6] });
+        c = ga->loopBody(n[2], &body);
+        REQUIRE(toSet(body, c) == std::set<RDGraphNode>{ n[2], n[6] });
+        REQUIRE(ga->loopBody(n[3], &body) == 0); // Not a header
+
+        REQUIRE(ga->loopDepth(n[0]) == 0);
+        REQUIRE(ga->loopDepth(n[1]) == 1);
+        REQUIRE(ga->loopDepth(n[2]) == 2);
+        REQUIRE(ga->loopDepth(n[4]) == 1);
+        REQUIRE(ga->loopDepth(n[5]) == 0);
+        REQUIRE(ga->loopDepth(n[6]) == 2);
+        REQUIRE(ga->loopDepth(n[7]) == 0);
+
+        RDGraphNode header = RD_NVAL;
+        REQUIRE(ga->loopHeader(n[6], &header));
+        REQUIRE(header == n[2]);
+        REQUIRE(ga->loopHeader(n[3], &header));
+        REQUIRE(header == n[1]);
+        REQUIRE_FALSE(ga->loopHeader(n[5], &header));
+
+        RDGraphNode parent = RD_NVAL;
+        REQUIRE(ga->loopParent(n[2], &parent));
+        REQUIRE(parent == n[1]);
+        REQUIRE_FALSE(ga->loopParent(n[1], &parent));
+    }
+
+    SUBCASE("Strongly Connected Components")
+    {
+        REQUIRE(ga->componentsCount() == 4);
+        REQUIRE(ga->components(nullptr) == std::size(n));
+
+        size_t loop = ga->component(n[1]);
+        for(size_t i : { 2, 3, 4, 6 }) REQUIRE(ga->component(n[i]) == loop);
+
+        // Reverse topological order: successors get lower numbers
+        REQUIRE(ga->component(n[5]) < loop);
+        REQUIRE(loop < ga->component(n[0]));
+        REQUIRE(ga->component(n[7]) != ga->component(n[0]));
+    }
+
+    SUBCASE("Invalidation")
+    {
+        g.removeEdge(g.edge(n[4], n[1]));
+        ga = g.analysis();
+
+        const RDGraphNode* headers = nullptr;
+        REQUIRE(ga->loops(&headers) == 1);
+        REQUIRE(headers[0] == n[2]);
+        REQUIRE(ga->loopDepth(n[4]) == 0);
+        REQUIRE(ga->componentsCount() == 7);
+    }
+}
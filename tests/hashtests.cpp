@@ -0,0 +1,158 @@
+#include <cstring>
+#include <string>
+#include <vector>
+#include "../rdcore/support/hash.h"
+#include "../rdcore/buffer/rollinghash.h"
+#include "../rdcore/libs/miniz/miniz.h"
+#include "testrandom.h"
+#include "doctest.h"
+
+static const u8* bytes(const char* s) { return reinterpret_cast<const u8*>(s); }
+
+static std::vector<u8> makeData(size_t size)
+{
+    std::vector<u8> data(size);
+    TestRandom random(0x12345678);
+    for(u8& b : data) b = static_cast<u8>(random.next());
+    return data;
+}
+
+static std::string toHex(const Hash::SHA256Digest& digest)
+{
+    static const char* DIGITS = "0123456789abcdef";
+    std::string s;
+
+    for(u8 b : digest)
+    {
+        s.push_back(DIGITS[b >> 4]);
+        s.push_back(DIGITS[b & 0xF]);
+    }
+
+    return s;
+}
+
+static u32 crc32cBytewise(const u8* data, size_t size)
+{
+    u32 crc = ~0u;
+
+    while(size--)
+    {
+        crc ^= *data++;
+        for(int i = 0; i < 8; i++) crc = (crc & 1) ? (crc >> 1) ^ 0x82F63B78 : (crc >> 1);
+    }
+
+    return ~crc;
+}
+
+static u64 rollingHash(size_t window, u8* data, size_t size)
+{
+    RollingHash rh(window);
+    RDBufferView view{ data, size };
+    return rh.update(&view);
+}
+
+TEST_CASE("Checksums")
+{
+    const char* CHECK = "123456789";
+
+    SUBCASE("Known answers")
+    {
+        REQUIRE(Hash::crc32(bytes(CHECK), std::strlen(CHECK)) == 0xCBF43926);
+        REQUIRE(Hash::crc32c(bytes(CHECK), std::strlen(CHECK)) == 0xE3069283);
+        REQUIRE(Hash::crc16(bytes(CHECK), std::strlen(CHECK)) == 0x29B1); // CCITT (0xFFFF, 0x1021)
+        REQUIRE(Hash::adler32(bytes("Wikipedia"), 9) == 0x11E60398);
+
+        REQUIRE(toHex(Hash::sha256(nullptr, 0)) == "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+        REQUIRE(toHex(Hash::sha256(bytes("abc"), 3)) == "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+
+        const char* TWOBLOCKS = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq"; // 56 bytes: padding spills into a second block
+        REQUIRE(toHex(Hash::sha256(bytes(TWOBLOCKS), std::strlen(TWOBLOCKS))) == "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+
+        std::vector<u8> million(1000000, 'a');
+        REQUIRE(toHex(Hash::sha256(million.data(), million.size())) == "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+
+        REQUIRE(Hash::crc32(nullptr, 0) == 0);
+        REQUIRE(Hash::crc32c(nullptr, 0) == 0);
+    }
+
+    SUBCASE("Ranges")
+    {
+        REQUIRE(Hash::crc32(bytes("xx123456789"), 11, 2, 9) == 0xCBF43926);
+        REQUIRE(Hash::crc32c(bytes(CHECK), 9, 0, RD_NVAL) == 0xE3069283);
+        REQUIRE(Hash::crc16(bytes(CHECK), 9, 4, 6) == 0); // Out of bounds
+    }
+
+    SUBCASE("Unaligned sizes")
+    {
+        auto data = makeData(1031);
+
+        // Slicing-by-8 (and SSE4.2 for CRC32C) must agree with the bytewise forms on every tail length
+        for(size_t off = 0; off < 8; off++)
+        {
+            for(size_t size : { 0, 1, 7, 8, 9, 63, 64, 65, 1000 })
+            {
+                const u8* p = data.data() + off;
+                REQUIRE(Hash::crc32(p, size) == static_cast<u32>(mz_crc32(MZ_CRC32_INIT, p, size)));
+                REQUIRE(Hash::crc32c(p, size) == crc32cBytewise(p, size));
+            }
+        }
+    }
+}
+
+TEST_CASE("RollingHash")
+{
+    const size_t WINDOW = 16;
+    auto data = makeData(4096);
+
+    SUBCASE("Window only")
+    {
+        // After the window is full, the hash only depends on the last 'WINDOW' bytes
+        for(size_t end : { WINDOW, WINDOW + 1, size_t(100), size_t(4096) })
+            REQUIRE(rollingHash(WINDOW, data.data(), end) == rollingHash(WINDOW, data.data() + end - WINDOW, WINDOW));
+
+        auto other = data;
+        other[0] ^= 0xFF; // Outside the last window
+        REQUIRE(rollingHash(WINDOW, data.data(), 100) == rollingHash(WINDOW, other.data(), 100));
+        REQUIRE(rollingHash(WINDOW, data.data(), 10) != rollingHash(WINDOW, other.data(), 10));
+    }
+
+    SUBCASE("Split updates")
+    {
+        RollingHash rh(WINDOW);
+        RDBufferView head{ data.data(), 1000 }, tail{ data.data() + 1000, data.size() - 1000 };
+        rh.update(&head);
+        REQUIRE(rh.update(&tail) == rollingHash(WINDOW, data.data(), data.size()));
+
+        rh.reset();
+        REQUIRE(rh.hash() == 0);
+        REQUIRE(rh.update(&head) == rollingHash(WINDOW, data.data(), 1000));
+    }
+
+    SUBCASE("Chunks")
+    {
+        const u64 MASK = 0x3F;
+        RollingHash rh(WINDOW);
+        RDBufferView view{ data.data(), data.size() };
+
+        const rd_offset* boundaries = nullptr;
+        size_t c = rh.chunk(&view, MASK, &boundaries);
+        REQUIRE(c > 0);
+
+        for(size_t i = 0; i < c; i++)
+        {
+            REQUIRE(boundaries[i] >= WINDOW);
+            REQUIRE(!(rollingHash(WINDOW, data.data() + boundaries[i] - WINDOW, WINDOW) & MASK));
+        }
+
+        // Boundaries are content defined: a prefix edit doesn't move the ones after it
+        auto other = data;
+        other[0] ^= 0xFF;
+        RollingHash rh2(WINDOW);
+        RDBufferView otherview{ other.data(), other.size() };
+        const rd_offset* otherboundaries = nullptr;
+        size_t oc = rh2.chunk(&otherview, MASK, &otherboundaries);
+
+        REQUIRE(oc > 0);
+        REQUIRE(otherboundaries[oc - 1] == boundaries[c - 1]);
+    }
+}
@@ -0,0 +1,87 @@
+#include <map>
+#include <vector>
+#include "../rdcore/rdil/ilfunction.h"
+#include "testrandom.h"
+#include "doctest.h"
+
+typedef std::pair<size_t, size_t> Range; // [Index, Count]
+
+static std::map<rd_address, Range> rebuildRanges(const ILFunction& il)
+{
+    std::map<rd_address, Range> ranges; // First run of each address, like a fresh lift
+    size_t idx = 0;
+
+    for(auto it = il.begin(); it != il.end(); it++, idx++)
+    {
+        rd_address address = RD_NVAL;
+        REQUIRE(il.getAddress(*it, &address));
+
+        auto rit = ranges.find(address);
+        if(rit == ranges.end()) ranges[address] = { idx, 1 };
+        else if((rit->second.first + rit->second.second) == idx) rit->second.second++;
+    }
+
+    return ranges;
+}
+
+static void checkRanges(const ILFunction& il)
+{
+    for(const auto& [address, r] : rebuildRanges(il))
+    {
+        size_t index = RD_NVAL, count = 0;
+        REQUIRE(il.range(address, &index, &count));
+        REQUIRE(index == r.first);
+        REQUIRE(count == r.second);
+        REQUIRE(il.expressionAt(address) == il.expression(r.first));
+    }
+}
+
+static void emit(ILFunction& il, rd_address address, size_t idx)
+{
+    il.setCurrentAddress(address);
+    if(idx == RD_NVAL) il.append(il.exprNOP());
+    else il.insert(idx, il.exprNOP());
+}
+
+TEST_CASE("ILFunction ranges")
+{
+    ILFunction il(nullptr);
+
+    for(rd_address address : { 0x1000, 0x1000, 0x1004, 0x1008, 0x1008 }) emit(il, address, RD_NVAL);
+    checkRanges(il);
+
+    SUBCASE("Insert inside a run")
+    {
+        emit(il, 0x1008, 3); // Joins its own run
+        emit(il, 0x1000, 1);
+        checkRanges(il);
+
+        size_t index = 0, count = 0;
+        REQUIRE(il.range(0x1000, &index, &count));
+        REQUIRE((index == 0 && count == 3));
+        REQUIRE(il.range(0x1008, &index, &count));
+        REQUIRE((index == 4 && count == 3));
+    }
+
+    SUBCASE("Split and prepend")
+    {
+        emit(il, 0x1004, 1); // Splits 0x1000: its tail is not the first run anymore
+        emit(il, 0x100C, 0); // New address in front of everything
+        emit(il, 0x1008, 0); // New first run, away from the old one
+        emit(il, 0x1008, 1); // Adjacent to the new first run
+        emit(il, 0x100C, RD_NVAL);
+        checkRanges(il);
+    }
+
+    SUBCASE("Interleaved")
+    {
+        TestRandom random(0x9E3779B9);
+
+        for(size_t i = 0; i < 500; i++)
+        {
+            rd_address address = 0x1000 + ((random.next() % 16) * 4);
+            emit(il, address, (random.next() % 3) ? (random.next() % (il.size() + 1)) : RD_NVAL);
+            checkRanges(il);
+        }
+    }
+}
@@ -0,0 +1,92 @@
+#include <string>
+#include <vector>
+#include "../rdcore/containers/lrucontainer.h"
+#include "doctest.h"
+
+TEST_CASE("LRUContainer")
+{
+    std::vector<std::pair<int, std::string>> evicted;
+    LRUContainer<int, std::string> lru(3, [&](const int& k, std::string& v) { evicted.emplace_back(k, v); });
+
+    lru.insert(1, "one");
+    lru.insert(2, "two");
+    lru.insert(3, "three");
+    REQUIRE(lru.size() == 3);
+    REQUIRE(evicted.empty());
+
+    SUBCASE("Eviction order")
+    {
+        lru.insert(4, "four");
+        lru.insert(5, "five");
+
+        REQUIRE(lru.size() == lru.capacity());
+        REQUIRE(evicted == std::vector<std::pair<int, std::string>>{ { 1, "one" }, { 2, "two" } });
+        REQUIRE_FALSE(lru.find(1));
+        REQUIRE_FALSE(lru.find(2));
+        REQUIRE(*lru.find(3) == "three");
+        REQUIRE(*lru.find(5) == "five");
+    }
+
+    SUBCASE("Find refreshes recency")
+    {
+        REQUIRE(*lru.find(1) == "one");
+        lru.insert(4, "four"); // 2 is now the oldest
+
+        REQUIRE(lru.find(1));
+        REQUIRE_FALSE(lru.find(2));
+        REQUIRE(lru.find(3));
+    }
+
+    SUBCASE("Overwrite")
+    {
+        REQUIRE(*lru.insert(1, "uno") == "uno"); // Existing key: updated and refreshed, nothing evicted
+        REQUIRE(lru.size() == 3);
+        REQUIRE(evicted.empty());
+
+        lru.insert(4, "four");
+        REQUIRE_FALSE(lru.find(2));
+        REQUIRE(*lru.find(1) == "uno");
+    }
+
+    SUBCASE("Remove and clear")
+    {
+        REQUIRE(lru.remove(2));
+        REQUIRE_FALSE(lru.remove(2));
+        REQUIRE(lru.size() == 2);
+
+        lru.insert(4, "four"); // Fits in the freed slot
+        REQUIRE(lru.size() == 3);
+        REQUIRE(lru.find(1));
+
+        lru.clear(); // Not an eviction
+        REQUIRE(evicted.empty());
+        REQUIRE(lru.empty());
+        REQUIRE_FALSE(lru.find(1));
+
+        lru.insert(5, "five");
+        REQUIRE(*lru.find(5) == "five");
+    }
+
+    SUBCASE("Remove if")
+    {
+        REQUIRE(lru.removeIf([](const int& k, const std::string&) { return k >= 2; }) == 2);
+        REQUIRE(lru.size() == 1);
+        REQUIRE(evicted.empty());
+        REQUIRE(lru.find(1));
+        REQUIRE_FALSE(lru.find(2));
+        REQUIRE_FALSE(lru.find(3));
+
+        lru.insert(4, "four");
+        lru.insert(5, "five");
+        REQUIRE(evicted.empty()); // Room was made by removeIf()
+    }
+
+    SUBCASE("Evict all")
+    {
+        lru.find(1);
+        lru.evictAll();
+
+        REQUIRE(lru.empty());
+        REQUIRE(evicted == std::vector<std::pair<int, std::string>>{ { 2, "two" }, { 3, "three" }, { 1, "one" } });
+    }
+}
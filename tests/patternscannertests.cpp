@@ -0,0 +1,61 @@
+#include <string>
+#include <vector>
+#include "../rdcore/buffer/patternscanner.h"
+#include "testrandom.h"
+#include "doctest.h"
+
+static std::vector<RDPatternMatch> scan(PatternScanner& ps, const std::vector<u8>& data)
+{
+    RDBufferView view{ const_cast<u8*>(data.data()), data.size() };
+    const RDPatternMatch* matches = nullptr;
+    size_t c = ps.scan(&view, &matches);
+    return std::vector<RDPatternMatch>(matches, matches + c);
+}
+
+TEST_CASE("PatternScanner")
+{
+    // Matches of the automaton must be the same as a plain search of each pattern
+    TestRandom random(0x41C64E6D);
+    std::vector<u8> data(0x4000);
+    for(u8& b : data) b = static_cast<u8>(random.next() % 4); // Small alphabet, lots of partial matches
+
+    PatternScanner ps;
+    std::vector<CompiledPattern> patterns;
+
+    for(size_t i = 0; i < 300; i++)
+    {
+        std::string pattern;
+        size_t n = 2 + (random.next() % 12);
+
+        for(size_t j = 0; j < n; j++)
+        {
+            if(j && !(random.next() % 5)) pattern += "??";
+            else pattern += "0" + std::to_string(random.next() % 4);
+        }
+
+        CompiledPattern cp;
+        if(!PatternScanner::compile(pattern, &cp)) continue;
+
+        REQUIRE(ps.addPattern(pattern) == patterns.size());
+        patterns.push_back(cp);
+    }
+
+    std::vector<RDPatternMatch> expected;
+
+    for(size_t offset = 0; offset < data.size(); offset++)
+    {
+        for(size_t idx = 0; idx < patterns.size(); idx++)
+        {
+            if(patterns[idx].match(data.data() + offset, data.size() - offset)) expected.push_back({offset, idx});
+        }
+    }
+
+    auto matches = scan(ps, data);
+    REQUIRE(matches.size() == expected.size());
+
+    for(size_t i = 0; i < matches.size(); i++)
+    {
+        REQUIRE(matches[i].offset == expected[i].offset);
+        REQUIRE(matches[i].pattern == expected[i].pattern);
+    }
+}
@@ -0,0 +1,80 @@
+#include <cstring>
+#include <vector>
+#include <rdapi/buffer.h>
+#include "../rdcore/database/signaturedatabase.h"
+#include "doctest.h"
+
+struct TestInstruction { size_t offset, size; rd_address target; u32 value; }; // 'value' is an absolute or relative operand at the end
+
+// x86 like code: addresses and relative calls change with the base, everything else doesn't
+static const std::vector<TestInstruction> FUNCTION = {
+    {  0, 1, RD_NVAL, 0 },       // push ebp
+    {  1, 2, RD_NVAL, 0 },       // mov ebp, esp
+    {  3, 5, 0x40, 0 },          // mov eax, [data]
+    {  8, 5, 0x100, 1 },         // call rel32
+    { 13, 5, RD_NVAL, 0 },       // add eax, imm32
+    { 18, 6, 0x44, 0 },          // mov ecx, [data]
+    { 24, 8, RD_NVAL, 0 },       // nops
+    { 32, 5, 0x200, 1 },         // call rel32, covered by the CRC
+    { 37, 5, 0x48, 0 },          // mov [data], eax
+    { 42, 2, RD_NVAL, 0 },       // pop ebp, ret
+};
+
+static const u8 FUNCTION_BYTES[] = {
+    0x55, 0x89, 0xE5, 0xA1, 0, 0, 0, 0, 0xE8, 0, 0, 0, 0, 0x05, 0x11, 0x22, 0x33, 0x44, 0x8B, 0x0D, 0, 0, 0, 0,
+    0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0x90, 0xE8, 0, 0, 0, 0, 0xA3, 0, 0, 0, 0, 0x5D, 0xC3
+};
+
+static void link(rd_address base, std::vector<u8>& data, std::vector<u8>& mask)
+{
+    data.assign(std::begin(FUNCTION_BYTES), std::end(FUNCTION_BYTES));
+    mask.assign(data.size(), 0xFF);
+
+    for(const TestInstruction& ti : FUNCTION)
+    {
+        if(ti.target == RD_NVAL) continue;
+
+        rd_address target = base + ti.target, nextaddress = base + ti.offset + ti.size;
+        u32 v = static_cast<u32>(ti.value ? (target - nextaddress) : target);
+        std::memcpy(data.data() + ti.offset + ti.size - sizeof(u32), &v, sizeof(u32)); // Little endian host
+    }
+
+    for(const TestInstruction& ti : FUNCTION) // Same as SignatureAnalyzer, with the targets the assembler would report
+    {
+        if(ti.target == RD_NVAL) continue;
+        REQUIRE(SignatureDatabase::maskAddress(data.data() + ti.offset, mask.data() + ti.offset, ti.size, base + ti.target, base + ti.offset + ti.size, sizeof(u32)));
+    }
+}
+
+TEST_CASE("SignatureDatabase relocations")
+{
+    std::vector<u8> data1, mask1, data2, mask2;
+    link(0x401000, data1, mask1);
+    link(0x10020000, data2, mask2);
+
+    REQUIRE(data1 != data2);
+    REQUIRE(mask1 == mask2);
+
+    SignatureDatabase db;
+    REQUIRE(db.add(data1.data(), mask1.data(), data1.size(), "function"));
+
+    RDBufferView view{ data2.data(), data2.size() };
+    const char* name = db.match(&view, mask2.data(), data2.size());
+    REQUIRE(name);
+    CHECK(!std::strcmp(name, "function"));
+
+    SUBCASE("Unmasked")
+    {
+        CHECK(!db.match(&view, nullptr, data2.size())); // Addresses differ
+    }
+
+    SUBCASE("Fixed bytes")
+    {
+        data2[14] ^= 0xFF; // Immediate in the prefix
+        CHECK(!db.match(&view, mask2.data(), data2.size()));
+
+        data2[14] ^= 0xFF;
+        data2[30] ^= 0xFF; // Nop in the CRC
+        CHECK(!db.match(&view, mask2.data(), data2.size()));
+    }
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "../rdapi/types.h"
+
+class TestRandom // Xorshift32, deterministic between runs
+{
+    public:
+        TestRandom(u32 seed): m_state(seed) { }
+
+        u32 next() {
+            m_state ^= m_state << 13;
+            m_state ^= m_state >> 17;
+            m_state ^= m_state << 5;
+            return m_state;
+        }
+
+    private:
+        u32 m_state;
+};